@@ -0,0 +1,118 @@
+#include<hitOrMiss/binary_image.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const uchar kBlack = 0;
+const uchar kWhite = 255;
+
+// Коэффициенты cv::COLOR_BGR2GRAY в фиксированной точке (14 бит)
+const int kGrayShift = 14;
+const int kBlueWeight = 1868;
+const int kGreenWeight = 9617;
+const int kRedWeight = 4899;
+
+// Целочисленный порог, эквивалентный вещественному: value > threshold <=> value > level
+int IntegerLevel(double threshold, int max_value) {
+    return static_cast<int>(std::clamp(std::floor(threshold), -1.0, static_cast<double>(max_value)));
+}
+
+template<class Value, class Level>
+void ThresholdRow(const Value* src, uchar* dst, int cols, Level level) {
+    for (int col = 0; col < cols; col += 1) {
+        dst[col] = src[col] > level ? kWhite : kBlack;
+    }
+}
+
+void ThresholdBgrRow(const uchar* src, uchar* dst, int cols, int level) {
+    for (int col = 0; col < cols; col += 1) {
+        const uchar* pixel = src + 3 * col;
+        const int gray = (pixel[0] * kBlueWeight + pixel[1] * kGreenWeight + pixel[2] * kRedWeight
+            + (1 << (kGrayShift - 1))) >> kGrayShift;
+        dst[col] = gray > level ? kWhite : kBlack;
+    }
+}
+
+}
+
+BinaryImage::BinaryImage(const cv::Mat& src) {
+    Assign(src);
+}
+
+BinaryImage::BinaryImage(const cv::Mat& src, double threshold) {
+    Assign(src, threshold);
+}
+
+BinaryImage BinaryImage::FromBinary(const cv::Mat& binary) {
+#ifndef NDEBUG
+    CV_Assert(IsBinary(binary));
+#endif
+    BinaryImage image;
+    image.image_ = binary;
+    image.owned_ = false;
+    return image;
+}
+
+void BinaryImage::Assign(const cv::Mat& src) {
+    Assign(src, DefaultThreshold(src.depth()));
+}
+
+void BinaryImage::Assign(const cv::Mat& src, double threshold) {
+    const int type = src.type();
+    CV_Assert(type == CV_8UC1 || type == CV_8UC3 || type == CV_16UC1 || type == CV_32FC1);
+
+    // чужую память (FromBinary) и память самого src не перезаписываем
+    if (!owned_ || image_.data == src.data) {
+        image_ = cv::Mat();
+        owned_ = true;
+    }
+    image_.create(src.rows, src.cols, CV_8UC1);
+
+    // преобразование и бинаризация за один проход по строке
+    const int level = IntegerLevel(threshold, type == CV_16UC1 ? 65535 : 255);
+    for (int row = 0; row < src.rows; row += 1) {
+        uchar* dst = image_.ptr<uchar>(row);
+        switch (type) {
+        case CV_8UC1:
+            ThresholdRow(src.ptr<uchar>(row), dst, src.cols, level);
+            break;
+        case CV_8UC3:
+            ThresholdBgrRow(src.ptr<uchar>(row), dst, src.cols, level);
+            break;
+        case CV_16UC1:
+            ThresholdRow(src.ptr<ushort>(row), dst, src.cols, level);
+            break;
+        default:
+            ThresholdRow(src.ptr<float>(row), dst, src.cols, static_cast<float>(threshold));
+            break;
+        }
+    }
+}
+
+double BinaryImage::DefaultThreshold(int depth) {
+    switch (depth) {
+    case CV_16U:
+        return 32767;
+    case CV_32F:
+        return 0.5;
+    default:
+        return 127;
+    }
+}
+
+bool BinaryImage::IsBinary(const cv::Mat& image) {
+    if (image.type() != CV_8UC1) {
+        return false;
+    }
+    for (int row = 0; row < image.rows; row += 1) {
+        const uchar* pixels = image.ptr<uchar>(row);
+        for (int col = 0; col < image.cols; col += 1) {
+            if (pixels[col] != kBlack && pixels[col] != kWhite) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
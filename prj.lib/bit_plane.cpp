@@ -0,0 +1,268 @@
+#include<hitOrMiss/bit_plane.hpp>
+#include<hitOrMiss/separable_erosion.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+
+const int kWhite = 255; // код белого пикселя
+const int kBlack = 0; // код черного пикселя
+const int kWordBits = 64; // количество пикселей в слове
+
+// Таблица распаковки: байт упакованной строки -> 8 пикселей CV_8UC1
+const std::array<uint64_t, 256>& UnpackTable() {
+    static const std::array<uint64_t, 256> table = [] {
+        std::array<uint64_t, 256> result{};
+        for (int byte = 0; byte < 256; byte += 1) {
+            uint64_t pixels = 0;
+            for (int bit = 0; bit < 8; bit += 1) {
+                const uint64_t pixel = (byte >> bit) & 1 ? kBlack : kWhite;
+                pixels |= pixel << (8 * bit);
+            }
+            result[byte] = pixels;
+        }
+        return result;
+    }();
+    return table;
+}
+
+const uint64_t kByteOnes = 0x0101010101010101; // единица в каждом байте
+const uint64_t kByteHighs = 0x8080808080808080; // старший бит каждого байта
+
+// Старшие биты байтов group, не превосходящих соответствующих байтов thresholds (без переносов между байтами)
+uint64_t LessOrEqual(uint64_t group, uint64_t thresholds) {
+    // младшие 7 бит: старший бит разности установлен, если младшие биты group не больше
+    const uint64_t low = ((thresholds | kByteHighs) - (group & ~kByteHighs)) & kByteHighs;
+    // старший бит group меньше или старшие биты равны и младшие не больше
+    return ((~group & thresholds) | (~(group ^ thresholds) & low)) & kByteHighs;
+}
+
+// Старшие биты 8 байтов в 8 младших битах (байт 0 - бит 0)
+uint64_t GatherHighBits(uint64_t highs) {
+    return ((highs >> 7) * 0x0102040810204080) >> 56;
+}
+
+// dst |= src, сдвинутая вправо по изображению на shift пикселей (в сторону старших битов)
+void OrShifted(uint64_t* dst, const uint64_t* src, int words, int shift) {
+    const int word_shift = shift / kWordBits;
+    const int bit_shift = shift % kWordBits;
+    for (int word = words - 1; word >= word_shift; word -= 1) {
+        uint64_t value = src[word - word_shift] << bit_shift;
+        if (bit_shift != 0 && word - word_shift - 1 >= 0) {
+            value |= src[word - word_shift - 1] >> (kWordBits - bit_shift);
+        }
+        dst[word] |= value;
+    }
+}
+
+}
+
+BitPlane::BitPlane(int rows, int cols) {
+    Create(rows, cols);
+}
+
+void BitPlane::Create(int rows, int cols) {
+    rows_ = rows;
+    cols_ = cols;
+    words_per_row_ = (cols + kWordBits - 1) / kWordBits;
+    stride_ = words_per_row_ + 1;
+    words_.assign(static_cast<size_t>(rows_) * stride_, 0);
+}
+
+uint64_t BitPlane::TailMask() const {
+    const int tail = cols_ % kWordBits;
+    return tail == 0 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << tail) - 1;
+}
+
+BitPlane BitPlane::Pack(const cv::Mat& src) {
+    BitPlane dst;
+    Pack(src, dst);
+    return dst;
+}
+
+void BitPlane::Pack(const cv::Mat& src, BitPlane& dst) {
+    CV_Assert(src.type() == CV_8UC1);
+
+    dst.Create(src.rows, src.cols);
+    for (int row = 0; row < src.rows; row += 1) {
+        dst.PackRow(row, src.ptr<uchar>(row));
+    }
+}
+
+void BitPlane::PackRow(int row, const uchar* pixels) {
+    PackRow(row, pixels, cols_, kBlack);
+}
+
+void BitPlane::PackRow(int row, const uchar* pixels, int count, int threshold) {
+    PackWords(row, pixels, count, threshold, 0, words_per_row_);
+}
+
+void BitPlane::PackRegion(const cv::Mat& src, const cv::Rect& region) {
+    CV_Assert(src.type() == CV_8UC1 && src.rows == rows_ && src.cols == cols_);
+
+    const int word_begin = region.x / kWordBits;
+    const int word_end = (region.x + region.width + kWordBits - 1) / kWordBits;
+    for (int row = region.y; row < region.y + region.height; row += 1) {
+        PackWords(row, src.ptr<uchar>(row), cols_, kBlack, word_begin, word_end);
+    }
+}
+
+void BitPlane::PackWords(int row, const uchar* pixels, int count, int threshold, int word_begin, int word_end) {
+    const uint64_t thresholds = kByteOnes * static_cast<uint64_t>(threshold);
+    uint64_t* words = Row(row);
+    for (int word = word_begin; word < word_end; word += 1) {
+        const int begin = word * kWordBits;
+        const int bits_count = std::max(0, std::min(kWordBits, count - begin));
+        uint64_t bits = 0;
+        int bit = 0;
+        // по 8 пикселей за раз: сравнение байтов в одном слове и сбор старших битов в байт
+        for (; bit + 8 <= bits_count; bit += 8) {
+            uint64_t group = 0;
+            std::memcpy(&group, pixels + begin + bit, 8);
+            bits |= GatherHighBits(LessOrEqual(group, thresholds)) << bit;
+        }
+        for (; bit < bits_count; bit += 1) {
+            bits |= static_cast<uint64_t>(pixels[begin + bit] <= threshold) << bit;
+        }
+        words[word] = bits;
+    }
+}
+
+void BitPlane::Unpack(cv::Mat& dst) const {
+    dst.create(rows_, cols_, CV_8UC1);
+    for (int row = 0; row < rows_; row += 1) {
+        UnpackRow(row, dst.ptr<uchar>(row));
+    }
+}
+
+void BitPlane::UnpackRow(int row, uchar* pixels) const {
+    const std::array<uint64_t, 256>& table = UnpackTable();
+    const int full_bytes = cols_ / 8;
+    const uint64_t* words = Row(row);
+    // целые байты строки распаковываются по таблице, по 8 пикселей за раз
+    for (int byte = 0; byte < full_bytes; byte += 1) {
+        const uint64_t packed = (words[byte / 8] >> (8 * (byte % 8))) & 0xFF;
+        std::memcpy(pixels + 8 * byte, &table[packed], 8);
+    }
+    for (int col = 8 * full_bytes; col < cols_; col += 1) {
+        pixels[col] = (words[col / kWordBits] >> (col % kWordBits)) & 1 ? kBlack : kWhite;
+    }
+}
+
+void BitPlane::And(const BitPlane& rhs) {
+    CV_Assert(rows_ == rhs.rows_ && cols_ == rhs.cols_);
+    for (size_t word = 0; word < words_.size(); word += 1) {
+        words_[word] &= rhs.words_[word];
+    }
+}
+
+void BitPlane::AndNot(const BitPlane& rhs) {
+    CV_Assert(rows_ == rhs.rows_ && cols_ == rhs.cols_);
+    for (size_t word = 0; word < words_.size(); word += 1) {
+        words_[word] &= ~rhs.words_[word];
+    }
+}
+
+void BitPlane::Match(const BitPlane& image, const StructuringElement& element, BitPlane& hits) {
+    hits.Create(image.rows_, image.cols_);
+    Match(image, element, cv::Point(0, 0), 0, image.rows_, hits);
+}
+
+void BitPlane::Match(const BitPlane& image, const StructuringElement& element, const cv::Point& offset,
+    int row_begin, int row_end, BitPlane& dst) {
+    Match(image, element, offset, cv::Rect(0, row_begin, image.cols_, row_end - row_begin), dst);
+}
+
+void BitPlane::Match(const BitPlane& image, const StructuringElement& element, const cv::Point& offset,
+    const cv::Rect& windows, BitPlane& dst) {
+    const cv::Size& window = element.get_size();
+    const int row_begin = windows.y;
+    const int last_row = std::min(image.rows_ - window.height, windows.y + windows.height - 1);
+    const int image_last_col = image.cols_ - window.width;
+    const int last_col = std::min(image_last_col, windows.x + windows.width - 1);
+    if (window.empty() || last_row < row_begin || last_col < windows.x) {
+        return;
+    }
+
+    // сплошной прямоугольник проходится за время, не зависящее от его размера (всегда по всей ширине)
+    if (SeparableErosion::Supports(element)) {
+        SeparableErosion::Match(image, element, offset, row_begin, last_row + 1, dst);
+        return;
+    }
+
+    const std::vector<CarePixel>& care = element.get_care();
+    const int first_word = windows.x / kWordBits;
+    const int last_word = last_col / kWordBits;
+    // окна за последним столбцом изображения не проверяются, это касается только его последнего слова
+    const int tail = image_last_col % kWordBits + 1;
+    const uint64_t last_mask = tail == kWordBits || last_word != image_last_col / kWordBits
+        ? ~uint64_t{ 0 } : (uint64_t{ 1 } << tail) - 1;
+
+    // при смещении по столбцам слово попаданий сдвигается и добавляется в два соседних слова результата:
+    // попадания не выходят за последний столбец, поэтому старшая часть попадает не дальше защитного слова
+    const int word_shift = offset.x / kWordBits;
+    const int bit_shift = offset.x % kWordBits;
+
+    for (int mask_row = row_begin; mask_row <= last_row; mask_row += 1) {
+        uint64_t* hits = dst.Row(mask_row + offset.y);
+        for (int word = first_word; word <= last_word; word += 1) {
+            // 64 положения окна проверяются одновременно
+            uint64_t hit = ~uint64_t{ 0 };
+            for (const StructuringElement::CareRow& care_row : element.get_rows()) {
+                const uint64_t* image_row = image.Row(mask_row + care_row.row);
+                for (int index = care_row.begin; index < care_row.end && hit != 0; index += 1) {
+                    // для белых значимых пикселей слово изображения инвертируется
+                    const uint64_t invert = care[index].black ? 0 : ~uint64_t{ 0 };
+                    hit &= Extract(image_row, word * kWordBits + care[index].col) ^ invert;
+                }
+                if (hit == 0) break;
+            }
+            if (word == last_word) {
+                hit &= last_mask;
+            }
+            if (offset.x == 0) {
+                hits[word] = hit;
+                continue;
+            }
+            hits[word + word_shift] |= hit << bit_shift;
+            if (bit_shift != 0) {
+                hits[word + word_shift + 1] |= hit >> (kWordBits - bit_shift);
+            }
+        }
+    }
+}
+
+void BitPlane::Fill(int row, int col_begin, int col_end) {
+    uint64_t* words = Row(row);
+    for (int col = col_begin; col < col_end;) {
+        const int bit = col % kWordBits;
+        const int count = std::min(kWordBits - bit, col_end - col);
+        const uint64_t mask = count == kWordBits ? ~uint64_t{ 0 } : ((uint64_t{ 1 } << count) - 1) << bit;
+        words[col / kWordBits] |= mask;
+        col += count;
+    }
+}
+
+void BitPlane::Stamp(const BitPlane& hits, const std::vector<cv::Point>& offsets, BitPlane& dst) {
+    dst.Create(hits.rows_, hits.cols_);
+    Stamp(hits, offsets, 0, hits.rows_, dst);
+}
+
+void BitPlane::Stamp(const BitPlane& hits, const std::vector<cv::Point>& offsets,
+    int row_begin, int row_end, BitPlane& dst) {
+    const uint64_t tail_mask = dst.TailMask();
+    for (int row = row_begin; row < row_end; row += 1) {
+        uint64_t* words = dst.Row(row);
+        for (const cv::Point& offset : offsets) {
+            if (row - offset.y >= 0 && row - offset.y < hits.rows_) {
+                OrShifted(words, hits.Row(row - offset.y), dst.words_per_row_, offset.x);
+            }
+        }
+        // сдвиг не должен оставлять черные пиксели за последним столбцом
+        if (dst.words_per_row_ > 0) {
+            words[dst.words_per_row_ - 1] &= tail_mask;
+        }
+    }
+}
@@ -0,0 +1,198 @@
+#include<hitOrMiss/engine_tuner.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Движки, которые могут быть записаны в профиле
+const HitOrMiss::Engine kEngines[] = { HitOrMiss::Engine::kBytewise, HitOrMiss::Engine::kBitPlane,
+    HitOrMiss::Engine::kRunLength, HitOrMiss::Engine::kOpenCv };
+
+// Структурный элемент в сигнатуре: размер и по символу на пиксель (1 - черный)
+void AppendKernel(std::ostringstream& signature, const cv::Mat& kernel) {
+    signature << ':' << kernel.rows << 'x' << kernel.cols << ':';
+    for (int row = 0; row < kernel.rows; row += 1) {
+        const uchar* pixels = kernel.ptr<uchar>(row);
+        for (int col = 0; col < kernel.cols; col += 1) {
+            signature << (pixels[col] == 0 ? '1' : '0');
+        }
+    }
+}
+
+bool Equal(const cv::Mat& lhs, const cv::Mat& rhs) {
+    if (lhs.size() != rhs.size() || lhs.type() != rhs.type()) {
+        return false;
+    }
+    for (int row = 0; row < lhs.rows; row += 1) {
+        if (std::memcmp(lhs.ptr<uchar>(row), rhs.ptr<uchar>(row), lhs.cols) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+EngineTuner::EngineTuner(const std::string& profile_path) {
+    set_profile_path(profile_path);
+}
+
+std::shared_ptr<EngineTuner> EngineTuner::Shared() {
+    static const std::shared_ptr<EngineTuner> tuner = std::make_shared<EngineTuner>();
+    return tuner;
+}
+
+HitOrMiss::Engine EngineTuner::Select(const HitOrMiss& hit_or_miss) {
+
+    const std::string signature = Signature(hit_or_miss);
+    bool verify = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto found = profile_.find(signature);
+        if (found != profile_.end()) {
+            return found->second;
+        }
+        verify = verify_;
+    }
+
+    // замер без блокировки: одну сигнатуру могут замерить два потока, победит последний
+    using Clock = std::chrono::steady_clock;
+    HitOrMiss probe(hit_or_miss);
+    // замеры копии не попадают в статистику исходного объекта
+    probe.set_stats(nullptr);
+    const BinaryImage image = BinaryImage::FromBinary(hit_or_miss.get_image());
+    HitOrMiss::Engine best = HitOrMiss::Engine::kBitPlane;
+    double best_seconds = std::numeric_limits<double>::infinity();
+    HitOrMiss::Engine expected_engine = best;
+    cv::Mat expected;
+    cv::Mat dst;
+    for (HitOrMiss::Engine candidate : Candidates(hit_or_miss)) {
+        probe.set_engine(candidate);
+        double seconds = std::numeric_limits<double>::infinity();
+        for (int run = 0; run < 2 && seconds <= kGiveUpRatio * best_seconds; run += 1) {
+            const Clock::time_point begin = Clock::now();
+            probe.set_image(image);
+            probe.DoHitOrMiss(dst);
+            seconds = std::min(seconds, std::chrono::duration<double>(Clock::now() - begin).count());
+        }
+
+        if (verify && expected.empty()) {
+            expected = dst.clone();
+            expected_engine = candidate;
+        }
+        else if (verify && !Equal(expected, dst)) {
+            throw std::logic_error(std::string("Engines ") + EngineName(expected_engine) + " and "
+                + EngineName(candidate) + " give different results for " + signature);
+        }
+        if (seconds < best_seconds) {
+            best = candidate;
+            best_seconds = seconds;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    profile_[signature] = best;
+    if (!profile_path_.empty()) {
+        SaveLocked(profile_path_);
+    }
+    return best;
+}
+
+std::vector<HitOrMiss::Engine> EngineTuner::Candidates(const HitOrMiss& hit_or_miss) {
+
+    std::vector<HitOrMiss::Engine> candidates = { HitOrMiss::Engine::kBytewise, HitOrMiss::Engine::kBitPlane,
+        HitOrMiss::Engine::kRunLength };
+    // при выделении не 1*1 kOpenCv не отличается от kBytewise
+    const cv::Mat& highlight = hit_or_miss.get_hit_highlight();
+    if (highlight.rows == 1 && highlight.cols == 1) {
+        candidates.push_back(HitOrMiss::Engine::kOpenCv);
+    }
+    return candidates;
+}
+
+std::string EngineTuner::Signature(const HitOrMiss& hit_or_miss) {
+    std::ostringstream signature;
+    signature << hit_or_miss.get_image().rows << 'x' << hit_or_miss.get_image().cols
+        << ":t" << hit_or_miss.get_thread_count();
+    AppendKernel(signature, hit_or_miss.get_kernel_foreground());
+    AppendKernel(signature, hit_or_miss.get_kernel_background());
+    AppendKernel(signature, hit_or_miss.get_hit_highlight());
+    return signature.str();
+}
+
+bool EngineTuner::Find(const std::string& signature, HitOrMiss::Engine& engine) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto found = profile_.find(signature);
+    if (found == profile_.end()) {
+        return false;
+    }
+    engine = found->second;
+    return true;
+}
+
+size_t EngineTuner::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return profile_.size();
+}
+
+void EngineTuner::set_verify(bool verify) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    verify_ = verify;
+}
+
+bool EngineTuner::get_verify() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return verify_;
+}
+
+void EngineTuner::set_profile_path(const std::string& profile_path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    profile_path_ = profile_path;
+    if (!profile_path_.empty()) {
+        Load(profile_path_);
+    }
+}
+
+bool EngineTuner::Save(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return SaveLocked(path);
+}
+
+const char* EngineTuner::EngineName(HitOrMiss::Engine engine) {
+    switch (engine) {
+    case HitOrMiss::Engine::kBytewise: return "bytewise";
+    case HitOrMiss::Engine::kBitPlane: return "bit_plane";
+    case HitOrMiss::Engine::kRunLength: return "run_length";
+    case HitOrMiss::Engine::kOpenCv: return "opencv";
+    case HitOrMiss::Engine::kAuto: return "auto";
+    }
+    return "unknown";
+}
+
+void EngineTuner::Load(const std::string& path) {
+
+    // неизвестные движки и испорченные строки пропускаются: профиль только ускоряет выбор
+    std::ifstream file(path);
+    std::string name;
+    std::string signature;
+    while (file >> name >> signature) {
+        for (HitOrMiss::Engine engine : kEngines) {
+            if (name == EngineName(engine)) {
+                profile_[signature] = engine;
+            }
+        }
+    }
+}
+
+bool EngineTuner::SaveLocked(const std::string& path) const {
+    std::ofstream file(path);
+    for (const auto& entry : profile_) {
+        file << EngineName(entry.second) << ' ' << entry.first << '\n';
+    }
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,123 @@
+#include<hitOrMiss/fixed_size_matching.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+const int kWordBytes = 8; // пикселей CV_8UC1 в слове
+const int kMaxSmallSide = 7; // окна от 1*1 до 7*7
+const int kFirstSquare = 9; // и нечетные квадраты от 9*9
+const int kSquareCount = 7; // до 21*21
+
+// Первые Bytes пикселей строки в слове, остальные байты нулевые
+template<int Bytes>
+uint64_t Load(const uchar* pixels) {
+    uint64_t value = 0;
+    std::memcpy(&value, pixels, Bytes);
+    return value;
+}
+
+// Несовпадения строк окна с левым верхним углом в столбце col: ((пиксели xor требуемые) and маска).
+// Full - последнее слово строки окна читается целиком (байты за окном закрыты маской),
+// иначе только до конца окна. Проверка прекращается на первой несовпавшей строке после Eager строк
+template<int Rows, int Words, int LastBytes, bool Full>
+uint64_t Mismatch(const uchar* const* lines, int col, const uint64_t (*care)[Words], const uint64_t (*want)[Words]) {
+    constexpr int kEager = 2;
+    uint64_t mismatch = 0;
+    for (int line = 0; line < Rows; line += 1) {
+        const uchar* pixels = lines[line] + col;
+        for (int word = 0; word < Words - 1; word += 1) {
+            mismatch |= (Load<kWordBytes>(pixels + word * kWordBytes) ^ want[line][word]) & care[line][word];
+        }
+        const uchar* last = pixels + (Words - 1) * kWordBytes;
+        const uint64_t value = Full ? Load<kWordBytes>(last) : Load<LastBytes>(last);
+        mismatch |= (value ^ want[line][Words - 1]) & care[line][Words - 1];
+        if (line + 1 >= kEager && mismatch != 0) break;
+    }
+    return mismatch;
+}
+
+// Проход окном Rows*Cols
+template<int Rows, int Cols>
+void MatchFixed(const cv::Mat& image, const StructuringElement& element, int row_begin, int row_end, cv::Mat& hits) {
+    constexpr int kWords = (Cols + kWordBytes - 1) / kWordBytes;
+    constexpr int kLastBytes = Cols - (kWords - 1) * kWordBytes;
+
+    uchar care_bytes[Rows][kWords * kWordBytes] = {};
+    uchar want_bytes[Rows][kWords * kWordBytes] = {};
+    bool contradiction = false;
+    for (const CarePixel& pixel : element.get_care()) {
+        const uchar want = pixel.black ? 0 : 255;
+        // пиксель, который должен быть и черным, и белым, не совпадает ни с одним окном
+        contradiction = contradiction || (care_bytes[pixel.row][pixel.col] != 0 && want_bytes[pixel.row][pixel.col] != want);
+        care_bytes[pixel.row][pixel.col] = 255;
+        want_bytes[pixel.row][pixel.col] = want;
+    }
+    uint64_t care[Rows][kWords];
+    uint64_t want[Rows][kWords];
+    std::memcpy(care, care_bytes, sizeof(care));
+    std::memcpy(want, want_bytes, sizeof(want));
+
+    const int last_col = image.cols - Cols;
+    // окна, у которых целые слова не выходят за строку изображения
+    const int last_full_col = image.cols - kWords * kWordBytes;
+    for (int mask_row = row_begin; mask_row < row_end; mask_row += 1) {
+        uchar* hits_row = hits.ptr<uchar>(mask_row);
+        if (contradiction) {
+            std::memset(hits_row, 0, last_col + 1);
+            continue;
+        }
+        const uchar* lines[Rows];
+        for (int line = 0; line < Rows; line += 1) {
+            lines[line] = image.ptr<uchar>(mask_row + line);
+        }
+        int mask_col = 0;
+        for (; mask_col <= last_full_col; mask_col += 1) {
+            hits_row[mask_col] = Mismatch<Rows, kWords, kLastBytes, true>(lines, mask_col, care, want) == 0;
+        }
+        for (; mask_col <= last_col; mask_col += 1) {
+            hits_row[mask_col] = Mismatch<Rows, kWords, kLastBytes, false>(lines, mask_col, care, want) == 0;
+        }
+    }
+}
+
+// Таблица специализаций окон Rows*1 ... Rows*kMaxSmallSide
+template<int Rows, size_t... Index>
+constexpr std::array<FixedSizeMatching::BandMatcher, sizeof...(Index)> SmallRow(std::index_sequence<Index...>) {
+    return { &MatchFixed<Rows, static_cast<int>(Index) + 1>... };
+}
+
+template<size_t... Index>
+constexpr std::array<std::array<FixedSizeMatching::BandMatcher, kMaxSmallSide>, sizeof...(Index)>
+SmallTable(std::index_sequence<Index...>) {
+    return { SmallRow<static_cast<int>(Index) + 1>(std::make_index_sequence<kMaxSmallSide>())... };
+}
+
+template<size_t... Index>
+constexpr std::array<FixedSizeMatching::BandMatcher, sizeof...(Index)> SquareTable(std::index_sequence<Index...>) {
+    return { &MatchFixed<kFirstSquare + 2 * static_cast<int>(Index), kFirstSquare + 2 * static_cast<int>(Index)>... };
+}
+
+constexpr auto kSmallMatchers = SmallTable(std::make_index_sequence<kMaxSmallSide>());
+constexpr auto kSquareMatchers = SquareTable(std::make_index_sequence<kSquareCount>());
+
+}
+
+FixedSizeMatching::BandMatcher FixedSizeMatching::Find(const cv::Size& size) {
+    if (size.width >= 1 && size.height >= 1 && size.width <= kMaxSmallSide && size.height <= kMaxSmallSide) {
+        return kSmallMatchers[size.height - 1][size.width - 1];
+    }
+    const int square = size.width - kFirstSquare;
+    if (size.width == size.height && square >= 0 && square % 2 == 0 && square / 2 < kSquareCount) {
+        return kSquareMatchers[square / 2];
+    }
+    return nullptr;
+}
+
+void FixedSizeMatching::Match(const cv::Mat& image, const StructuringElement& element,
+    int row_begin, int row_end, cv::Mat& hits) {
+    Find(element.get_size())(image, element, row_begin, row_end, hits);
+}
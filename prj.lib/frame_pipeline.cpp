@@ -0,0 +1,200 @@
+#include<hitOrMiss/frame_pipeline.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double Seconds(Clock::time_point begin, Clock::time_point end) {
+    return std::chrono::duration<double>(end - begin).count();
+}
+
+// Ограниченная очередь кадров между стадиями. Кольцо выделяется один раз, Push и Pop память не выделяют
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(int capacity) : items_(capacity) {}
+
+    // Положить элемент, ждет свободного места. false - очередь закрыта
+    bool Push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return closed_ || size_ < static_cast<int>(items_.size()); });
+        if (closed_) {
+            return false;
+        }
+        items_[(head_ + size_) % items_.size()] = std::move(item);
+        size_ += 1;
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // Взять элемент, ждет его появления. false - очередь закрыта и пуста (или прервана)
+    bool Pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || size_ > 0; });
+        if (aborted_ || size_ == 0) {
+            return false;
+        }
+        item = std::move(items_[head_]);
+        head_ = (head_ + 1) % items_.size();
+        size_ -= 1;
+        not_full_.notify_one();
+        return true;
+    }
+
+    // Закрыть очередь: оставшиеся элементы еще можно взять, если abort == false
+    void Close(bool abort) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        aborted_ = aborted_ || abort;
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+private:
+    std::vector<T> items_;
+    int head_ = 0;
+    int size_ = 0;
+    bool closed_ = false;
+    bool aborted_ = false;
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+};
+
+}
+
+FramePipeline::FramePipeline(const HitOrMiss& settings, Output output, int queue_size)
+    : hit_or_miss_(settings), output_(output) {
+    if (queue_size < 1) {
+        throw std::invalid_argument("The queue size must be positive");
+    }
+    frames_.resize(queue_size);
+}
+
+FramePipeline::Stats FramePipeline::Run(const Reader& reader, const FrameHandler& handler) {
+    if (!reader || !handler) {
+        throw std::invalid_argument("The frame reader or handler is empty");
+    }
+
+    // кадр проходит free -> decoded -> binary -> matched -> free, в обработке не больше frames_.size() кадров
+    const int capacity = static_cast<int>(frames_.size());
+    BoundedQueue<Frame*> free(capacity);
+    BoundedQueue<Frame*> decoded(capacity);
+    BoundedQueue<Frame*> binary(capacity);
+    BoundedQueue<Frame*> matched(capacity);
+    for (Frame& frame : frames_) {
+        free.Push(&frame);
+    }
+
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    auto fail = [&](std::exception_ptr current) {
+        {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) {
+                error = current;
+            }
+        }
+        free.Close(true);
+        decoded.Close(true);
+        binary.Close(true);
+        matched.Close(true);
+    };
+
+    // стадия берет кадр из input, обрабатывает его process и кладет в output; по концу input закрывает output
+    auto stage = [&](BoundedQueue<Frame*>& input, BoundedQueue<Frame*>& output, StageStats& stats, auto process) {
+        try {
+            Frame* frame = nullptr;
+            while (input.Pop(frame)) {
+                const Clock::time_point begin = Clock::now();
+                const bool more = process(*frame);
+                stats.busy_seconds += Seconds(begin, Clock::now());
+                if (!more) {
+                    break;
+                }
+                stats.frames += 1;
+                if (!output.Push(frame)) {
+                    break;
+                }
+            }
+            output.Close(false);
+        }
+        catch (...) {
+            fail(std::current_exception());
+        }
+    };
+
+    Stats stats;
+    const Clock::time_point begin = Clock::now();
+
+    int next_index = 0;
+    std::thread decode_thread(stage, std::ref(free), std::ref(decoded), std::ref(stats.decode),
+        [&](Frame& frame) {
+            if (!reader(frame.decoded)) {
+                return false;
+            }
+            frame.index = next_index;
+            next_index += 1;
+            return true;
+        });
+    std::thread binarize_thread(stage, std::ref(decoded), std::ref(binary), std::ref(stats.binarize),
+        [](Frame& frame) {
+            frame.binary.Assign(frame.decoded);
+            return true;
+        });
+    std::thread match_thread(stage, std::ref(binary), std::ref(matched), std::ref(stats.match),
+        [this](Frame& frame) {
+            hit_or_miss_.set_image(frame.binary);
+            if (output_ == Output::kBoundary) {
+                hit_or_miss_.DoBoundaryExtraction(frame.result);
+            }
+            else {
+                hit_or_miss_.DoHitOrMiss(frame.result);
+            }
+            return true;
+        });
+
+    // выдача в вызывающем потоке, чтобы обработчик мог работать с окнами и другими ресурсами этого потока
+    stage(matched, free, stats.encode, [&](Frame& frame) {
+        handler(frame.index, frame.result);
+        return true;
+    });
+
+    decode_thread.join();
+    binarize_thread.join();
+    match_thread.join();
+    stats.seconds = Seconds(begin, Clock::now());
+    stats.frames = stats.encode.frames;
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return stats;
+}
+
+FramePipeline::Stats FramePipeline::Run(cv::VideoCapture& capture, const FrameHandler& handler) {
+    return Run([&capture](cv::Mat& frame) { return capture.read(frame); }, handler);
+}
+
+FramePipeline::Stats FramePipeline::Run(const std::vector<std::string>& paths, const FrameHandler& handler) {
+    size_t next = 0;
+    return Run([&paths, &next](cv::Mat& frame) {
+        if (next == paths.size()) {
+            return false;
+        }
+        frame = cv::imread(paths[next], cv::IMREAD_GRAYSCALE);
+        if (frame.empty()) {
+            throw std::invalid_argument("Can not read the image " + paths[next]);
+        }
+        next += 1;
+        return true;
+    }, handler);
+}
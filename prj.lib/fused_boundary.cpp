@@ -0,0 +1,85 @@
+#include<hitOrMiss/fused_boundary.hpp>
+
+#include <algorithm>
+
+namespace {
+
+const int kBlock = 256; // пикселей в блоке середины строки
+
+// Строка границы по строкам выше (up), текущей (row) и ниже (down), nullptr - за краем изображения.
+// Внутренняя граница: черный пиксель остается, если хотя бы один сосед белый (OR соседей = 255).
+// Внешняя: белый пиксель становится черным, если хотя бы один сосед черный (AND соседей = 0).
+template<bool kInner, bool kEight>
+void BoundaryRow(const uchar* up, const uchar* row, const uchar* down, uchar* dst, int cols) {
+
+    // за краем белый фон: у внутренней границы крайние черные пиксели граничные,
+    // у внешней он не меняет AND, и соседа за краем заменяет сам пиксель
+    if (kInner && (up == nullptr || down == nullptr)) {
+        std::copy(row, row + cols, dst);
+        return;
+    }
+    up = up == nullptr ? row : up;
+    down = down == nullptr ? row : down;
+
+    auto pixel = [&](int left, int col, int right) -> uchar {
+        uchar neighbors = kInner ? (row[left] | row[right] | up[col] | down[col])
+            : (row[left] & row[right] & up[col] & down[col]);
+        if (kEight) {
+            neighbors = kInner ? (neighbors | up[left] | up[right] | down[left] | down[right])
+                : (neighbors & up[left] & up[right] & down[left] & down[right]);
+        }
+        return static_cast<uchar>(kInner ? (row[col] | ~neighbors) : (~row[col] | neighbors));
+    };
+
+    const int last = cols - 1;
+    dst[0] = kInner ? row[0] : pixel(0, 0, std::min(1, last));
+
+    // середина строки блоками постоянной длины через локальный буфер: запись в него не пересекается
+    // с чтением строк, и цикл векторизуется без проверок перекрытия
+    int col = 1;
+    for (; col + kBlock <= last; col += kBlock) {
+        uchar block[kBlock];
+        for (int index = 0; index < kBlock; index += 1) {
+            block[index] = pixel(col + index - 1, col + index, col + index + 1);
+        }
+        std::copy(block, block + kBlock, dst + col);
+    }
+    for (; col < last; col += 1) {
+        dst[col] = pixel(col - 1, col, col + 1);
+    }
+    if (last > 0) {
+        dst[last] = kInner ? row[last] : pixel(last - 1, last, last);
+    }
+}
+
+template<bool kInner, bool kEight>
+void BoundaryBand(const cv::Mat& image, int row_begin, int row_end, cv::Mat& dst) {
+    for (int row = row_begin; row < row_end; row += 1) {
+        const uchar* up = row > 0 ? image.ptr<uchar>(row - 1) : nullptr;
+        const uchar* down = row + 1 < image.rows ? image.ptr<uchar>(row + 1) : nullptr;
+        BoundaryRow<kInner, kEight>(up, image.ptr<uchar>(row), down, dst.ptr<uchar>(row), image.cols);
+    }
+}
+
+}
+
+void FusedBoundary::Extract(const cv::Mat& image, Type type, Connectivity connectivity, cv::Mat& dst) {
+    CV_Assert(image.type() == CV_8UC1);
+    dst.create(image.rows, image.cols, CV_8UC1);
+    Extract(image, type, connectivity, 0, image.rows, dst);
+}
+
+void FusedBoundary::Extract(const cv::Mat& image, Type type, Connectivity connectivity,
+    int row_begin, int row_end, cv::Mat& dst) {
+
+    CV_Assert(image.type() == CV_8UC1 && dst.type() == CV_8UC1 && dst.size() == image.size());
+    const bool eight = connectivity == Connectivity::kEight;
+    if (type == Type::kInner) {
+        eight ? BoundaryBand<true, true>(image, row_begin, row_end, dst)
+            : BoundaryBand<true, false>(image, row_begin, row_end, dst);
+    }
+    else {
+        eight ? BoundaryBand<false, true>(image, row_begin, row_end, dst)
+            : BoundaryBand<false, false>(image, row_begin, row_end, dst);
+    }
+}
@@ -1,5 +1,40 @@
 #include<hitOrMiss/hit_or_miss.hpp>
+#include<hitOrMiss/engine_tuner.hpp>
+#include<hitOrMiss/fixed_size_matching.hpp>
+#include<hitOrMiss/fused_boundary.hpp>
+#include<hitOrMiss/neighborhood_table.hpp>
+#include<hitOrMiss/separable_erosion.hpp>
+#include<hitOrMiss/set_operations.hpp>
+#include<hitOrMiss/summed_area_table.hpp>
 
+#include <cmath>
+
+#ifdef HITORMISS_STATS
+//   name   ,   
+#define HITORMISS_STAGE(name) const HitOrMissStats::Scope stage_scope(stats_.get(), name)
+#else
+#define HITORMISS_STAGE(name)
+#endif
+
+namespace {
+
+//  ;   ,        
+inline bool MatchWindow(const StructuringElement& compiled, const cv::Mat& image, int mask_row, int mask_col,
+    HitOrMissStats::Counters* counters) {
+#ifdef HITORMISS_STATS
+    if (counters) {
+        int compared = 0;
+        const bool hit = compiled.Match(image, mask_row, mask_col, compared);
+        counters->AddWindow(compared, hit);
+        return hit;
+    }
+#else
+    static_cast<void>(counters);
+#endif
+    return compiled.Match(image, mask_row, mask_col);
+}
+
+}
 
 
 HitOrMiss::HitOrMiss() {
@@ -7,18 +42,24 @@ HitOrMiss::HitOrMiss() {
     kernel_foreground_ = cv::Mat{ kDefaulKernelForeground,kDefaulKernelForeground, CV_8UC1, cv::Scalar(kBlack) };
     kernel_background_ = cv::Mat{ kDefaulKernelBackground,kDefaulKernelBackground, CV_8UC1, cv::Scalar(kBlack) };
     hit_highlight_ = cv::Mat{ kDefaulHitHighlight,kDefaulHitHighlight, CV_8UC1, cv::Scalar(kBlack) };
+    tuner_ = EngineTuner::Shared();
+    image_bits_ = BitPlane::Pack(image_);
+    image_tiles_ = TileMap(image_bits_);
+    CompileKernels();
 }
 
 HitOrMiss::HitOrMiss(cv::Mat image) :HitOrMiss() {
-    image_ = TypeCheck(image);
+    set_image(image);
 }
 HitOrMiss::HitOrMiss(cv::Mat image, cv::Mat kernel_foreground) :HitOrMiss(image) {
     kernel_foreground_ = TypeCheck(kernel_foreground);
+    CompileKernels();
 }
 HitOrMiss::HitOrMiss(cv::Mat image, cv::Mat kernel_foreground, cv::Mat kernel_background)
     :HitOrMiss(image, kernel_foreground) {
     SizeCheck(kernel_foreground_, kernel_background);
     kernel_background_ = TypeCheck(kernel_background);
+    CompileKernels();
 }
 HitOrMiss::HitOrMiss(cv::Mat image, cv::Mat kernel_foreground, cv::Mat kernel_background, cv::Mat hit_highlight)
     :HitOrMiss(image, kernel_foreground, kernel_background)
@@ -26,73 +67,718 @@ HitOrMiss::HitOrMiss(cv::Mat image, cv::Mat kernel_foreground, cv::Mat kernel_ba
     SizeCheck(kernel_foreground_, kernel_background);
     SizeCheck(kernel_foreground_, hit_highlight);
     hit_highlight_ = TypeCheck(hit_highlight);
+    CompileHighlight();
 }
 
-HitOrMiss::HitOrMiss(const HitOrMiss& rhs) {
-    if (this == &rhs) {
-        return;
+void HitOrMiss::set_image(cv::Mat lhs) {
+    if (lhs.empty()) {
+        throw std::invalid_argument("The uploaded image was empty");
     }
-    this->image_ = rhs.get_image();
-    this->kernel_foreground_ = rhs.get_kernel_foreground();
-    this->kernel_foreground_ = rhs.get_kernel_background();
-    this->hit_highlight_ = rhs.get_hit_highlight();
-}
-
-HitOrMiss& HitOrMiss::operator=(const HitOrMiss& rhs) {
-    if (this == &rhs) {
-        return *this;
+    HITORMISS_STAGE("set_image");
+    BinaryImage binary;
+    {
+        HITORMISS_STAGE("TypeCheck");
+        binary = BinaryImage(lhs);
     }
-    image_ = rhs.image_;
-    kernel_foreground_ = rhs.kernel_foreground_;
-    kernel_background_ = rhs.kernel_background_;
-    hit_highlight_ = rhs.hit_highlight_;
-
-    return *this;
+    set_image(binary);
+    //       
+    cache_.image_private = true;
 }
-
-void HitOrMiss::set_image(cv::Mat lhs) {
-    image_ = TypeCheck(lhs);
+void HitOrMiss::set_image(const BinaryImage& image) {
+    if (image.empty()) {
+        throw std::invalid_argument("The uploaded image was empty");
+    }
+    HITORMISS_STAGE("PrepareImage");
+    image_ = image.get_image();
+    cache_.valid = false;
+    cache_.image_private = false;
+    //  ,          
+    BitPlane::Pack(image_, image_bits_);
+    image_tiles_.Build(image_bits_);
+    image_sums_.clear();
+    PrepareImageSums();
+    image_runs_ = RunLengthImage();
+    PrepareImageRuns();
+    OrderProbes();
 }
 void HitOrMiss::set_kernel_foreground(cv::Mat lhs) {
     kernel_foreground_ = TypeCheck(lhs);
+    CompileKernels();
 }
 void HitOrMiss::set_kernel_background(cv::Mat lhs) {
     SizeCheck(kernel_foreground_, lhs);
     kernel_background_ = TypeCheck(lhs);
+    CompileKernels();
 }
 void HitOrMiss::set_hit_highlight(cv::Mat lhs) {
     hit_highlight_ = TypeCheck(lhs);
+    CompileHighlight();
+}
+void HitOrMiss::set_engine(Engine engine) {
+    engine_ = engine;
+    tuning_.valid = false;
+    if (engine_ != Engine::kAuto) {
+        active_engine_ = engine_;
+    }
+    PrepareImageSums();
+    PrepareImageRuns();
+}
+void HitOrMiss::set_engine_tuner(std::shared_ptr<EngineTuner> tuner) {
+    if (!tuner) {
+        throw std::invalid_argument("The engine tuner is empty");
+    }
+    tuner_ = std::move(tuner);
+    tuning_.valid = false;
+}
+void HitOrMiss::set_thread_count(int thread_count) {
+    if (thread_count < 0) {
+        throw std::invalid_argument("The thread count can't be negative");
+    }
+    thread_count_ = thread_count;
+}
+
+void HitOrMiss::set_probe_ordering(bool probe_ordering) {
+    probe_ordering_ = probe_ordering;
+    //      
+    CompileKernels();
+}
+
+template<class Band>
+void HitOrMiss::ParallelBands(int rows, const Band& band) const {
+
+    const int bands = std::min(rows, thread_count_ == 0 ? cv::getNumThreads() : thread_count_);
+    if (bands <= 1) {
+        band(0, rows);
+        return;
+    }
+
+    cv::parallel_for_(cv::Range(0, bands), [&](const cv::Range& range) {
+        for (int index = range.start; index < range.end; index += 1) {
+            HITORMISS_STAGE("ParallelBands");
+            band(rows * index / bands, rows * (index + 1) / bands);
+        }
+    }, bands);
+}
+
+template<class Match, class Fill>
+void HitOrMiss::TileWindows(const StructuringElement& compiled, int row_begin, int row_end,
+    const Match& match, const Fill& fill) const {
+
+    const cv::Size& window = compiled.get_size();
+    const int last_row = std::min(image_.rows - window.height, row_end - 1);
+    const int last_col = image_.cols - window.width;
+    if (window.empty() || last_row < row_begin || last_col < 0) {
+        return;
+    }
+
+    // ,     , ,      
+    bool black_care = false;
+    bool white_care = false;
+    for (const CarePixel& pixel : compiled.get_care()) {
+        black_care = black_care || pixel.black;
+        white_care = white_care || !pixel.black;
+    }
+
+    //  ,    ,     [mixed_begin, row),
+    //       
+    const int size = TileMap::kTileSize;
+    int mixed_begin = -1;
+    for (int row = row_begin; row <= last_row;) {
+        const int row_next = std::min(last_row + 1, (row / size + 1) * size);
+        //         [row, row_next)    col
+        const auto windows = [&](int col) {
+            return cv::Rect(col, row, std::min(last_col + 1, (col / size + 1) * size) - col, row_next - row);
+        };
+
+        bool mixed = true;
+        for (int col = 0; col <= last_col && mixed; col = windows(col).br().x) {
+            mixed = image_tiles_.Windows(windows(col), window) == TileMap::Tile::kMixed;
+        }
+        if (mixed) {
+            mixed_begin = mixed_begin < 0 ? row : mixed_begin;
+            row = row_next;
+            continue;
+        }
+        if (mixed_begin >= 0) {
+            match(cv::Rect(0, mixed_begin, last_col + 1, row - mixed_begin));
+            mixed_begin = -1;
+        }
+
+        //       
+        int span_begin = -1;
+        for (int col = 0; col <= last_col;) {
+            const cv::Rect tile_windows = windows(col);
+            const TileMap::Tile tile = image_tiles_.Windows(tile_windows, window);
+            if (tile == TileMap::Tile::kMixed) {
+                span_begin = span_begin < 0 ? col : span_begin;
+            }
+            else {
+                if (span_begin >= 0) {
+                    match(cv::Rect(span_begin, row, col - span_begin, row_next - row));
+                    span_begin = -1;
+                }
+                fill(tile_windows, tile == TileMap::Tile::kWhite ? !black_care : !white_care);
+            }
+            col = tile_windows.br().x;
+        }
+        if (span_begin >= 0) {
+            match(cv::Rect(span_begin, row, last_col + 1 - span_begin, row_next - row));
+        }
+        row = row_next;
+    }
+    if (mixed_begin >= 0) {
+        match(cv::Rect(0, mixed_begin, last_col + 1, last_row + 1 - mixed_begin));
+    }
 }
 
 cv::Mat HitOrMiss::DoHitOrMiss() const {
+    cv::Mat dst;
+    DoHitOrMiss(dst);
+    return dst;
+}
+
+template<class Body>
+void HitOrMiss::Instrumented(const char* name, cv::Mat& dst, bool count_hits, const Body& body) const {
+#ifdef HITORMISS_STATS
+    if (stats_) {
+        const HitOrMissStats::Scope scope(stats_.get(), name);
+        const size_t scratch_bytes = ScratchBytes();
+        const uchar* dst_data = dst.data;
+        body();
+
+        //  ,       
+        HitOrMissStats::Counters counters;
+        counters.bytes_allocated = static_cast<long long>(std::max(ScratchBytes(), scratch_bytes) - scratch_bytes);
+        if (dst.data != dst_data) {
+            counters.bytes_allocated += static_cast<long long>(dst.total() * dst.elemSize());
+        }
+        if (count_hits) {
+            counters.hits = static_cast<long long>(dst.total()) - cv::countNonZero(dst);
+        }
+        stats_->AddCounters(counters);
+        return;
+    }
+#endif
+    static_cast<void>(name);
+    static_cast<void>(dst);
+    static_cast<void>(count_hits);
+    body();
+}
+
+size_t HitOrMiss::ScratchBytes() const {
+    size_t bytes = 0;
+    for (const cv::Mat* buffer : { &scratch_.hits, &scratch_.stamp_foreground, &scratch_.stamp_background,
+        &scratch_.hit_or_miss, &scratch_.inverted, &scratch_.morphology }) {
+        bytes += buffer->total() * buffer->elemSize();
+    }
+    for (const BitPlane* buffer : { &scratch_.hits_foreground, &scratch_.hits_background, &scratch_.stamp_plane,
+        &scratch_.result, &scratch_.boundary }) {
+        bytes += buffer->get_bytes();
+    }
+    return bytes;
+}
+
+void HitOrMiss::DoHitOrMiss(cv::Mat& dst) const {
+    Instrumented("DoHitOrMiss", dst, true, [&] { HitOrMissInto(dst); });
+}
+
+void HitOrMiss::HitOrMissInto(cv::Mat& dst) const {
 
     SizeCheck(kernel_foreground_, kernel_background_);
 
+    //     ,   
+    if (dst.data == image_.data) {
+        dst.release();
+    }
+
+    ResolveEngine();
+    InteriorHitOrMiss(dst);
+    if (border_mode_ != BorderMode::kNone) {
+        BorderHitOrMiss(dst);
+    }
+}
+
+void HitOrMiss::InteriorHitOrMiss(cv::Mat& dst) const {
+
+    if (active_engine_ == Engine::kOpenCv && hit_highlight_.rows == 1 && hit_highlight_.cols == 1) {
+        OpenCvHitOrMiss(dst);
+        return;
+    }
+    if (active_engine_ == Engine::kBitPlane) {
+        //    
+        BitPlaneHitOrMiss(image_bits_, {}, scratch_.result);
+        scratch_.result.Unpack(dst);
+        return;
+    }
+    if (active_engine_ == Engine::kRunLength) {
+        RunLengthHitOrMiss().Unpack(dst);
+        return;
+    }
+
+    if (UseFusedWindow()) {
+        FusedMaskMatching(dst);
+        return;
+    }
+
     //       
-    cv::Mat dst_foreground = MaskMatching(true);
+    cv::Mat dst_foreground = ScratchRegion(scratch_.stamp_foreground, image_.rows, image_.cols);
+    MaskMatching(true, dst_foreground);
     //       
-    cv::Mat dst_background = MaskMatching(false);
+    cv::Mat dst_background = ScratchRegion(scratch_.stamp_background, image_.rows, image_.cols);
+    MaskMatching(false, dst_background);
 
-    cv::Mat dst = AndOperation(dst_foreground, dst_background);
+    AndOperation(dst_foreground, dst_background, dst);
+}
 
-    return dst;
+void HitOrMiss::ResolveEngine() const {
+
+    const bool tuned = tuning_.valid && tuning_.size == image_.size() && tuning_.thread_count == thread_count_;
+    if (engine_ == Engine::kAuto && !tuned) {
+        HITORMISS_STAGE("ResolveEngine");
+        //       ,    
+        active_engine_ = tuner_->Select(*this);
+        tuning_.valid = true;
+        tuning_.size = image_.size();
+        tuning_.thread_count = thread_count_;
+    }
+    //   ,  UpdateRegion,   ,   
+    PrepareImageSums();
+    PrepareImageRuns();
+}
+
+void HitOrMiss::OpenCvHitOrMiss(cv::Mat& dst) const {
+    HITORMISS_STAGE("OpenCvHitOrMiss");
+
+    dst.create(image_.rows, image_.cols, CV_8UC1);
+    dst.setTo(cv::Scalar(kWhite));
+
+    const FusedWindow window = GetFusedWindow();
+    const int rows = image_.rows - window.size.height + 1;
+    const int cols = image_.cols - window.size.width + 1;
+    if (window.size.empty() || rows <= 0 || cols <= 0) {
+        return;
+    }
+
+    // 1 -  , -1 - , 0 -  
+    cv::Mat kernel{ window.size.height, window.size.width, CV_32SC1, cv::Scalar(0) };
+    for (const CarePixel& pixel : compiled_fused_.get_care()) {
+        int& cell = kernel.at<int>(pixel.row, pixel.col);
+        const int want = pixel.black ? 1 : -1;
+        // ,     ,  ,      
+        if (cell == -want) {
+            return;
+        }
+        cell = want;
+    }
+
+    // MORPH_HITMISS   ,      ; , 
+    //     , ,      
+    cv::bitwise_not(image_, scratch_.inverted);
+    cv::morphologyEx(scratch_.inverted, scratch_.morphology, cv::MORPH_HITMISS, kernel, cv::Point(0, 0));
+    cv::Mat dst_region = dst(cv::Rect(window.highlight.x, window.highlight.y, cols, rows));
+    cv::bitwise_not(scratch_.morphology(cv::Rect(0, 0, cols, rows)), dst_region);
 }
 
 cv::Mat HitOrMiss::DoBoundaryExtraction() const {
+    cv::Mat dst;
+    DoBoundaryExtraction(dst);
+    return dst;
+}
+
+void HitOrMiss::DoBoundaryExtraction(cv::Mat& dst) const {
+    Instrumented("DoBoundaryExtraction", dst, false, [&] { BoundaryInto(dst); });
+}
+
+void HitOrMiss::BoundaryInto(cv::Mat& dst) const {
 
     SizeCheck(kernel_foreground_, kernel_background_);
 
-    cv::Mat hit_or_miss = DoHitOrMiss();
-    cv::Mat dst = SubstractionOperation(image_, hit_or_miss);
+    if (dst.data == image_.data) {
+        dst.release();
+    }
+
+    FusedBoundary::Connectivity connectivity;
+    if (FusedBoundaryMatching(connectivity)) {
+        FusedBoundaryInto(dst, FusedBoundary::Type::kInner, connectivity);
+        return;
+    }
+
+    ResolveEngine();
+
+    //         cv::Mat,     
+    if (active_engine_ == Engine::kBitPlane && border_mode_ == BorderMode::kNone) {
+        BitPlaneHitOrMiss(image_bits_, {}, scratch_.result);
+        scratch_.boundary = image_bits_;
+        scratch_.boundary.AndNot(scratch_.result);
+        scratch_.boundary.Unpack(dst);
+        return;
+    }
+    if (active_engine_ == Engine::kRunLength && border_mode_ == BorderMode::kNone) {
+        RunLengthImage::Substraction(image_runs_, RunLengthHitOrMiss()).Unpack(dst);
+        return;
+    }
+
+    cv::Mat hit_or_miss = ScratchRegion(scratch_.hit_or_miss, image_.rows, image_.cols);
+    HitOrMissInto(hit_or_miss);
 
+    HITORMISS_STAGE("SubstractionOperation");
+
+    //      ,      
+    dst.create(image_.rows, image_.cols, CV_8UC1);
+    dst.setTo(cv::Scalar(kWhite));
+    const int size = TileMap::kTileSize;
+    for (int tile_row = 0; tile_row < image_tiles_.get_tile_rows(); tile_row += 1) {
+        const int row = tile_row * size;
+        const int height = std::min(size, image_.rows - row);
+        for (int tile_col = 0; tile_col < image_tiles_.get_tile_cols();) {
+            if (image_tiles_.At(tile_row, tile_col) == TileMap::Tile::kWhite) {
+                tile_col += 1;
+                continue;
+            }
+            const int tile_begin = tile_col;
+            while (tile_col < image_tiles_.get_tile_cols() && image_tiles_.At(tile_row, tile_col) != TileMap::Tile::kWhite) {
+                tile_col += 1;
+            }
+            const cv::Rect region(tile_begin * size, row, std::min(tile_col * size, image_.cols) - tile_begin * size, height);
+            cv::Mat dst_region = dst(region);
+            SetOperations::Substraction(image_(region), hit_or_miss(region), dst_region);
+        }
+    }
+}
+
+cv::Mat HitOrMiss::DoBoundaryExtraction(FusedBoundary::Type type, FusedBoundary::Connectivity connectivity) const {
+    cv::Mat dst;
+    DoBoundaryExtraction(dst, type, connectivity);
     return dst;
 }
 
-cv::Mat HitOrMiss::MaskMatching(const bool& foreground) const {
+void HitOrMiss::DoBoundaryExtraction(cv::Mat& dst, FusedBoundary::Type type,
+    FusedBoundary::Connectivity connectivity) const {
+    Instrumented("DoBoundaryExtraction", dst, false, [&] { FusedBoundaryInto(dst, type, connectivity); });
+}
+
+void HitOrMiss::FusedBoundaryInto(cv::Mat& dst, FusedBoundary::Type type,
+    FusedBoundary::Connectivity connectivity) const {
+
+    HITORMISS_STAGE("FusedBoundary");
+    if (dst.data == image_.data) {
+        dst.release();
+    }
+    dst.create(image_.rows, image_.cols, CV_8UC1);
+    ParallelBands(image_.rows, [&](int row_begin, int row_end) {
+        FusedBoundary::Extract(image_, type, connectivity, row_begin, row_end, dst);
+    });
+}
+
+cv::Rect HitOrMiss::UpdateRegion(const cv::Rect& rect, const cv::Mat& patch) {
+    HITORMISS_STAGE("UpdateRegion");
+
+    const cv::Rect image(0, 0, image_.cols, image_.rows);
+    if (rect.empty() || !((rect & image) == rect)) {
+        throw std::invalid_argument("The updated region is outside the image");
+    }
+    if (patch.rows != rect.height || patch.cols != rect.width) {
+        throw std::invalid_argument("The patch size doesn't match the updated region");
+    }
+    const BinaryImage binary(patch);
+
+    //        :     
+    if (!cache_.image_private) {
+        image_ = image_.clone();
+        cache_.image_private = true;
+    }
+    cv::Mat region = image_(rect);
+    binary.get_image().copyTo(region);
+
+    image_bits_.PackRegion(image_, rect);
+    image_tiles_.Update(image_bits_, rect);
+    //        :   
+    //       (ResolveEngine, BuildCache)
+    image_sums_.clear();
+    image_runs_ = RunLengthImage();
+
+    //            
+    auto grow = [&](const cv::Size& size) {
+        return cv::Rect(rect.x - size.width + 1, rect.y - size.height + 1,
+            rect.width + 2 * (size.width - 1), rect.height + 2 * (size.height - 1)) & image;
+    };
+    const cv::Rect foreground = grow(compiled_foreground_.get_size());
+    const cv::Rect background = grow(compiled_background_.get_size());
+    const cv::Rect changed = foreground | background;
+    if (cache_.valid) {
+        UpdateStamp(compiled_foreground_, offsets_foreground_, foreground, cache_.foreground);
+        UpdateStamp(compiled_background_, offsets_background_, background, cache_.background);
+        cv::Mat result = cache_.hit_or_miss(changed);
+        AndOperation(cache_.foreground(changed), cache_.background(changed), result);
+    }
+    return changed;
+}
+
+const cv::Mat& HitOrMiss::CachedHitOrMiss() const {
+    BuildCache();
+    return cache_.hit_or_miss;
+}
+
+const cv::Mat& HitOrMiss::CachedForeground() const {
+    BuildCache();
+    return cache_.foreground;
+}
+
+const cv::Mat& HitOrMiss::CachedBackground() const {
+    BuildCache();
+    return cache_.background;
+}
+
+void HitOrMiss::BuildCache() const {
+
+    if (cache_.valid) {
+        return;
+    }
+    SizeCheck(kernel_foreground_, kernel_background_);
+    PrepareImageSums();
+
+    MaskMatching(true, cache_.foreground);
+    MaskMatching(false, cache_.background);
+
+    //      ,   
+    if (border_mode_ != BorderMode::kNone) {
+        auto update_edges = [&](const StructuringElement& compiled, const std::vector<cv::Point>& offsets, cv::Mat& stamp) {
+            const cv::Rect image(0, 0, image_.cols, image_.rows);
+            const int band_rows = compiled.get_size().height - 1;
+            const int band_cols = compiled.get_size().width - 1;
+            const cv::Rect bands[] = {
+                cv::Rect(0, 0, image_.cols, band_rows) & image,
+                cv::Rect(0, image_.rows - band_rows, image_.cols, band_rows) & image,
+                cv::Rect(0, 0, band_cols, image_.rows) & image,
+                cv::Rect(image_.cols - band_cols, 0, band_cols, image_.rows) & image,
+            };
+            for (const cv::Rect& band : bands) {
+                if (!band.empty()) {
+                    UpdateStamp(compiled, offsets, band, stamp);
+                }
+            }
+        };
+        update_edges(compiled_foreground_, offsets_foreground_, cache_.foreground);
+        update_edges(compiled_background_, offsets_background_, cache_.background);
+    }
+
+    AndOperation(cache_.foreground, cache_.background, cache_.hit_or_miss);
+    cache_.valid = true;
+}
+
+void HitOrMiss::UpdateStamp(const StructuringElement& compiled, const std::vector<cv::Point>& offsets,
+    const cv::Rect& pixels, cv::Mat& stamp) const {
+
+    //    ,             
+    const cv::Size& size = compiled.get_size();
+    const cv::Rect windows(pixels.x - size.width + 1, pixels.y - size.height + 1,
+        pixels.width + size.width - 1, pixels.height + size.height - 1);
+    cv::Mat hits = ScratchRegion(cache_.hits, windows.height, windows.width);
+    for (int row = 0; row < windows.height; row += 1) {
+        uchar* hits_row = hits.ptr<uchar>(row);
+        for (int col = 0; col < windows.width; col += 1) {
+            hits_row[col] = WindowMatch(compiled, windows.y + row, windows.x + col);
+        }
+    }
+
+    cv::Mat region = stamp(pixels);
+    region.setTo(cv::Scalar(kWhite));
+    for (int row = 0; row < windows.height; row += 1) {
+        const uchar* hits_row = hits.ptr<uchar>(row);
+        for (int col = 0; col < windows.width; col += 1) {
+            if (!hits_row[col]) {
+                continue;
+            }
+            for (const cv::Point& offset : offsets) {
+                const cv::Point pixel(windows.x + col + offset.x, windows.y + row + offset.y);
+                if (pixels.contains(pixel)) {
+                    stamp.at<uchar>(pixel) = kBlack;
+                }
+            }
+        }
+    }
+}
+
+std::vector<cv::Mat> HitOrMiss::DoHitOrMissBatch(const std::vector<cv::Mat>& images) const {
+    HITORMISS_STAGE("DoHitOrMissBatch");
+
+    SizeCheck(kernel_foreground_, kernel_background_);
+
+    std::vector<cv::Rect> regions;
+    const BitPlane stack = StackImages(images, regions);
+    BitPlane dst;
+    BitPlaneHitOrMiss(stack, regions, dst);
+    return UnstackImages(dst, regions);
+}
+
+std::vector<cv::Mat> HitOrMiss::DoBoundaryExtractionBatch(const std::vector<cv::Mat>& images) const {
+    HITORMISS_STAGE("DoBoundaryExtractionBatch");
+
+    SizeCheck(kernel_foreground_, kernel_background_);
+
+    std::vector<cv::Rect> regions;
+    BitPlane boundary = StackImages(images, regions);
+    BitPlane hit_or_miss;
+    BitPlaneHitOrMiss(boundary, regions, hit_or_miss);
+    boundary.AndNot(hit_or_miss);
+    return UnstackImages(boundary, regions);
+}
+
+BitPlane HitOrMiss::StackImages(const std::vector<cv::Mat>& images, std::vector<cv::Rect>& regions) const {
+
+    regions.clear();
+    int rows = 0;
+    int cols = 0;
+    for (const cv::Mat& image : images) {
+        if (image.empty()) {
+            throw std::invalid_argument("The uploaded image was empty");
+        }
+        CV_Assert(image.type() == CV_8U && image.channels() == 1);
+        regions.emplace_back(0, rows, image.cols, image.rows);
+        rows += image.rows;
+        cols = std::max(cols, image.cols);
+    }
+
+    //    ,   
+    BitPlane stack(rows, cols);
+    for (size_t index = 0; index < images.size(); index += 1) {
+        for (int row = 0; row < images[index].rows; row += 1) {
+            stack.PackRow(regions[index].y + row, images[index].ptr<uchar>(row), images[index].cols, kThresholdValue);
+        }
+    }
+    return stack;
+}
+
+void HitOrMiss::RestrictHits(const cv::Size& window, const std::vector<cv::Rect>& regions, BitPlane& hits) const {
+
+    const int words = hits.get_words_per_row();
+    for (const cv::Rect& region : regions) {
+        //      region.width - window.width + 1    ,
+        //    ,        
+        const int count = region.width - window.width + 1;
+        for (int row = region.y; row < region.y + region.height; row += 1) {
+            uint64_t* hits_row = hits.Row(row);
+            const bool fits = row + window.height <= region.y + region.height && count > 0;
+            for (int word = 0; word < words; word += 1) {
+                const int bits = fits ? std::min(64, std::max(0, count - 64 * word)) : 0;
+                hits_row[word] &= bits == 64 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << bits) - 1;
+            }
+        }
+    }
+}
+
+std::vector<cv::Mat> HitOrMiss::UnstackImages(const BitPlane& stack, const std::vector<cv::Rect>& regions) const {
+
+    cv::Mat dst;
+    stack.Unpack(dst);
+
+    std::vector<cv::Mat> images;
+    for (const cv::Rect& region : regions) {
+        images.push_back(dst(region));
+    }
+    return images;
+}
+
+void HitOrMiss::BitPlaneHitOrMiss(const BitPlane& image, const std::vector<cv::Rect>& regions, BitPlane& dst) const {
+    HITORMISS_STAGE("BitPlaneHitOrMiss");
+
+    const int rows = image.get_rows();
+    const int cols = image.get_cols();
+    dst.Create(rows, cols);
+
+    if (UseFusedWindow()) {
+        //   :     ,  ,
+        //      ,     
+        const FusedWindow window = GetFusedWindow();
+        if (regions.empty()) {
+            ParallelBands(rows, [&](int row_begin, int row_end) {
+                MatchPlaneBand(compiled_fused_, window.highlight, row_begin, row_end, dst);
+            });
+            return;
+        }
+
+        //    ,  
+        BitPlane& hits = scratch_.hits_foreground;
+        hits.Create(rows, cols);
+        ParallelBands(rows, [&](int row_begin, int row_end) {
+            BitPlane::Match(image, compiled_fused_, cv::Point(0, 0), row_begin, row_end, hits);
+        });
+        RestrictHits(window.size, regions, hits);
+        const std::vector<cv::Point> offsets{ window.highlight };
+        ParallelBands(rows, [&](int row_begin, int row_end) {
+            BitPlane::Stamp(hits, offsets, row_begin, row_end, dst);
+        });
+        return;
+    }
+
+    //   :   kernel.rows - 1   
+    BitPlane& hits_foreground = scratch_.hits_foreground;
+    BitPlane& hits_background = scratch_.hits_background;
+    hits_foreground.Create(rows, cols);
+    hits_background.Create(rows, cols);
+    ParallelBands(rows, [&](int row_begin, int row_end) {
+        //     ,     
+        if (regions.empty()) {
+            MatchPlaneBand(compiled_foreground_, cv::Point(0, 0), row_begin, row_end, hits_foreground);
+            MatchPlaneBand(compiled_background_, cv::Point(0, 0), row_begin, row_end, hits_background);
+            return;
+        }
+        BitPlane::Match(image, compiled_foreground_, cv::Point(0, 0), row_begin, row_end, hits_foreground);
+        BitPlane::Match(image, compiled_background_, cv::Point(0, 0), row_begin, row_end, hits_background);
+    });
+    if (!regions.empty()) {
+        RestrictHits(kernel_foreground_.size(), regions, hits_foreground);
+        RestrictHits(kernel_background_.size(), regions, hits_background);
+    }
+
+    //  :            
+    BitPlane& dst_background = scratch_.stamp_plane;
+    dst_background.Create(rows, cols);
+    ParallelBands(rows, [&](int row_begin, int row_end) {
+        BitPlane::Stamp(hits_foreground, offsets_foreground_, row_begin, row_end, dst);
+        BitPlane::Stamp(hits_background, offsets_background_, row_begin, row_end, dst_background);
+    });
+
+    dst.And(dst_background);
+}
+
+RunLengthImage HitOrMiss::RunLengthHitOrMiss() const {
+    HITORMISS_STAGE("RunLengthHitOrMiss");
+
+    const cv::Size size = image_.size();
+
+    //   1*1           
+    if (hit_highlight_.rows == 1 && hit_highlight_.cols == 1) {
+        const FusedWindow window = GetFusedWindow();
+        if (window.size.empty()) {
+            return RunLengthImage(size.height, size.width);
+        }
+        return RunLengthImage::Stamp(RunLengthImage::Match(image_runs_, compiled_fused_), { window.highlight }, size);
+    }
+
+    const RunLengthImage dst_foreground = RunLengthImage::Stamp(RunLengthImage::Match(image_runs_, compiled_foreground_),
+        offsets_foreground_, size);
+    const RunLengthImage dst_background = RunLengthImage::Stamp(RunLengthImage::Match(image_runs_, compiled_background_),
+        offsets_background_, size);
+    return RunLengthImage::And(dst_foreground, dst_background);
+}
+
+void HitOrMiss::MaskMatching(const bool& foreground, cv::Mat& dst) const {
+    HITORMISS_STAGE("MaskMatching");
 
     cv::Mat kernel = foreground ? kernel_foreground_ : kernel_background_;
+    const StructuringElement& compiled = foreground ? compiled_foreground_ : compiled_background_;
+    const std::vector<cv::Point>& offsets = foreground ? offsets_foreground_ : offsets_background_;
 
-    cv::Mat dst{ image_.rows,image_.cols, CV_8UC1, cv::Scalar(kWhite) };
+    //       :     
+    if (thread_count_ != 1 || FastMatching(compiled) || image_tiles_.HasUniform()) {
+        ParallelMaskMatching(kernel, compiled, offsets, dst);
+        return;
+    }
+
+    dst.create(image_.rows, image_.cols, CV_8UC1);
+    dst.setTo(cv::Scalar(kWhite));
+    HitOrMissStats::Counters counters;
 
     /*
     *         
@@ -101,125 +787,492 @@ cv::Mat HitOrMiss::MaskMatching(const bool& foreground) const {
     for (int mask_row = 0; mask_row <= image_.rows - kernel.rows; mask_row += 1) {
         for (int mask_col = 0; mask_col <= image_.cols - kernel.cols; mask_col += 1) {
 
-            bool hit = true; //    , ,   
+            //      
+            bool hit = MatchWindow(compiled, image_, mask_row, mask_col, CountersSink(counters));
 
-            //        
-            for (int step_row = 0; step_row < kernel.rows; step_row += 1) {
-                for (int step_col = 0; step_col < kernel.cols; step_col += 1) {
+            //   ,        ,
+            //  ;    ,    
+            if (hit) {
+                for (const cv::Point& offset : offsets) {
+                    dst.at<uchar>(mask_row + offset.y, mask_col + offset.x) = kBlack;
+                }
+            }
+        }
+    }
+    RecordCounters(counters);
+}
+
+void HitOrMiss::FusedMaskMatching(cv::Mat& dst) const {
+    HITORMISS_STAGE("FusedMaskMatching");
 
-                    //    
-                    int image_pixel = image_.at<uchar>(mask_row + step_row, mask_col + step_col);
-                    //     
-                    int kernel_pixel = kernel.at<uchar>(step_row, step_col);
+    dst.create(image_.rows, image_.cols, CV_8UC1);
+    dst.setTo(cv::Scalar(kWhite));
 
-                    //   ,        
-                    if (foreground && kernel_pixel == kWhite) continue;
-                    //   ,        
-                    if (!foreground && kernel_pixel == kBlack) continue;
+    const FusedWindow window = GetFusedWindow();
+    if (window.size.empty()) {
+        return;
+    }
 
-                    if (image_pixel != kernel_pixel) {
-                        hit = false;
-                        break;
-                    }
+    //     ,   
+    if (FastMatching(compiled_fused_) || image_tiles_.HasUniform()) {
+        const int last_col = image_.cols - window.size.width;
+        if (last_col < 0 || image_.rows < window.size.height) {
+            return;
+        }
+        cv::Mat hits = ScratchRegion(scratch_.hits, image_.rows - window.size.height + 1, last_col + 1);
+        ParallelBands(hits.rows, [&](int row_begin, int row_end) {
+            MatchBand(compiled_fused_, row_begin, row_end, hits);
+            for (int mask_row = row_begin; mask_row < row_end; mask_row += 1) {
+                const uchar* hits_row = hits.ptr<uchar>(mask_row);
+                uchar* dst_row = dst.ptr<uchar>(mask_row + window.highlight.y) + window.highlight.x;
+                for (int mask_col = 0; mask_col <= last_col; mask_col += 1) {
+                    dst_row[mask_col] = hits_row[mask_col] ? static_cast<uchar>(kBlack) : dst_row[mask_col];
                 }
-                if (!hit) break;
             }
+        });
+        return;
+    }
 
-            //   ,        ,
-            //  
-            if (hit) {
-                if (hit_highlight_.rows == 1 && hit_highlight_.cols == 1) {
-                    dst.at<uchar>(mask_row + kernel.rows / 2, mask_col + kernel.cols / 2) = kBlack;
-                }
-                else {
-                    for (int step_row = 0; step_row < kernel.rows; step_row += 1) {
-                        for (int step_col = 0; step_col < kernel.cols; step_col += 1) {
-
-                            if (mask_row + step_row<image_.rows && mask_col + step_col<image_.cols)
-                                if (hit_highlight_.at<uchar>(step_row, step_col) == kBlack)
-                                dst.at<uchar>(mask_row + step_row, mask_col + step_col) = kBlack;
-                        }
-                    }
+    ParallelBands(image_.rows - window.size.height + 1, [&](int row_begin, int row_end) {
+        HitOrMissStats::Counters counters;
+        for (int mask_row = row_begin; mask_row < row_end; mask_row += 1) {
+            for (int mask_col = 0; mask_col <= image_.cols - window.size.width; mask_col += 1) {
+                if (MatchWindow(compiled_fused_, image_, mask_row, mask_col, CountersSink(counters))) {
+                    dst.at<uchar>(mask_row + window.highlight.y, mask_col + window.highlight.x) = kBlack;
                 }
             }
         }
+        RecordCounters(counters);
+    });
+}
+
+void HitOrMiss::BorderHitOrMiss(cv::Mat& dst) const {
+    HITORMISS_STAGE("BorderHitOrMiss");
+
+    //              ,
+    //     
+    const cv::Size& foreground = compiled_foreground_.get_size();
+    const cv::Size& background = compiled_background_.get_size();
+    const int band_rows = std::max(foreground.height, background.height) - 1;
+    const int band_cols = std::max(foreground.width, background.width) - 1;
+    if (band_rows <= 0 && band_cols <= 0) {
+        return;
+    }
+
+    for (int row = 0; row < image_.rows; row += 1) {
+        uchar* dst_row = dst.ptr<uchar>(row);
+        auto recompute = [&](int col_begin, int col_end) {
+            for (int col = col_begin; col < col_end; col += 1) {
+                const bool hit = BorderStamp(compiled_foreground_, offsets_foreground_, row, col)
+                    && BorderStamp(compiled_background_, offsets_background_, row, col);
+                dst_row[col] = hit ? kBlack : kWhite;
+            }
+        };
+        if (row < band_rows || row >= image_.rows - band_rows) {
+            recompute(0, image_.cols);
+        }
+        else {
+            //  ,      ,       
+            recompute(0, std::min(band_cols, image_.cols));
+            recompute(std::max(band_cols, image_.cols - band_cols), image_.cols);
+        }
     }
-    return dst;
 }
 
-cv::Mat HitOrMiss::AndOperation(const cv::Mat& lhs, const cv::Mat& rhs) const {
+bool HitOrMiss::BorderStamp(const StructuringElement& compiled, const std::vector<cv::Point>& offsets,
+    int row, int col) const {
 
-    SizeCheck(lhs, rhs);
+    // ,     offset,   
+    for (const cv::Point& offset : offsets) {
+        if (WindowMatch(compiled, row - offset.y, col - offset.x)) {
+            return true;
+        }
+    }
+    return false;
+}
 
-    cv::Mat result{ lhs.rows,lhs.cols, CV_8UC1, cv::Scalar(kWhite) };
+bool HitOrMiss::WindowMatch(const StructuringElement& compiled, int mask_row, int mask_col) const {
 
-    for (int lhs_row = kBlack; lhs_row < lhs.rows; lhs_row += 1) {
-        for (int lhs_col = kBlack; lhs_col < lhs.cols; lhs_col += 1) {
-            if (lhs.at<uchar>(lhs_row, lhs_col) == kBlack && rhs.at<uchar>(lhs_row, lhs_col) == kBlack) {
-                result.at<uchar>(lhs_row, lhs_col) = kBlack;
-            }
-            else {
-                result.at<uchar>(lhs_row, lhs_col) = kWhite;
-            }
+    const cv::Size& size = compiled.get_size();
+    if (mask_row >= 0 && mask_col >= 0 && mask_row + size.height <= image_.rows && mask_col + size.width <= image_.cols) {
+        return compiled.Match(image_, mask_row, mask_col);
+    }
+    return border_mode_ != BorderMode::kNone && BorderMatch(compiled, mask_row, mask_col);
+}
+
+bool HitOrMiss::BorderMatch(const StructuringElement& compiled, int mask_row, int mask_col) const {
+
+    for (const CarePixel& pixel : compiled.get_care()) {
+        int row = mask_row + pixel.row;
+        int col = mask_col + pixel.col;
+        bool black = false;
+        if (row >= 0 && row < image_.rows && col >= 0 && col < image_.cols) {
+            black = image_.at<uchar>(row, col) == kBlack;
+        }
+        else if (border_mode_ == BorderMode::kReplicate) {
+            row = std::clamp(row, 0, image_.rows - 1);
+            col = std::clamp(col, 0, image_.cols - 1);
+            black = image_.at<uchar>(row, col) == kBlack;
+        }
+        else {
+            black = border_mode_ == BorderMode::kBlack;
+        }
+        if (black != pixel.black) {
+            return false;
         }
     }
-    return result;
+    return true;
 }
 
-cv::Mat HitOrMiss::OrOperation(const cv::Mat& lhs, const cv::Mat& rhs) const {
+bool HitOrMiss::UseFusedWindow() const {
 
-    SizeCheck(lhs, rhs);
+    if (hit_highlight_.rows != 1 || hit_highlight_.cols != 1) {
+        return false;
+    }
 
-    cv::Mat result{ lhs.rows,lhs.cols, CV_8UC1, cv::Scalar(kWhite) };
+    //       ,        
+    return FastMatching(compiled_fused_)
+        || !(FastMatching(compiled_foreground_) || FastMatching(compiled_background_));
+}
 
-    for (int lhs_row = kBlack; lhs_row < lhs.rows; lhs_row += 1) {
-        for (int lhs_col = kBlack; lhs_col < lhs.cols; lhs_col += 1) {
-            if (lhs.at<uchar>(lhs_row, lhs_col) == kBlack || rhs.at<uchar>(lhs_row, lhs_col) == kBlack) {
-                result.at<uchar>(lhs_row, lhs_col) = kBlack;
-            }
-            else {
-                result.at<uchar>(lhs_row, lhs_col) = kWhite;
-            }
+bool HitOrMiss::FusedBoundaryMatching(FusedBoundary::Connectivity& connectivity) const {
+
+    if (border_mode_ == BorderMode::kBlack || border_mode_ == BorderMode::kReplicate) {
+        return false;
+    }
+    if (hit_highlight_.rows != 1 || hit_highlight_.cols != 1 || !compiled_background_.get_care().empty()
+        || compiled_foreground_.get_size() != cv::Size(3, 3)) {
+        return false;
+    }
+
+    // 9    - , 5   - 
+    const std::vector<CarePixel>& care = compiled_foreground_.get_care();
+    int corners = 0;
+    for (const CarePixel& pixel : care) {
+        if (!pixel.black) {
+            return false;
         }
+        corners += pixel.row != 1 && pixel.col != 1;
     }
-    return result;
+    if (care.size() == 9) {
+        connectivity = FusedBoundary::Connectivity::kEight;
+        return true;
+    }
+    if (care.size() == 5 && corners == 0) {
+        connectivity = FusedBoundary::Connectivity::kFour;
+        return true;
+    }
+    return false;
 }
 
-cv::Mat HitOrMiss::SubstractionOperation(const cv::Mat& lhs, const cv::Mat& rhs) const {
+bool HitOrMiss::FastMatching(const StructuringElement& compiled) const {
+    return SeparableErosion::Supports(compiled) || LookupMatching(compiled)
+        || SpecializedMatching(compiled) || SummedAreaMatching(compiled);
+}
 
-    SizeCheck(lhs, rhs);
+bool HitOrMiss::BytewiseEngine() const {
+    // kOpenCv    1*1   kBytewise
+    return active_engine_ == Engine::kBytewise
+        || (active_engine_ == Engine::kOpenCv && (hit_highlight_.rows != 1 || hit_highlight_.cols != 1));
+}
 
-    cv::Mat result{ lhs.rows,lhs.cols, CV_8UC1, cv::Scalar(kWhite) };
+bool HitOrMiss::LookupMatching(const StructuringElement& compiled) const {
+    //           ,
+    //   64       
+    return BytewiseEngine() && NeighborhoodTable::Supports(compiled);
+}
+
+bool HitOrMiss::SpecializedMatching(const StructuringElement& compiled) const {
+    //   8         
+    //         
+    return BytewiseEngine() && !LookupMatching(compiled) && FixedSizeMatching::Supports(compiled);
+}
+
+bool HitOrMiss::SummedAreaMatching(const StructuringElement& compiled) const {
+    //    64     ,  4 
+    //          
+    return BytewiseEngine() && !LookupMatching(compiled) && !SpecializedMatching(compiled)
+        && SummedAreaTable::Supports(compiled);
+}
+
+void HitOrMiss::MatchBand(const StructuringElement& compiled, int row_begin, int row_end, cv::Mat& hits) const {
 
-    for (int lhs_row = kBlack; lhs_row < lhs.rows; lhs_row += 1) {
-        for (int lhs_col = kBlack; lhs_col < lhs.cols; lhs_col += 1) {
-            if (lhs.at<uchar>(lhs_row, lhs_col) == kBlack && rhs.at<uchar>(lhs_row, lhs_col) == kBlack) {
-                result.at<uchar>(lhs_row, lhs_col) = kWhite;
+    const cv::Size& size = compiled.get_size();
+    const NeighborhoodTable table = LookupMatching(compiled) ? NeighborhoodTable(compiled) : NeighborhoodTable();
+    HitOrMissStats::Counters counters;
+
+    TileWindows(compiled, row_begin, row_end, [&](const cv::Rect& windows) {
+        //       ,   cv::Mat    
+        const cv::Mat image = image_(cv::Rect(windows.x, windows.y,
+            windows.width + size.width - 1, windows.height + size.height - 1));
+        cv::Mat region_hits = hits(windows);
+
+        //      ,     
+        if (FastMatching(compiled)) {
+            counters.windows_tested += windows.area();
+        }
+        if (SeparableErosion::Supports(compiled)) {
+            SeparableErosion::Match(image, compiled, 0, windows.height, region_hits);
+            return;
+        }
+        if (LookupMatching(compiled)) {
+            table.Match(image, 0, windows.height, region_hits);
+            return;
+        }
+        if (SpecializedMatching(compiled)) {
+            FixedSizeMatching::Match(image, compiled, 0, windows.height, region_hits);
+            return;
+        }
+        if (SummedAreaMatching(compiled)) {
+            image_sums_.Match(compiled, windows, hits);
+            return;
+        }
+
+        for (int mask_row = windows.y; mask_row < windows.y + windows.height; mask_row += 1) {
+            uchar* hits_row = hits.ptr<uchar>(mask_row);
+            for (int mask_col = windows.x; mask_col < windows.x + windows.width; mask_col += 1) {
+                hits_row[mask_col] = MatchWindow(compiled, image_, mask_row, mask_col, CountersSink(counters));
             }
-            else {
-                if (lhs.at<uchar>(lhs_row, lhs_col) == kBlack && rhs.at<uchar>(lhs_row, lhs_col) != kBlack) {
-                    result.at<uchar>(lhs_row, lhs_col) = kBlack;
-                }
-                else {
-                    result.at<uchar>(lhs_row, lhs_col) = kWhite;
+        }
+    }, [&](const cv::Rect& windows, bool hit) {
+        hits(windows).setTo(cv::Scalar(hit));
+    });
+    RecordCounters(counters);
+}
+
+void HitOrMiss::MatchPlaneBand(const StructuringElement& compiled, const cv::Point& offset,
+    int row_begin, int row_end, BitPlane& dst) const {
+
+    //        ,     
+    if (SeparableErosion::Supports(compiled)) {
+        BitPlane::Match(image_bits_, compiled, offset, row_begin, row_end, dst);
+        HitOrMissStats::Counters counters;
+        counters.windows_tested = static_cast<long long>(row_end - row_begin)
+            * (image_bits_.get_cols() - compiled.get_size().width + 1);
+        RecordCounters(counters);
+        return;
+    }
+
+    HitOrMissStats::Counters counters;
+    TileWindows(compiled, row_begin, row_end, [&](const cv::Rect& windows) {
+        counters.windows_tested += windows.area();
+        BitPlane::Match(image_bits_, compiled, offset, windows, dst);
+    }, [&](const cv::Rect& windows, bool hit) {
+        if (!hit) return;
+        for (int mask_row = windows.y; mask_row < windows.y + windows.height; mask_row += 1) {
+            dst.Fill(mask_row + offset.y, windows.x + offset.x, windows.x + windows.width + offset.x);
+        }
+    });
+    RecordCounters(counters);
+}
+
+HitOrMiss::FusedWindow HitOrMiss::GetFusedWindow() const {
+
+    FusedWindow window;
+    if (kernel_foreground_.empty() || kernel_background_.empty()) {
+        return window;
+    }
+
+    //    ,      
+    const cv::Point center_foreground(kernel_foreground_.cols / 2, kernel_foreground_.rows / 2);
+    const cv::Point center_background(kernel_background_.cols / 2, kernel_background_.rows / 2);
+    window.foreground = cv::Point(std::max(0, center_background.x - center_foreground.x),
+        std::max(0, center_background.y - center_foreground.y));
+    window.background = cv::Point(std::max(0, center_foreground.x - center_background.x),
+        std::max(0, center_foreground.y - center_background.y));
+    window.size = cv::Size(
+        std::max(window.foreground.x + kernel_foreground_.cols, window.background.x + kernel_background_.cols),
+        std::max(window.foreground.y + kernel_foreground_.rows, window.background.y + kernel_background_.rows));
+    window.highlight = window.foreground + center_foreground;
+    return window;
+}
+
+void HitOrMiss::ParallelMaskMatching(const cv::Mat& kernel, const StructuringElement& compiled,
+    const std::vector<cv::Point>& offsets, cv::Mat& dst) const {
+
+    dst.create(image_.rows, image_.cols, CV_8UC1);
+    dst.setTo(cv::Scalar(kWhite));
+
+    const int last_row = image_.rows - kernel.rows;
+    const int last_col = image_.cols - kernel.cols;
+    if (kernel.empty() || last_row < 0 || last_col < 0) {
+        return;
+    }
+
+    /*
+    *  :         ,
+    *   kernel.rows - 1     (  
+    *   ,     )
+    */
+    cv::Mat hits = ScratchRegion(scratch_.hits, last_row + 1, last_col + 1);
+    ParallelBands(last_row + 1, [&](int row_begin, int row_end) {
+        MatchBand(compiled, row_begin, row_end, hits);
+    });
+
+    /*
+    *  :  ,   ,   ,
+    *     ,        
+    */
+    ParallelBands(image_.rows, [&](int row_begin, int row_end) {
+        for (int row = row_begin; row < row_end; row += 1) {
+            uchar* dst_row = dst.ptr<uchar>(row);
+            for (const cv::Point& offset : offsets) {
+                const int mask_row = row - offset.y;
+                if (mask_row < 0 || mask_row > last_row) continue;
+
+                //   :   
+                const uchar* hits_row = hits.ptr<uchar>(mask_row);
+                uchar* stamp_row = dst_row + offset.x;
+                for (int mask_col = 0; mask_col <= last_col; mask_col += 1) {
+                    stamp_row[mask_col] = hits_row[mask_col] ? static_cast<uchar>(kBlack) : stamp_row[mask_col];
                 }
             }
+        }
+    });
+}
+
+void HitOrMiss::CompileKernels() {
+    cache_.valid = false;
+    tuning_.valid = false;
+
+    compiled_foreground_ = StructuringElement(kernel_foreground_, true);
+    compiled_background_ = StructuringElement(kernel_background_, false);
 
+    //   1*1      ,   
+    const FusedWindow window = GetFusedWindow();
+    compiled_fused_ = StructuringElement::Combine(compiled_foreground_, window.foreground,
+        compiled_background_, window.background, window.size);
+    probe_order_.valid = false;
+
+    CompileHighlight();
+    PrepareImageSums();
+    OrderProbes();
+}
+
+void HitOrMiss::OrderProbes() {
+    if (!probe_ordering_) {
+        return;
+    }
+
+    //   ,        :
+    //       
+    const double black_ratio = SampledBlackRatio();
+    if (probe_order_.valid && probe_order_.size == image_.size()
+        && std::abs(black_ratio - probe_order_.black_ratio) <= kProbeOrderDrift) {
+        return;
+    }
+    HITORMISS_STAGE("OrderProbes");
+
+    //      ,        
+    compiled_foreground_.OrderProbes(image_);
+    compiled_background_.OrderProbes(image_);
+    compiled_fused_.OrderProbes(image_);
+    probe_order_.valid = true;
+    probe_order_.size = image_.size();
+    probe_order_.black_ratio = black_ratio;
+}
+
+double HitOrMiss::SampledBlackRatio() const {
+    const int rows = std::min(image_.rows, kBlackRatioSide);
+    const int cols = std::min(image_.cols, kBlackRatioSide);
+    int black = 0;
+    for (int row = 0; row < rows; row += 1) {
+        const uchar* image_row = image_.ptr<uchar>(row * image_.rows / rows);
+        for (int col = 0; col < cols; col += 1) {
+            black += image_row[col * image_.cols / cols] == kBlack;
         }
     }
-    return result;
+    return static_cast<double>(black) / (rows * cols);
 }
 
+void HitOrMiss::CompileHighlight() {
+    cache_.valid = false;
+    tuning_.valid = false;
+    offsets_foreground_ = HighlightOffsets(kernel_foreground_.size());
+    offsets_background_ = HighlightOffsets(kernel_background_.size());
+    //   ,   kOpenCv  kBytewise   
+    PrepareImageSums();
+}
+
+void HitOrMiss::PrepareImageSums() const {
+
+    //            
+    const bool needed = SummedAreaMatching(compiled_foreground_)
+        || SummedAreaMatching(compiled_background_) || SummedAreaMatching(compiled_fused_);
+    if (needed && image_sums_.empty() && !image_.empty()) {
+        image_sums_.Build(image_);
+    }
+}
+
+void HitOrMiss::PrepareImageRuns() const {
+
+    //      :       
+    if (active_engine_ == Engine::kRunLength && image_runs_.empty() && !image_.empty()) {
+        image_runs_ = RunLengthImage(image_);
+    }
+}
+
+std::vector<cv::Point> HitOrMiss::HighlightOffsets(const cv::Size& kernel_size) const {
+
+    std::vector<cv::Point> offsets;
+
+    //  1*1   
+    if (hit_highlight_.rows == 1 && hit_highlight_.cols == 1) {
+        offsets.emplace_back(kernel_size.width / 2, kernel_size.height / 2);
+        return offsets;
+    }
+
+    const int rows = std::min(kernel_size.height, hit_highlight_.rows);
+    const int cols = std::min(kernel_size.width, hit_highlight_.cols);
+    for (int step_row = 0; step_row < rows; step_row += 1) {
+        for (int step_col = 0; step_col < cols; step_col += 1) {
+            if (hit_highlight_.at<uchar>(step_row, step_col) == kBlack) {
+                offsets.emplace_back(step_col, step_row);
+            }
+        }
+    }
+    return offsets;
+}
+
+void HitOrMiss::AndOperation(const cv::Mat& lhs, const cv::Mat& rhs, cv::Mat& dst) const {
+    HITORMISS_STAGE("AndOperation");
+
+    SizeCheck(lhs, rhs);
+    SetOperations::And(lhs, rhs, dst);
+}
+
+void HitOrMiss::OrOperation(const cv::Mat& lhs, const cv::Mat& rhs, cv::Mat& dst) const {
+    HITORMISS_STAGE("OrOperation");
+
+    SizeCheck(lhs, rhs);
+    SetOperations::Or(lhs, rhs, dst);
+}
+
+void HitOrMiss::SubstractionOperation(const cv::Mat& lhs, const cv::Mat& rhs, cv::Mat& dst) const {
+    HITORMISS_STAGE("SubstractionOperation");
+
+    SizeCheck(lhs, rhs);
+    SetOperations::Substraction(lhs, rhs, dst);
+}
+
+cv::Mat HitOrMiss::ScratchRegion(cv::Mat& buffer, int rows, int cols) const {
+
+    //           
+    if (buffer.rows < rows || buffer.cols < cols) {
+        buffer.create(std::max(buffer.rows, rows), std::max(buffer.cols, cols), CV_8UC1);
+    }
+    return buffer(cv::Rect(0, 0, cols, rows));
+}
 
 cv::Mat HitOrMiss::TypeCheck(cv::Mat src) const {
+    HITORMISS_STAGE("TypeCheck");
     if (src.empty()) {
         throw std::invalid_argument("The uploaded image was empty");
     }
     else {
         CV_Assert(src.type() == CV_8U && src.channels() == 1);
-        cv::Mat dst = src;
-        cv::threshold(src, dst, kThresholdValue, kWhite, cv::THRESH_BINARY);
-        return dst;
+        //    :    
+        return BinaryImage(src, kThresholdValue).get_image();
     }
 }
 
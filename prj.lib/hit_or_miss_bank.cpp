@@ -0,0 +1,245 @@
+#include<hitOrMiss/hit_or_miss_bank.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+const int kWordBits = 64; // количество пикселей в слове
+
+// 64 бита строки row, начиная с пикселя bit; пиксели за пределами изображения - нулевые биты
+uint64_t Probe(const BitPlane& image, int row, int bit) {
+    if (row < 0 || row >= image.get_rows() || bit >= image.get_cols() || bit <= -kWordBits) {
+        return 0;
+    }
+    if (bit >= 0) {
+        return BitPlane::Extract(image.Row(row), bit);
+    }
+    return image.Row(row)[0] << -bit;
+}
+
+}
+
+int HitOrMissBank::AddPattern(cv::Mat kernel_foreground, cv::Mat kernel_background) {
+    if (kernel_foreground.empty()) {
+        throw std::invalid_argument("The uploaded image was empty");
+    }
+    CV_Assert(kernel_foreground.type() == CV_8UC1);
+    cv::Mat foreground;
+    cv::threshold(kernel_foreground, foreground, kThresholdValue, kWhite, cv::THRESH_BINARY);
+
+    // без заднего плана - как по умолчанию в HitOrMiss: черный 1*1 без значимых пикселей
+    cv::Mat background{ 1, 1, CV_8UC1, cv::Scalar(kBlack) };
+    if (!kernel_background.empty()) {
+        CV_Assert(kernel_background.type() == CV_8UC1);
+        cv::threshold(kernel_background, background, kThresholdValue, kWhite, cv::THRESH_BINARY);
+    }
+    if ((background.rows > 1 || background.cols > 1)
+        && (background.rows != foreground.rows || background.cols != foreground.cols)) {
+        throw std::invalid_argument("The uploaded images have wrong size");
+    }
+
+    // центры структурных элементов совмещаются, как в HitOrMiss при выделении 1*1
+    const cv::Point center_foreground(foreground.cols / 2, foreground.rows / 2);
+    const cv::Point center_background(background.cols / 2, background.rows / 2);
+    const cv::Point shift_foreground(std::max(0, center_background.x - center_foreground.x),
+        std::max(0, center_background.y - center_foreground.y));
+    const cv::Point shift_background(std::max(0, center_foreground.x - center_background.x),
+        std::max(0, center_foreground.y - center_background.y));
+    const cv::Size size(
+        std::max(shift_foreground.x + foreground.cols, shift_background.x + background.cols),
+        std::max(shift_foreground.y + foreground.rows, shift_background.y + background.rows));
+
+    Pattern pattern;
+    pattern.element = StructuringElement::Combine(StructuringElement(foreground, true), shift_foreground,
+        StructuringElement(background, false), shift_background, size);
+    pattern.center = shift_foreground + center_foreground;
+    patterns_.push_back(pattern);
+
+    BuildTree();
+    return get_pattern_count() - 1;
+}
+
+void HitOrMissBank::BuildTree() {
+    probes_.clear();
+    nodes_.assign(1, Node());
+
+    // условия пар в смещениях от центра и частота каждого условия по всем парам
+    std::map<std::pair<int, int>, int> probe_index;
+    std::vector<std::vector<Condition>> conditions(patterns_.size());
+    std::map<std::pair<int, bool>, int> frequency;
+    for (size_t index = 0; index < patterns_.size(); index += 1) {
+        const Pattern& pattern = patterns_[index];
+        for (const CarePixel& pixel : pattern.element.get_care()) {
+            const std::pair<int, int> offset(pixel.row - pattern.center.y, pixel.col - pattern.center.x);
+            auto found = probe_index.find(offset);
+            if (found == probe_index.end()) {
+                found = probe_index.emplace(offset, static_cast<int>(probes_.size())).first;
+                probes_.emplace_back(offset.second, offset.first);
+            }
+            conditions[index].push_back({ found->second, pixel.black });
+            frequency[{ found->second, pixel.black }] += 1;
+        }
+    }
+
+    // частые условия проверяются первыми, чтобы у пар было больше общих префиксов
+    for (size_t index = 0; index < patterns_.size(); index += 1) {
+        std::sort(conditions[index].begin(), conditions[index].end(),
+            [&](const Condition& lhs, const Condition& rhs) {
+                const int lhs_frequency = frequency[{ lhs.probe, lhs.black }];
+                const int rhs_frequency = frequency[{ rhs.probe, rhs.black }];
+                if (lhs_frequency != rhs_frequency) return lhs_frequency > rhs_frequency;
+                if (lhs.probe != rhs.probe) return lhs.probe < rhs.probe;
+                return lhs.black && !rhs.black;
+            });
+
+        int node = 0;
+        for (const Condition& condition : conditions[index]) {
+            int next = -1;
+            for (int child : nodes_[node].children) {
+                if (nodes_[child].condition.probe == condition.probe && nodes_[child].condition.black == condition.black) {
+                    next = child;
+                    break;
+                }
+            }
+            if (next < 0) {
+                next = static_cast<int>(nodes_.size());
+                nodes_.push_back(Node());
+                nodes_.back().condition = condition;
+                nodes_[node].children.push_back(next);
+            }
+            node = next;
+        }
+        nodes_[node].patterns.push_back(static_cast<int>(index));
+    }
+
+    // окна 3*3 с центром (1, 1) у всех пар: одна таблица на весь набор
+    lookup_ = get_pattern_count() <= kMaxLookupPatterns;
+    for (const Pattern& pattern : patterns_) {
+        lookup_ = lookup_ && pattern.element.get_size() == cv::Size(kLookupSide, kLookupSide);
+    }
+    table_ = NeighborhoodTable();
+    if (lookup_) {
+        for (const Pattern& pattern : patterns_) {
+            table_.AddPattern(pattern.element);
+        }
+    }
+}
+
+std::vector<BitPlane> HitOrMissBank::Match(const cv::Mat& image) const {
+    if (image.empty()) {
+        throw std::invalid_argument("The uploaded image was empty");
+    }
+    CV_Assert(image.type() == CV_8UC1);
+
+    BitPlane plane(image.rows, image.cols);
+    for (int row = 0; row < image.rows; row += 1) {
+        plane.PackRow(row, image.ptr<uchar>(row), image.cols, kThresholdValue);
+    }
+
+    std::vector<BitPlane> hits(patterns_.size(), BitPlane(image.rows, image.cols));
+    const int words = plane.get_words_per_row();
+
+    // слово смещения читается один раз на положение и используется всеми парами
+    std::vector<uint64_t> values(probes_.size());
+    std::vector<int64_t> loaded(probes_.size(), -1);
+    std::vector<std::pair<int, uint64_t>> stack;
+    int64_t position = 0;
+    for (int row = 0; row < image.rows; row += 1) {
+        for (int word = 0; word < words; word += 1, position += 1) {
+            // обход дерева: 64 центра окна одновременно, поддерево отбрасывается,
+            // как только ни один из них не прошел условие узла
+            stack.emplace_back(0, ~uint64_t{ 0 });
+            while (!stack.empty()) {
+                const int node = stack.back().first;
+                const uint64_t mask = stack.back().second;
+                stack.pop_back();
+
+                for (int pattern : nodes_[node].patterns) {
+                    hits[pattern].Row(row)[word] = mask;
+                }
+                for (int child : nodes_[node].children) {
+                    const Condition& condition = nodes_[child].condition;
+                    if (loaded[condition.probe] != position) {
+                        const cv::Point& probe = probes_[condition.probe];
+                        values[condition.probe] = Probe(plane, row + probe.y, word * kWordBits + probe.x);
+                        loaded[condition.probe] = position;
+                    }
+                    const uint64_t value = values[condition.probe];
+                    const uint64_t next = mask & (condition.black ? value : ~value);
+                    if (next != 0) {
+                        stack.emplace_back(child, next);
+                    }
+                }
+            }
+        }
+    }
+
+    // окно пары должно целиком лежать в изображении
+    for (size_t index = 0; index < patterns_.size(); index += 1) {
+        const cv::Size& window = patterns_[index].element.get_size();
+        const cv::Point& center = patterns_[index].center;
+        const int first_col = center.x;
+        const int last_col = image.cols - window.width + center.x;
+        std::vector<uint64_t> columns(words, 0);
+        for (int col = first_col; col <= last_col; col += 1) {
+            columns[col / kWordBits] |= uint64_t{ 1 } << (col % kWordBits);
+        }
+        for (int row = 0; row < image.rows; row += 1) {
+            const bool fits = row >= center.y && row <= image.rows - window.height + center.y;
+            uint64_t* hits_row = hits[index].Row(row);
+            for (int word = 0; word < words; word += 1) {
+                hits_row[word] = fits ? hits_row[word] & columns[word] : 0;
+            }
+        }
+    }
+    return hits;
+}
+
+std::vector<cv::Mat> HitOrMissBank::DoHitMaps(const cv::Mat& image) const {
+    const std::vector<BitPlane> hits = Match(image);
+
+    std::vector<cv::Mat> maps(hits.size());
+    for (size_t index = 0; index < hits.size(); index += 1) {
+        hits[index].Unpack(maps[index]);
+    }
+    return maps;
+}
+
+cv::Mat HitOrMissBank::DoLabelMap(const cv::Mat& image) const {
+    // номеру нужна только первая попавшая пара: одно обращение к таблице на окно
+    // быстрее, чем карты всех пар с последующим обходом их битов
+    if (lookup_ && !image.empty()) {
+        CV_Assert(image.type() == CV_8UC1);
+        cv::Mat labels{ image.rows, image.cols, CV_32SC1, cv::Scalar(0) };
+        table_.Scan(image, 0, image.rows - kLookupSide + 1, [&](int row, int col, uint64_t mask) {
+            if (mask == 0) return;
+            int index = 0;
+            while (((mask >> index) & 1) == 0) index += 1;
+            labels.at<int>(row + 1, col + 1) = index + 1;
+        });
+        return labels;
+    }
+
+    const std::vector<BitPlane> hits = Match(image);
+
+    // пары с меньшим номером записываются последними и перекрывают остальные
+    cv::Mat labels{ image.rows, image.cols, CV_32SC1, cv::Scalar(0) };
+    for (int index = static_cast<int>(hits.size()) - 1; index >= 0; index -= 1) {
+        for (int row = 0; row < image.rows; row += 1) {
+            const uint64_t* hits_row = hits[index].Row(row);
+            int* labels_row = labels.ptr<int>(row);
+            for (int word = 0; word < hits[index].get_words_per_row(); word += 1) {
+                for (uint64_t bits = hits_row[word]; bits != 0; bits &= bits - 1) {
+                    int bit = 0;
+                    while (((bits >> bit) & 1) == 0) bit += 1;
+                    labels_row[word * kWordBits + bit] = index + 1;
+                }
+            }
+        }
+    }
+    return labels;
+}
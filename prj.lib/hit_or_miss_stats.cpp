@@ -0,0 +1,83 @@
+#include<hitOrMiss/hit_or_miss_stats.hpp>
+
+#include <fstream>
+#include <sstream>
+
+HitOrMissStats::HitOrMissStats() : origin_(Clock::now()) {}
+
+void HitOrMissStats::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    origin_ = Clock::now();
+    counters_ = Counters();
+    stages_.clear();
+    spans_.clear();
+    threads_.clear();
+}
+
+void HitOrMissStats::AddCounters(const Counters& counters) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_.windows_tested += counters.windows_tested;
+    counters_.pixels_compared += counters.pixels_compared;
+    counters_.hits += counters.hits;
+    counters_.bytes_allocated += counters.bytes_allocated;
+    for (int depth = 0; depth < kDepthBins; depth += 1) {
+        counters_.exit_depth[depth] += counters.exit_depth[depth];
+    }
+}
+
+void HitOrMissStats::AddSpan(const char* name, Clock::time_point begin, Clock::time_point end) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stage& stage = stages_[name];
+    stage.calls += 1;
+    stage.seconds += std::chrono::duration<double>(end - begin).count();
+
+    if (spans_.size() >= kMaxSpans) {
+        return;
+    }
+    const auto thread = threads_.emplace(std::this_thread::get_id(), static_cast<int>(threads_.size())).first;
+    Span span;
+    span.name = name;
+    span.thread = thread->second;
+    span.begin_us = std::chrono::duration<double, std::micro>(begin - origin_).count();
+    span.duration_us = std::chrono::duration<double, std::micro>(end - begin).count();
+    spans_.push_back(span);
+}
+
+HitOrMissStats::Counters HitOrMissStats::get_counters() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return counters_;
+}
+
+std::map<std::string, HitOrMissStats::Stage> HitOrMissStats::get_stages() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stages_;
+}
+
+std::vector<HitOrMissStats::Span> HitOrMissStats::get_spans() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return spans_;
+}
+
+std::string HitOrMissStats::ChromeTrace() const {
+
+    // полные события ("ph": "X"): вложенные стадии одного потока рисуются друг под другом
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream trace;
+    trace.setf(std::ios::fixed);
+    trace.precision(3);
+    trace << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    for (size_t index = 0; index < spans_.size(); index += 1) {
+        const Span& span = spans_[index];
+        trace << (index == 0 ? "\n" : ",\n")
+            << "{\"name\": \"" << span.name << "\", \"cat\": \"hitOrMiss\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+            << span.thread << ", \"ts\": " << span.begin_us << ", \"dur\": " << span.duration_us << "}";
+    }
+    trace << "\n]}\n";
+    return trace.str();
+}
+
+bool HitOrMissStats::WriteChromeTrace(const std::string& path) const {
+    std::ofstream file(path);
+    file << ChromeTrace();
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,115 @@
+#include<hitOrMiss/hit_or_miss_stream.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+HitOrMissStream::HitOrMissStream(int cols, const HitOrMiss& settings, Output output, RowHandler handler)
+    : cols_(cols), output_(output), handler_(std::move(handler)) {
+    if (cols_ <= 0) {
+        throw std::invalid_argument("The row width must be positive");
+    }
+    if (!handler_) {
+        throw std::invalid_argument("The row handler is empty");
+    }
+    // окна за верхним краем закрашивают строки, уже выданные к их завершению
+    if (settings.get_border_mode() != HitOrMiss::BorderMode::kNone) {
+        throw std::invalid_argument("The row stream supports only BorderMode::kNone");
+    }
+
+    // структурные элементы в HitOrMiss уже проверены и бинаризованы
+    const cv::Mat& kernel_foreground = settings.get_kernel_foreground();
+    const cv::Mat& kernel_background = settings.get_kernel_background();
+    foreground_ = StructuringElement(kernel_foreground, true);
+    background_ = StructuringElement(kernel_background, false);
+    offsets_foreground_ = settings.HighlightOffsets(kernel_foreground.size());
+    offsets_background_ = settings.HighlightOffsets(kernel_background.size());
+    window_rows_ = std::max(kernel_foreground.rows, kernel_background.rows);
+
+    image_ring_.Create(2 * window_rows_, cols_);
+    hits_foreground_.Create(2 * window_rows_, cols_);
+    hits_background_.Create(2 * window_rows_, cols_);
+    stamp_foreground_.Create(2 * window_rows_, cols_);
+    stamp_background_.Create(2 * window_rows_, cols_);
+    row_binary_.create(1, cols_, CV_8UC1);
+    row_output_.create(1, cols_, CV_8UC1);
+}
+
+void HitOrMissStream::PushRow(const cv::Mat& row) {
+    if (row.type() != CV_8UC1 || row.rows != 1 || row.cols != cols_) {
+        throw std::invalid_argument("The pushed row has wrong size or type");
+    }
+
+    cv::threshold(row, row_binary_, kThresholdValue, kWhite, cv::THRESH_BINARY);
+    const int slot = rows_pushed_ % window_rows_;
+    image_ring_.PackRow(slot, row_binary_.ptr<uchar>(0));
+    Mirror(image_ring_, slot);
+    rows_pushed_ += 1;
+
+    // окна с верхней строкой top завершены, и строку top больше не закрасит ни одно окно
+    const int top = rows_pushed_ - window_rows_;
+    if (top >= 0) {
+        MatchRow(top, rows_pushed_);
+        EmitRow(top);
+    }
+}
+
+void HitOrMissStream::Finish() {
+    // окна, не поместившиеся в изображение, не попадают, но их строки кольца нужно очистить
+    for (int top = std::max(0, rows_pushed_ - window_rows_ + 1); top < rows_pushed_; top += 1) {
+        MatchRow(top, rows_pushed_);
+        EmitRow(top);
+    }
+
+    rows_pushed_ = 0;
+    rows_emitted_ = 0;
+    image_ring_.Create(2 * window_rows_, cols_);
+    hits_foreground_.Create(2 * window_rows_, cols_);
+    hits_background_.Create(2 * window_rows_, cols_);
+}
+
+void HitOrMissStream::MatchRow(int top, int rows) {
+    const int slot = top % window_rows_;
+    const int words = hits_foreground_.get_words_per_row();
+
+    // строки top..top + window_rows_ - 1 лежат в кольце начиная со слота slot
+    std::fill(hits_foreground_.Row(slot), hits_foreground_.Row(slot) + words, 0);
+    if (top + foreground_.get_size().height <= rows) {
+        BitPlane::Match(image_ring_, foreground_, cv::Point(0, 0), slot, slot + 1, hits_foreground_);
+    }
+    Mirror(hits_foreground_, slot);
+
+    std::fill(hits_background_.Row(slot), hits_background_.Row(slot) + words, 0);
+    if (top + background_.get_size().height <= rows) {
+        BitPlane::Match(image_ring_, background_, cv::Point(0, 0), slot, slot + 1, hits_background_);
+    }
+    Mirror(hits_background_, slot);
+}
+
+void HitOrMissStream::EmitRow(int row) {
+    // строку закрашивают окна с верхними строками row - window_rows_ + 1..row, они лежат
+    // в кольце попаданий подряд перед второй копией строки row
+    const int slot = row % window_rows_ + window_rows_;
+    const int words = stamp_foreground_.get_words_per_row();
+
+    std::fill(stamp_foreground_.Row(slot), stamp_foreground_.Row(slot) + words, 0);
+    std::fill(stamp_background_.Row(slot), stamp_background_.Row(slot) + words, 0);
+    BitPlane::Stamp(hits_foreground_, offsets_foreground_, slot, slot + 1, stamp_foreground_);
+    BitPlane::Stamp(hits_background_, offsets_background_, slot, slot + 1, stamp_background_);
+
+    uint64_t* result = stamp_foreground_.Row(slot);
+    const uint64_t* background = stamp_background_.Row(slot);
+    const uint64_t* image = image_ring_.Row(slot);
+    for (int word = 0; word < words; word += 1) {
+        const uint64_t hit = result[word] & background[word];
+        result[word] = output_ == Output::kBoundary ? image[word] & ~hit : hit;
+    }
+
+    stamp_foreground_.UnpackRow(slot, row_output_.ptr<uchar>(0));
+    rows_emitted_ += 1;
+    handler_(row, row_output_);
+}
+
+void HitOrMissStream::Mirror(BitPlane& ring, int slot) const {
+    std::copy(ring.Row(slot), ring.Row(slot) + ring.get_words_per_row(), ring.Row(slot + window_rows_));
+}
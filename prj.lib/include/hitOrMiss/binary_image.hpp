@@ -0,0 +1,98 @@
+﻿/**
+* @file binary_image.hpp
+* @brief Бинарное изображение CV_8UC1 со значениями 0 и 255
+*
+* Обертка хранит инвариант "изображение уже бинарное", поэтому HitOrMiss
+* принимает его без повторной пороговой обработки. Преобразование из цветного,
+* 16-битного или вещественного изображения и бинаризация выполняются за один проход
+* в собственную память обертки, переданное изображение не изменяется.
+*
+* @author Kiselev K.A.
+* @date 17.10.2026
+*/
+
+#pragma once
+#ifndef HITORMISS_BINARY_IMAGE_HPP_20261017
+#define HITORMISS_BINARY_IMAGE_HPP_20261017
+
+#include <opencv2/opencv.hpp>
+
+/**
+* @brief Изображение CV_8UC1, все пиксели которого равны 0 или 255
+*
+* Пиксель становится белым (255), если его значение больше порога, иначе черным (0),
+* как у cv::THRESH_BINARY. Цветное изображение (BGR) предварительно переводится в оттенки
+* серого по тем же коэффициентам, что и cv::COLOR_BGR2GRAY.
+* Копирование разделяет данные, как у cv::Mat.
+*/
+class BinaryImage {
+public:
+    /**
+    * @brief Конструктор по умолчанию: пустое изображение
+    */
+    BinaryImage() = default;
+
+    /**
+    * @brief Бинаризация с порогом по умолчанию для глубины изображения (см. DefaultThreshold)
+    * @param[in] src изображение CV_8UC1, CV_8UC3, CV_16UC1 или CV_32FC1
+    */
+    explicit BinaryImage(const cv::Mat& src);
+
+    /**
+    * @brief Бинаризация с заданным порогом
+    * @param[in] src изображение CV_8UC1, CV_8UC3, CV_16UC1 или CV_32FC1
+    * @param[in] threshold порог в единицах src
+    */
+    BinaryImage(const cv::Mat& src, double threshold);
+
+    /**
+    * @brief Обертка над уже бинарным изображением без копирования и без пороговой обработки
+    *
+    * Бинарность проверяется только в отладочной сборке (без NDEBUG, CV_Assert).
+    * Данные разделяются с binary, поэтому его нельзя менять, пока обертка используется
+    * @param[in] binary изображение CV_8UC1 со значениями 0 и 255
+    */
+    static BinaryImage FromBinary(const cv::Mat& binary);
+
+    /**
+    * @brief Перебинаризовать src с порогом по умолчанию (см. Assign(const cv::Mat&, double))
+    */
+    void Assign(const cv::Mat& src);
+
+    /**
+    * @brief Перебинаризовать src в собственную память обертки
+    *
+    * Память переиспользуется, если размер не изменился; изображение,
+    * полученное через FromBinary, не перезаписывается
+    * @param[in] src изображение CV_8UC1, CV_8UC3, CV_16UC1 или CV_32FC1
+    * @param[in] threshold порог в единицах src
+    */
+    void Assign(const cv::Mat& src, double threshold);
+
+    /**
+    * @brief Порог по умолчанию: середина диапазона глубины
+    * (127 для 8 бит, 32767 для 16 бит, 0.5 для вещественных значений из [0, 1])
+    */
+    static double DefaultThreshold(int depth);
+
+    /**
+    * @brief Проверка, что изображение CV_8UC1 и все его пиксели равны 0 или 255
+    */
+    static bool IsBinary(const cv::Mat& image);
+
+    /**
+    * @brief getter: бинарное изображение CV_8UC1
+    */
+    const cv::Mat& get_image() const { return image_; }
+
+    /**
+    * @brief Изображение не задано
+    */
+    bool empty() const { return image_.empty(); }
+
+private:
+    cv::Mat image_; // бинарное изображение
+    bool owned_ = true; // память принадлежит обертке и может перезаписываться в Assign
+};
+
+#endif
@@ -0,0 +1,242 @@
+﻿/**
+* @file bit_plane.hpp
+* @brief Упакованное бинарное изображение и движок Hit or Miss над ним
+*
+* Изображение хранится по 1 биту на пиксель, строки выровнены на 64-битные слова.
+* Проход структурным элементом проверяет сразу 64 положения окна за одну
+* операцию со словом (сдвиги, and, and not по строкам структурного элемента).
+*
+* @author Kiselev K.A.
+* @date 17.10.2026
+*/
+
+#pragma once
+#ifndef HITORMISS_BIT_PLANE_HPP_20261017
+#define HITORMISS_BIT_PLANE_HPP_20261017
+
+#include <cstdint>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include<hitOrMiss/structuring_element.hpp>
+
+/**
+* @brief Бинарное изображение, упакованное по 1 биту на пиксель
+*
+* Бит пикселя (row, col) - бит col % 64 слова col / 64 строки row.
+* Установленный бит соответствует черному пикселю (логической 1),
+* сброшенный - белому. Каждая строка дополнена до целого числа слов
+* и одним защитным нулевым словом, поэтому чтение 64 бит с любого
+* пикселя строки не выходит за ее пределы. Биты за последним столбцом всегда нулевые.
+*/
+class BitPlane {
+public:
+    /**
+    * @brief Конструктор по умолчанию: пустое изображение 0*0
+    */
+    BitPlane() = default;
+
+    /**
+    * @brief Конструктор белого (обнуленного) изображения
+    * @param[in] rows количество строк
+    * @param[in] cols количество столбцов
+    */
+    BitPlane(int rows, int cols);
+
+    /**
+    * @brief Пересоздать изображение заданного размера, заполненное белым
+    * @param[in] rows количество строк
+    * @param[in] cols количество столбцов
+    */
+    void Create(int rows, int cols);
+
+    /**
+    * @brief Упаковать бинарное изображение CV_8UC1 (черный пиксель - 0)
+    * @param[in] src бинарное изображение
+    * @return упакованное изображение
+    */
+    static BitPlane Pack(const cv::Mat& src);
+
+    /**
+    * @brief Упаковать бинарное изображение CV_8UC1 в уже существующее (память переиспользуется)
+    * @param[in] src бинарное изображение
+    * @param[out] dst упакованное изображение, пересоздается под размер src
+    */
+    static void Pack(const cv::Mat& src, BitPlane& dst);
+
+    /**
+    * @brief Распаковать в изображение CV_8UC1 (0 - черный, 255 - белый)
+    * @param[out] dst изображение, пересоздается под размер упакованного
+    */
+    void Unpack(cv::Mat& dst) const;
+
+    /**
+    * @brief Упаковать одну строку бинарного изображения (черный пиксель - 0)
+    * @param[in] row строка упакованного изображения
+    * @param[in] pixels get_cols() пикселей строки
+    */
+    void PackRow(int row, const uchar* pixels);
+
+    /**
+    * @brief Упаковать первые count пикселей строки с бинаризацией, остальные пиксели строки белые
+    *
+    * Пиксель черный, если его значение не больше threshold (как после cv::threshold с THRESH_BINARY)
+    * @param[in] row строка упакованного изображения
+    * @param[in] pixels count пикселей строки (count <= get_cols())
+    * @param[in] count количество пикселей
+    * @param[in] threshold порог бинаризации
+    */
+    void PackRow(int row, const uchar* pixels, int count, int threshold);
+
+    /**
+    * @brief Перепаковать прямоугольник изображения (целиком слова, которые он задевает)
+    * @param[in] src бинарное изображение CV_8UC1 того же размера, что и упакованное
+    * @param[in] region прямоугольник внутри изображения
+    */
+    void PackRegion(const cv::Mat& src, const cv::Rect& region);
+
+    /**
+    * @brief Распаковать одну строку (0 - черный, 255 - белый)
+    * @param[in] row строка упакованного изображения
+    * @param[out] pixels get_cols() пикселей строки
+    */
+    void UnpackRow(int row, uchar* pixels) const;
+
+    /**
+    * @brief Пересечение множеств черных пикселей (this = this and rhs)
+    */
+    void And(const BitPlane& rhs);
+
+    /**
+    * @brief Вычитание множеств черных пикселей (this = this and not rhs)
+    */
+    void AndNot(const BitPlane& rhs);
+
+    /**
+    * @brief Проход по изображению структурным элементом
+    *
+    * Бит (row, col) результата установлен, если окно структурного элемента
+    * с левым верхним углом в (row, col) целиком лежит в изображении и все значимые
+    * пиксели совпали
+    * @param[in] image упакованное изображение
+    * @param[in] element скомпилированный структурный элемент
+    * @param[out] hits карта попаданий по левым верхним углам окон
+    */
+    static void Match(const BitPlane& image, const StructuringElement& element, BitPlane& hits);
+
+    /**
+    * @brief Проход по полосе строк [row_begin, row_end) левых верхних углов окон
+    *
+    * Бит (row + offset.y, col + offset.x) результата устанавливается, если окно структурного
+    * элемента с левым верхним углом в (row, col) целиком лежит в изображении и все значимые
+    * пиксели совпали. Пиксели проверяются в порядке элемента, проверка 64 окон прекращается,
+    * как только все они не совпали (сплошной прямоугольник проходится SeparableErosion).
+    * Читает строки изображения [row_begin, row_end + rows - 1) и пишет только строки полосы,
+    * сдвинутые на offset.y, поэтому разные полосы можно обрабатывать параллельно
+    * @param[in] image упакованное изображение
+    * @param[in] element скомпилированный структурный элемент
+    * @param[in] offset смещение записываемого бита от левого верхнего угла окна (внутри окна)
+    * @param[out] dst результат, уже созданный под размер image
+    */
+    static void Match(const BitPlane& image, const StructuringElement& element, const cv::Point& offset,
+        int row_begin, int row_end, BitPlane& dst);
+
+    /**
+    * @brief Проход по прямоугольнику windows левых верхних углов окон
+    *
+    * Как проход по полосе строк [windows.y, windows.y + windows.height), но проверяются только слова,
+    * в которые попадают столбцы [windows.x, windows.x + windows.width). Остальные положения окна
+    * этих слов тоже проверяются и пишутся (их результат верен), за пределами слов результат не меняется
+    * @param[in] image упакованное изображение
+    * @param[in] element скомпилированный структурный элемент
+    * @param[in] offset смещение записываемого бита от левого верхнего угла окна (внутри окна)
+    * @param[in] windows прямоугольник левых верхних углов окон
+    * @param[out] dst результат, уже созданный под размер image
+    */
+    static void Match(const BitPlane& image, const StructuringElement& element, const cv::Point& offset,
+        const cv::Rect& windows, BitPlane& dst);
+
+    /**
+    * @brief Закрасить черным пиксели [col_begin, col_end) строки row
+    */
+    void Fill(int row, int col_begin, int col_end);
+
+    /**
+    * @brief Выделение попаданий
+    *
+    * Для каждого попадания в hits закрашивает пиксели, смещенные от левого
+    * верхнего угла окна на offsets
+    * @param[in] hits карта попаданий по левым верхним углам окон
+    * @param[in] offsets смещения закрашиваемых пикселей (x - столбец, y - строка)
+    * @param[out] dst результат, пересоздается под размер hits
+    */
+    static void Stamp(const BitPlane& hits, const std::vector<cv::Point>& offsets, BitPlane& dst);
+
+    /**
+    * @brief Выделение попаданий в полосе строк [row_begin, row_end) результата
+    *
+    * Каждая строка результата собирается из строк hits выше нее, запись идет
+    * только в строки полосы, поэтому разные полосы можно обрабатывать параллельно
+    * @param[out] dst результат, уже созданный под размер hits
+    */
+    static void Stamp(const BitPlane& hits, const std::vector<cv::Point>& offsets,
+        int row_begin, int row_end, BitPlane& dst);
+
+    /**
+    * @brief getter: количество строк
+    */
+    int get_rows() const { return rows_; }
+
+    /**
+    * @brief getter: количество столбцов
+    */
+    int get_cols() const { return cols_; }
+
+    /**
+    * @brief getter: количество слов в строке (без защитного слова)
+    */
+    int get_words_per_row() const { return words_per_row_; }
+
+    /**
+    * @brief getter: размер данных в байтах (с защитными словами)
+    */
+    size_t get_bytes() const { return words_.size() * sizeof(uint64_t); }
+
+    /**
+    * @brief Указатель на начало строки
+    */
+    uint64_t* Row(int row) { return words_.data() + static_cast<size_t>(row) * stride_; }
+
+    /**
+    * @brief Указатель на начало строки
+    */
+    const uint64_t* Row(int row) const { return words_.data() + static_cast<size_t>(row) * stride_; }
+
+    /**
+    * @brief 64 бита строки, начиная с пикселя bit (bit >= 0, bit < cols)
+    */
+    static uint64_t Extract(const uint64_t* row, int bit) {
+        const int word = bit >> 6;
+        const int shift = bit & 63;
+        if (shift == 0) {
+            return row[word];
+        }
+        return (row[word] >> shift) | (row[word + 1] << (64 - shift));
+    }
+
+private:
+    // Маска значимых битов последнего слова строки
+    uint64_t TailMask() const;
+
+    // Упаковать слова [word_begin, word_end) строки (как PackRow)
+    void PackWords(int row, const uchar* pixels, int count, int threshold, int word_begin, int word_end);
+
+private:
+    int rows_ = 0; // количество строк
+    int cols_ = 0; // количество столбцов
+    int words_per_row_ = 0; // количество слов под пиксели строки
+    int stride_ = 0; // шаг между строками в словах (с защитным словом)
+    std::vector<uint64_t> words_; // данные построчно
+};
+
+#endif
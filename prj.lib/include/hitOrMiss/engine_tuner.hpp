@@ -0,0 +1,135 @@
+﻿/**
+* @file engine_tuner.hpp
+* @brief Выбор самого быстрого движка Hit or Miss замером
+*
+* Какой движок быстрее, зависит от размера и разреженности структурных элементов
+* и от заполненности изображения. При движке HitOrMiss::Engine::kAuto первый проход
+* для нового сочетания структурных элементов, размера изображения и количества потоков
+* замеряет все подходящие движки на текущем изображении, а победитель запоминается
+* в памяти и, если задан файл профиля, на диске.
+*
+* @author Kiselev K.A.
+* @date 17.10.2026
+*/
+
+#pragma once
+#ifndef HITORMISS_ENGINE_TUNER_HPP_20261017
+#define HITORMISS_ENGINE_TUNER_HPP_20261017
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include<hitOrMiss/hit_or_miss.hpp>
+
+/**
+* @brief Настройщик: запоминает самый быстрый движок для каждой сигнатуры параметров
+*
+* Сигнатура - структурные элементы, выделение при попадании, размер изображения и количество потоков.
+* Методы можно вызывать из нескольких потоков одновременно
+*/
+class EngineTuner {
+public:
+    /**
+    * @brief Конструктор: профиль только в памяти
+    */
+    EngineTuner() = default;
+
+    /**
+    * @brief Конструктор с файлом профиля (см. set_profile_path)
+    */
+    explicit EngineTuner(const std::string& profile_path);
+
+    /**
+    * @brief Настройщик, общий для процесса (им пользуются объекты HitOrMiss по умолчанию)
+    */
+    static std::shared_ptr<EngineTuner> Shared();
+
+    /**
+    * @brief Движок для параметров hit_or_miss: из профиля или, если сигнатура новая, по замеру
+    *
+    * Каждый подходящий движок обрабатывает текущее изображение копией hit_or_miss
+    * (set_image и DoHitOrMiss, как для очередного кадра) дважды, время - меньшее из двух.
+    * Движок, проигравший с первого прохода больше чем в kGiveUpRatio раз, второй раз не замеряется
+    * @param[in] hit_or_miss объект с изображением и структурными элементами
+    * @return самый быстрый движок
+    * @throw logic_error если включена проверка и движки дали разные результаты
+    */
+    HitOrMiss::Engine Select(const HitOrMiss& hit_or_miss);
+
+    /**
+    * @brief Движки, из которых выбирается самый быстрый (kOpenCv - только при выделении 1*1)
+    */
+    static std::vector<HitOrMiss::Engine> Candidates(const HitOrMiss& hit_or_miss);
+
+    /**
+    * @brief Сигнатура параметров hit_or_miss (строка без пробелов)
+    */
+    static std::string Signature(const HitOrMiss& hit_or_miss);
+
+    /**
+    * @brief Найти движок для сигнатуры в профиле
+    * @return false, если сигнатура еще не замерялась
+    */
+    bool Find(const std::string& signature, HitOrMiss::Engine& engine) const;
+
+    /**
+    * @brief Количество сигнатур в профиле
+    */
+    size_t size() const;
+
+    /**
+    * @brief setter: сверять результаты всех движков при замере
+    *
+    * По умолчанию включено в отладочной сборке (без NDEBUG)
+    */
+    void set_verify(bool verify);
+
+    /**
+    * @brief getter: сверять результаты всех движков при замере
+    */
+    bool get_verify() const;
+
+    /**
+    * @brief setter: файл профиля
+    *
+    * Записи из файла, если он есть, добавляются к профилю, и после каждого нового замера
+    * профиль записывается в файл целиком. Пустой путь - профиль только в памяти
+    * @param[in] profile_path путь к текстовому файлу: строки "движок сигнатура"
+    */
+    void set_profile_path(const std::string& profile_path);
+
+    /**
+    * @brief Записать профиль в файл
+    * @return false, если файл не записался
+    */
+    bool Save(const std::string& path) const;
+
+    /**
+    * @brief Имя движка в профиле
+    */
+    static const char* EngineName(HitOrMiss::Engine engine);
+
+    static constexpr double kGiveUpRatio = 4; /**< во сколько раз медленнее лучшего движок перестает замеряться */
+
+private:
+    // Добавить записи из файла профиля
+    void Load(const std::string& path);
+
+    // Записать профиль в файл (mutex_ захвачен)
+    bool SaveLocked(const std::string& path) const;
+
+private:
+    mutable std::mutex mutex_; // доступ к профилю и параметрам
+    std::map<std::string, HitOrMiss::Engine> profile_; // движок для каждой сигнатуры
+    std::string profile_path_; // файл профиля (пустой - только в памяти)
+#ifdef NDEBUG
+    bool verify_ = false; // сверять результаты движков
+#else
+    bool verify_ = true; // сверять результаты движков
+#endif
+};
+
+#endif
@@ -0,0 +1,62 @@
+﻿/**
+* @file fixed_size_matching.hpp
+* @brief Проход структурными элементами частых размеров, специализированный при компиляции
+*
+* Для размеров окна от 1*1 до 7*7 и нечетных квадратов от 9*9 до 21*21 проход
+* инстанцируется шаблоном с размером окна в параметрах. Строка окна из значимых
+* пикселей переводится в маску и требуемые значения по 8 байт, и строка изображения
+* сравнивается с ней одной операцией на 8 пикселей. Количество строк и слов известно
+* компилятору, поэтому циклы по окну разворачиваются, а маски остаются в регистрах.
+* Нужная специализация выбирается по таблице размеров.
+*
+* @author Kiselev K.A.
+* @date 17.10.2026
+*/
+
+#pragma once
+#ifndef HITORMISS_FIXED_SIZE_MATCHING_HPP_20261017
+#define HITORMISS_FIXED_SIZE_MATCHING_HPP_20261017
+
+#include <opencv2/opencv.hpp>
+
+#include<hitOrMiss/structuring_element.hpp>
+
+/**
+* @brief Проход элементом, размер окна которого есть в таблице специализаций
+*
+* Результат совпадает с проходом по списку значимых пикселей.
+*/
+class FixedSizeMatching {
+public:
+    /**
+    * @brief Проход специализации для полосы строк (сигнатура Match)
+    */
+    using BandMatcher = void (*)(const cv::Mat& image, const StructuringElement& element,
+        int row_begin, int row_end, cv::Mat& hits);
+
+    /**
+    * @brief Специализация для размера окна
+    * @return nullptr, если размера нет в таблице
+    */
+    static BandMatcher Find(const cv::Size& size);
+
+    /**
+    * @brief Для размера окна элемента есть специализация
+    */
+    static bool Supports(const StructuringElement& element) { return Find(element.get_size()) != nullptr; }
+
+    /**
+    * @brief Проход по бинарному изображению CV_8UC1 (0 и 255) для полосы строк [row_begin, row_end)
+    * левых верхних углов окон
+    *
+    * Пишет только строки полосы, поэтому разные полосы можно обрабатывать параллельно
+    * @param[in] image бинарное изображение
+    * @param[in] element элемент, для которого Supports() == true
+    * @param[out] hits карта попаданий CV_8UC1 (1 - попадание, 0 - нет) размера
+    * (image.rows - rows + 1) * (image.cols - cols + 1), уже созданная
+    */
+    static void Match(const cv::Mat& image, const StructuringElement& element,
+        int row_begin, int row_end, cv::Mat& hits);
+};
+
+#endif
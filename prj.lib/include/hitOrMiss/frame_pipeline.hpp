@@ -0,0 +1,142 @@
+﻿/**
+* @file frame_pipeline.hpp
+* @brief Конвейерная обработка последовательности кадров алгоритмом Hit or Miss
+*
+* Чтение, бинаризация, проход структурными элементами и выдача результата выполняются
+* в разных потоках и соединены ограниченными очередями, поэтому кадры обрабатываются
+* одновременно на разных стадиях и скорость определяется самой медленной стадией,
+* а не суммой всех. Кадры лежат в постоянном наборе буферов, которые переходят
+* от стадии к стадии и переиспользуются.
+*
+* @author Kiselev K.A.
+* @date 17.10.2026
+*/
+
+#pragma once
+#ifndef HITORMISS_FRAME_PIPELINE_HPP_20261017
+#define HITORMISS_FRAME_PIPELINE_HPP_20261017
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include<hitOrMiss/binary_image.hpp>
+#include<hitOrMiss/hit_or_miss.hpp>
+
+/**
+* @brief Конвейер кадров: чтение -> бинаризация -> Hit or Miss -> выдача
+*
+* Чтение, бинаризация и проход идут каждый в своем потоке, выдача (обработчик результата) -
+* в потоке, вызвавшем Run. Кадров в обработке одновременно не больше размера очереди.
+* После заполнения буферов кадры не выделяют память, если ее не выделяют чтение
+* (cv::VideoCapture::read переиспользует кадр, cv::imread - нет) и обработчик.
+*/
+class FramePipeline {
+public:
+    /**
+    * @brief Что выдается для кадра
+    */
+    enum class Output {
+        kHitOrMiss, /**< результат HitOrMiss::DoHitOrMiss */
+        kBoundary /**< результат HitOrMiss::DoBoundaryExtraction */
+    };
+
+    /**
+    * @brief Чтение следующего кадра в frame (память кадра можно переиспользовать)
+    *
+    * Кадр CV_8UC1, CV_8UC3 (BGR), CV_16UC1 или CV_32FC1 (см. BinaryImage). false - кадры закончились
+    */
+    using Reader = std::function<bool(cv::Mat& frame)>;
+
+    /**
+    * @brief Обработчик результата: номер кадра и результат (действителен только во время вызова)
+    */
+    using FrameHandler = std::function<void(int index, const cv::Mat& result)>;
+
+    /**
+    * @brief Статистика стадии
+    */
+    struct StageStats {
+        int frames = 0; /**< обработано кадров */
+        double busy_seconds = 0; /**< время работы без ожидания очередей */
+
+        /**
+        * @brief Пропускная способность стадии (кадров в секунду работы)
+        */
+        double Fps() const { return busy_seconds > 0 ? frames / busy_seconds : 0; }
+    };
+
+    /**
+    * @brief Статистика прогона
+    */
+    struct Stats {
+        StageStats decode; /**< чтение кадров */
+        StageStats binarize; /**< бинаризация */
+        StageStats match; /**< Hit or Miss или извлечение границ */
+        StageStats encode; /**< обработчик результата */
+        int frames = 0; /**< кадров от начала до конца */
+        double seconds = 0; /**< время прогона */
+
+        /**
+        * @brief Скорость от чтения до выдачи (кадров в секунду)
+        */
+        double Fps() const { return seconds > 0 ? frames / seconds : 0; }
+    };
+
+    static constexpr int kDefaultQueueSize = 4; /**< кадров в обработке по умолчанию */
+
+public:
+    /**
+    * @brief Конструктор
+    * @param[in] settings структурные элементы, движок, режим границы и количество потоков прохода
+    * берутся из копии этого объекта (изображение не используется)
+    * @param[in] output что выдавать для кадра
+    * @param[in] queue_size количество кадров в обработке одновременно
+    * @throw invalid_argument если размер очереди меньше 1
+    */
+    FramePipeline(const HitOrMiss& settings, Output output, int queue_size = kDefaultQueueSize);
+
+    /**
+    * @brief Обработать все кадры reader
+    *
+    * Обработчик вызывается по порядку кадров в потоке, вызвавшем Run. Исключение любой стадии
+    * останавливает конвейер и передается из Run после остановки всех потоков
+    * @param[in] reader чтение кадров (вызывается в потоке чтения)
+    * @param[in] handler обработчик результатов
+    * @return статистика стадий
+    */
+    Stats Run(const Reader& reader, const FrameHandler& handler);
+
+    /**
+    * @brief Обработать кадры видео до конца
+    */
+    Stats Run(cv::VideoCapture& capture, const FrameHandler& handler);
+
+    /**
+    * @brief Обработать последовательность изображений (читаются cv::imread в оттенках серого)
+    * @throw invalid_argument если изображение не прочиталось
+    */
+    Stats Run(const std::vector<std::string>& paths, const FrameHandler& handler);
+
+    /**
+    * @brief getter: объект, выполняющий проход
+    */
+    const HitOrMiss& get_hit_or_miss() const { return hit_or_miss_; }
+
+private:
+    // Кадр в обработке: буферы всех стадий
+    struct Frame {
+        int index = 0; // номер кадра
+        cv::Mat decoded; // прочитанный кадр
+        BinaryImage binary; // бинаризованный кадр
+        cv::Mat result; // результат прохода
+    };
+
+private:
+    HitOrMiss hit_or_miss_; // проход структурными элементами (только в потоке прохода)
+    Output output_; // что выдавать для кадра
+    std::vector<Frame> frames_; // буферы кадров, переиспользуются между прогонами
+};
+
+#endif
@@ -0,0 +1,61 @@
+﻿/**
+* @file fused_boundary.hpp
+* @brief Извлечение границ бинарного изображения за один проход
+*
+* Граница по окрестности 3*3 (8-связность) или крестом (4-связность) находится
+* без Hit or Miss и вычитания: каждый пиксель результата определяется по трем
+* соседним строкам изображения, которые читаются один раз.
+*
+* @author Kiselev K.A.
+* @date 17.10.2026
+*/
+
+#pragma once
+#ifndef HITORMISS_FUSED_BOUNDARY_HPP_20261017
+#define HITORMISS_FUSED_BOUNDARY_HPP_20261017
+
+#include <opencv2/opencv.hpp>
+
+/**
+* @brief Внутренняя и внешняя границы бинарного изображения CV_8UC1
+*
+* Черный пиксель (0) - пиксель объекта, за краем изображения - белый фон.
+* Внутренняя граница совпадает с извлечением границ Hit or Miss с черным элементом 3*3
+* (или крестом 3*3) и выделением центра.
+*/
+class FusedBoundary {
+public:
+    /**
+    * @brief Вид границы
+    */
+    enum class Type {
+        kInner, /**< черные пиксели, у которых есть белый сосед */
+        kOuter /**< белые пиксели, у которых есть черный сосед */
+    };
+
+    /**
+    * @brief Соседи пикселя
+    */
+    enum class Connectivity {
+        kFour, /**< по стороне (крест 3*3) */
+        kEight /**< по стороне или углу (квадрат 3*3) */
+    };
+
+public:
+    /**
+    * @brief Граница изображения
+    * @param[in] image бинарное изображение CV_8UC1
+    * @param[out] dst граница (черные пиксели), пересоздается под размер image, если нужно;
+    * не должен разделять данные с image
+    */
+    static void Extract(const cv::Mat& image, Type type, Connectivity connectivity, cv::Mat& dst);
+
+    /**
+    * @brief Граница в строках [row_begin, row_end) (для обработки полосами)
+    * @param[out] dst изображение размера image, заполняются только строки полосы
+    */
+    static void Extract(const cv::Mat& image, Type type, Connectivity connectivity,
+        int row_begin, int row_end, cv::Mat& dst);
+};
+
+#endif
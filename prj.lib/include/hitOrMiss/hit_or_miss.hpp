@@ -17,6 +17,19 @@
 #include <stdio.h>
 #include <opencv2/opencv.hpp>
 #include<iosfwd>
+#include<memory>
+#include<vector>
+
+#include<hitOrMiss/binary_image.hpp>
+#include<hitOrMiss/bit_plane.hpp>
+#include<hitOrMiss/fused_boundary.hpp>
+#include<hitOrMiss/hit_or_miss_stats.hpp>
+#include<hitOrMiss/run_length_image.hpp>
+#include<hitOrMiss/structuring_element.hpp>
+#include<hitOrMiss/summed_area_table.hpp>
+#include<hitOrMiss/tile_map.hpp>
+
+class EngineTuner;
 
 /**
 * @brief Функция этого класса: создать изображение обработанное методом Hit or Miss
@@ -24,8 +37,42 @@
 * Единственный класс библиотеки, содержит параметры для работы алгоритма
 * а также функции для их проверки и обработки. 
 * Все передаваемые изображения должны быть в оттенках серого и иметь тип CV_8UC1
+* (изображение для обработки также может быть CV_8UC3, CV_16UC1, CV_32FC1 или BinaryImage).
+* Переданные изображения бинаризуются в собственную память и не изменяются
+*
+* Промежуточные результаты обработки хранятся во внутреннем буфере объекта,
+* поэтому один объект не должен обрабатывать изображения из нескольких потоков
+* одновременно (для этого нужны его копии)
 */
 class HitOrMiss {
+public:
+    /**
+    * @brief Движок, которым выполняется проход структурными элементами
+    */
+    enum class Engine {
+        kBytewise, /**< побайтовый проход по CV_8UC1, одно положение окна за раз */
+        kBitPlane, /**< упакованное изображение, 64 положения окна за одно слово (по умолчанию) */
+        kRunLength, /**< серии черных пикселей по строкам, время зависит от количества серий
+                   (для почти белых изображений, обрабатывается в одном потоке) */
+        kOpenCv, /**< cv::morphologyEx с cv::MORPH_HITMISS (при выделении не 1*1 - как kBytewise) */
+        kAuto /**< самый быстрый из движков, выбранный EngineTuner для структурных элементов,
+              размера изображения и количества потоков (по умолчанию) */
+    };
+
+    /**
+    * @brief Что видят окна за краем изображения
+    *
+    * При kNone окна целиком лежат в изображении, и пиксели ближе размера окна к краю
+    * выделяются не всеми окнами. В остальных режимах проходят все окна, задевающие
+    * изображение, а пиксели за краем считаются заданными режимом
+    */
+    enum class BorderMode {
+        kNone, /**< окна не выходят за край (по умолчанию) */
+        kWhite, /**< за краем белый фон */
+        kBlack, /**< за краем черный фон */
+        kReplicate /**< за краем повторяется ближайший пиксель края */
+    };
+
 public:
     /**
     * @brief Конструктор по умолчанию
@@ -100,9 +147,17 @@ public:
     /**
     * @brief Конструктор копирования 
     * 
+    * Копируются параметры и подготовленное изображение, внутренний буфер не копируется
     * param[in] Объект типа HitOrMiss
     */
-    HitOrMiss(const HitOrMiss& rhs);
+    HitOrMiss(const HitOrMiss& rhs) = default;
+
+    /**
+    * @brief Конструктор перемещения
+    *
+    * Исходный объект остается пригодным только для присваивания и уничтожения
+    */
+    HitOrMiss(HitOrMiss&& rhs) noexcept = default;
     
     /**
     * @brief Деструктор по умолчанию
@@ -110,18 +165,35 @@ public:
     ~HitOrMiss() = default;
 
     /**
-    * @brief Оператор присваивания
+    * @brief Оператор присваивания (внутренний буфер не копируется)
+    */
+    HitOrMiss& operator=(const HitOrMiss& rhs) = default;
+
+    /**
+    * @brief Оператор перемещающего присваивания
     */
-    HitOrMiss& operator=(const HitOrMiss& rhs);
+    HitOrMiss& operator=(HitOrMiss&& rhs) noexcept = default;
 
 public:
     /**
     * @brief setter: изображения для обработки
-    * @param[in] lhs бинарное изображение
+    *
+    * Изображение бинаризуется в новую память (см. BinaryImage), lhs не изменяется
+    * @param[in] lhs изображение CV_8UC1, CV_8UC3, CV_16UC1 или CV_32FC1
     * @throw invalid_argument если тип изображения, не соответстует описанию
     */
     void set_image(cv::Mat lhs);
 
+    /**
+    * @brief setter: уже бинарное изображение для обработки (без пороговой обработки и копирования)
+    *
+    * Данные разделяются с image, поэтому после его изменения (например, BinaryImage::Assign)
+    * изображение нужно передать заново
+    * @param[in] image бинарное изображение
+    * @throw invalid_argument если изображение пустое
+    */
+    void set_image(const BinaryImage& image);
+
     /**
      * @brief setter: структурный элемент для переднего плана
      * @param[in] lhs бинарное изображение
@@ -145,6 +217,66 @@ public:
     */
     void set_hit_highlight(cv::Mat lhs);
 
+    /**
+    * @brief setter: движок прохода структурными элементами
+    * @param[in] engine движок, результат не зависит от выбора
+    */
+    void set_engine(Engine engine);
+
+    /**
+    * @brief setter: настройщик, выбирающий движок при kAuto
+    *
+    * По умолчанию общий для всех объектов (EngineTuner::Shared()), поэтому
+    * движки замеряются один раз на процесс для каждого сочетания параметров
+    * @param[in] tuner настройщик, копии объекта пользуются тем же настройщиком
+    * @throw invalid_argument если настройщик не задан
+    */
+    void set_engine_tuner(std::shared_ptr<EngineTuner> tuner);
+
+    /**
+    * @brief setter: статистика проходов (только при сборке с HITORMISS_STATS)
+    *
+    * Каждая стадия добавляет в статистику свой интервал, проверка окон - счетчики.
+    * Копии объекта пишут в ту же статистику
+    * @param[in] stats статистика, nullptr - не собирать
+    */
+    void set_stats(std::shared_ptr<HitOrMissStats> stats) { stats_ = std::move(stats); }
+
+    /**
+    * @brief setter: режим обработки пикселей за краем изображения
+    *
+    * Движки обрабатывают только окна внутри изображения, без проверок границ;
+    * пиксели у края, которые выделяют выходящие за край окна, пересчитываются отдельно
+    * @param[in] border_mode режим, для пакетной обработки (DoHitOrMissBatch) не используется
+    */
+    void set_border_mode(BorderMode border_mode) {
+        border_mode_ = border_mode;
+        cache_.valid = false;
+    }
+
+    /**
+    * @brief setter: количество потоков обработки
+    *
+    * При значении больше 1 изображение делится на столько же горизонтальных
+    * полос, которые обрабатываются в пуле потоков OpenCV (cv::parallel_for_).
+    * Результат не зависит от количества потоков
+    * @param[in] thread_count количество потоков, 0 - по числу потоков OpenCV (cv::getNumThreads)
+    * @throw invalid_argument если количество потоков отрицательное
+    */
+    void set_thread_count(int thread_count);
+
+    /**
+    * @brief setter: порядок проверки значимых пикселей по изображению
+    *
+    * При включенном порядке (по умолчанию) строки значимых пикселей упорядочиваются по выборке
+    * окон изображения так, чтобы отвергнутые окна отсеивались за меньшее число сравнений.
+    * Выборка повторяется после смены структурных элементов, размера изображения или заметного
+    * изменения доли черных пикселей в нем, а не при каждом set_image.
+    * Результат от порядка не зависит
+    * @param[in] probe_ordering true - по изображению, false - построчно, как в структурном элементе
+    */
+    void set_probe_ordering(bool probe_ordering);
+
     /**
     * @brief getter: изображение для обработки
     * @return сыллка на константу изображение для обработки
@@ -162,6 +294,18 @@ public:
     * @return сыллка на константу структурного элемента для пзаднего плана
     */
     const cv::Mat& get_kernel_background() const { return kernel_background_; }
+
+    /**
+    * @brief getter: скомпилированный структурный элемент для переднего плана
+    * @return значимые пиксели в порядке проверки (см. set_probe_ordering)
+    */
+    const StructuringElement& get_compiled_foreground() const { return compiled_foreground_; }
+
+    /**
+    * @brief getter: скомпилированный структурный элемент для заднего плана
+    * @return значимые пиксели в порядке проверки (см. set_probe_ordering)
+    */
+    const StructuringElement& get_compiled_background() const { return compiled_background_; }
     
     /**
     * @brief getter: структурный элемент, отвечающий за выделение при попадании
@@ -169,6 +313,48 @@ public:
     */
     const cv::Mat& get_hit_highlight() const { return hit_highlight_; }
 
+    /**
+    * @brief смещения пикселей, закрашиваемых при попадании, от левого верхнего угла окна
+    * @param[in] kernel_size размер окна структурного элемента
+    * @return смещения черных пикселей выделения (для выделения 1*1 - центр окна)
+    */
+    std::vector<cv::Point> HighlightOffsets(const cv::Size& kernel_size) const;
+
+    /**
+    * @brief getter: движок прохода структурными элементами
+    */
+    Engine get_engine() const { return engine_; }
+
+    /**
+    * @brief getter: движок, которым выполнялся последний проход (при kAuto - выбранный настройщиком)
+    */
+    Engine get_active_engine() const { return active_engine_; }
+
+    /**
+    * @brief getter: настройщик, выбирающий движок при kAuto
+    */
+    const std::shared_ptr<EngineTuner>& get_engine_tuner() const { return tuner_; }
+
+    /**
+    * @brief getter: статистика проходов (nullptr - не собирается)
+    */
+    const std::shared_ptr<HitOrMissStats>& get_stats() const { return stats_; }
+
+    /**
+    * @brief getter: режим обработки пикселей за краем изображения
+    */
+    BorderMode get_border_mode() const { return border_mode_; }
+
+    /**
+    * @brief getter: количество потоков обработки (0 - по числу потоков OpenCV)
+    */
+    int get_thread_count() const { return thread_count_; }
+
+    /**
+    * @brief getter: значимые пиксели упорядочиваются по изображению
+    */
+    bool get_probe_ordering() const { return probe_ordering_; }
+
     /**
     * @brief Метод обрабатывающий изображение алгоритмом Hit or Miss
     * @return обработанное бинарное изображение
@@ -176,6 +362,20 @@ public:
     */
     cv::Mat DoHitOrMiss() const;
 
+    /**
+    * @brief Метод обрабатывающий изображение алгоритмом Hit or Miss, с записью в переданное изображение
+    *
+    * dst пересоздается, только если его размер или тип не совпадает с изображением для обработки
+    * или он разделяет с ним данные. Промежуточные результаты хранятся во внутреннем буфере,
+    * который растет до самого большого обработанного изображения, поэтому повторные вызовы
+    * (в том числе после set_image(const BinaryImage&) с изображением того же размера) не выделяют память
+    * при движках kBytewise и kBitPlane в одном потоке (при kAuto - когда выбран один из них;
+    * первый вызов для новых параметров замеряет движки, см. EngineTuner)
+    * @param[out] dst обработанное бинарное изображение
+    * @throw invalid_argument если размеры изображений не соответствуют описанию
+    */
+    void DoHitOrMiss(cv::Mat& dst) const;
+
     /**
     * @brief Метод извлечения границ объектов из изображения
     * с помощью алгоритма Hit or Miss
@@ -183,8 +383,165 @@ public:
     * @throw invalid_argument если размеры изображений не соответствуют описанию
     */
     cv::Mat DoBoundaryExtraction() const;
+
+    /**
+    * @brief Метод извлечения границ с записью в переданное изображение (как DoHitOrMiss(cv::Mat&))
+    *
+    * Для черного квадрата или креста 3*3 без заднего плана с выделением центра
+    * граница находится за один проход (FusedBoundary) при любом движке
+    * @param[out] dst извлеченные границы на исходном бинарном изображении
+    * @throw invalid_argument если размеры изображений не соответствуют описанию
+    */
+    void DoBoundaryExtraction(cv::Mat& dst) const;
+
+    /**
+    * @brief Извлечение внутренней или внешней границы за один проход по изображению
+    *
+    * Структурные элементы и движок не используются: соседи пикселя задаются связностью,
+    * за краем изображения белый фон (см. FusedBoundary)
+    * @param[in] type внутренняя или внешняя граница
+    * @param[in] connectivity 4- или 8-связность
+    * @return граница на исходном бинарном изображении
+    */
+    cv::Mat DoBoundaryExtraction(FusedBoundary::Type type, FusedBoundary::Connectivity connectivity) const;
+
+    /**
+    * @brief Извлечение границы за один проход с записью в переданное изображение (как DoHitOrMiss(cv::Mat&))
+    * @param[out] dst граница на исходном бинарном изображении
+    * @param[in] type внутренняя или внешняя граница
+    * @param[in] connectivity 4- или 8-связность
+    */
+    void DoBoundaryExtraction(cv::Mat& dst, FusedBoundary::Type type, FusedBoundary::Connectivity connectivity) const;
+
+    /**
+    * @brief Перерисовать прямоугольник изображения с обновлением сохраненных результатов
+    *
+    * Изображение меняется на месте; при первом изменении после set_image или копирования объекта
+    * оно копируется, поэтому данные вызывающего кода и других объектов не меняются.
+    * Упакованное изображение и карта тайлов обновляются в пределах прямоугольника, а в сохраненных
+    * результатах (если они построены) пересчитываются только окна, задевающие прямоугольник,
+    * расширенный на размер структурного элемента. Время обновления зависит от размера
+    * прямоугольника, а не изображения: интегральное изображение kBytewise и серии kRunLength
+    * только сбрасываются и перестраиваются при следующем полном проходе
+    * @param[in] rect непустой прямоугольник внутри изображения
+    * @param[in] patch новое содержимое прямоугольника (типы как у set_image)
+    * @return прямоугольник сохраненных результатов, которые могли измениться
+    * @throw invalid_argument если прямоугольник вне изображения или размер patch с ним не совпадает
+    */
+    cv::Rect UpdateRegion(const cv::Rect& rect, const cv::Mat& patch);
+
+    /**
+    * @brief Сохраненный результат Hit or Miss (совпадает с DoHitOrMiss)
+    *
+    * Строится полным проходом при первом обращении после set_image или изменения структурных
+    * элементов, выделения или режима границы, дальше обновляется UpdateRegion
+    * @throw invalid_argument если размеры изображений не соответствуют описанию
+    */
+    const cv::Mat& CachedHitOrMiss() const;
+
+    /**
+    * @brief Сохраненное выделение попаданий структурного элемента переднего плана (как CachedHitOrMiss)
+    */
+    const cv::Mat& CachedForeground() const;
+
+    /**
+    * @brief Сохраненное выделение попаданий структурного элемента заднего плана (как CachedHitOrMiss)
+    */
+    const cv::Mat& CachedBackground() const;
+
+    /**
+    * @brief Hit or Miss для набора изображений за один проход
+    *
+    * Изображения бинаризуются при упаковке и складываются друг под другом в один
+    * упакованный буфер шириной по самому широкому изображению, по которому
+    * структурные элементы проходят один раз. Попадания учитываются только для окон,
+    * целиком лежащих в одном изображении, поэтому результат для каждого изображения
+    * совпадает с DoHitOrMiss при BorderMode::kNone (режим границы не используется). Обработка всегда идет упакованным движком,
+    * изображение объекта не используется и не меняется
+    * @param[in] images изображения CV_8UC1 (любого размера)
+    * @return результаты - области одного общего изображения, по одной на входное изображение
+    * @throw invalid_argument если изображение пустое или размеры структурных элементов не соответствуют описанию
+    */
+    std::vector<cv::Mat> DoHitOrMissBatch(const std::vector<cv::Mat>& images) const;
+
+    /**
+    * @brief Извлечение границ для набора изображений за один проход (как DoHitOrMissBatch)
+    * @param[in] images изображения CV_8UC1 (любого размера)
+    * @return границы - области одного общего изображения, по одной на входное изображение
+    * @throw invalid_argument если изображение пустое или размеры структурных элементов не соответствуют описанию
+    */
+    std::vector<cv::Mat> DoBoundaryExtractionBatch(const std::vector<cv::Mat>& images) const;
     
 
+private:
+    // Общее окно структурных элементов переднего и заднего плана при выделении 1*1:
+    // закрашиваемые пиксели обоих проходов совпадают, поэтому окна проверяются вместе
+    struct FusedWindow {
+        cv::Size size; // размер общего окна
+        cv::Point foreground; // левый верхний угол структурного элемента переднего плана в общем окне
+        cv::Point background; // левый верхний угол структурного элемента заднего плана в общем окне
+        cv::Point highlight; // закрашиваемый при попадании пиксель общего окна
+    };
+
+    // Промежуточные результаты, память под которые переиспользуется между вызовами;
+    // при копировании объекта не копируются, копия заводит свой буфер
+    struct Scratch {
+        Scratch() = default;
+        Scratch(const Scratch&) {}
+        Scratch(Scratch&&) noexcept = default;
+        Scratch& operator=(const Scratch&) { return *this; }
+        Scratch& operator=(Scratch&&) noexcept = default;
+
+        cv::Mat hits; // карта попаданий побайтового прохода
+        cv::Mat stamp_foreground; // выделение попаданий переднего плана
+        cv::Mat stamp_background; // выделение попаданий заднего плана
+        cv::Mat hit_or_miss; // результат Hit or Miss для извлечения границ
+        BitPlane hits_foreground; // упакованные попадания переднего плана
+        BitPlane hits_background; // упакованные попадания заднего плана
+        BitPlane stamp_plane; // упакованное выделение попаданий заднего плана
+        BitPlane result; // упакованный результат Hit or Miss
+        BitPlane boundary; // упакованные границы
+        cv::Mat inverted; // изображение с черными пикселями 255 для cv::morphologyEx
+        cv::Mat morphology; // карта попаданий cv::morphologyEx
+    };
+
+    // Для каких параметров выбран движок при kAuto
+    struct Tuning {
+        bool valid = false; // структурные элементы и движок не менялись после выбора
+        cv::Size size; // размер изображения
+        int thread_count = 0; // количество потоков
+    };
+
+    // По какому изображению упорядочены значимые пиксели
+    struct ProbeOrder {
+        bool valid = false; // структурные элементы не менялись после упорядочения
+        cv::Size size; // размер изображения
+        double black_ratio = 0; // доля черных пикселей в выборке изображения
+    };
+
+    // Сохраненные результаты для UpdateRegion
+    struct Cache {
+        Cache() = default;
+        // копия не получает сохраненных результатов, а изображение копии и оригинала
+        // становится общим, поэтому обе стороны скопируют его перед изменением
+        Cache(const Cache& rhs) { rhs.image_private = false; }
+        Cache& operator=(const Cache& rhs) {
+            rhs.image_private = false;
+            image_private = false;
+            valid = false;
+            return *this;
+        }
+        Cache(Cache&&) noexcept = default;
+        Cache& operator=(Cache&&) noexcept = default;
+
+        bool valid = false; // результаты соответствуют изображению и параметрам
+        mutable bool image_private = false; // данные изображения не разделяются ни с кем, кроме объекта
+        cv::Mat foreground; // выделение попаданий переднего плана
+        cv::Mat background; // выделение попаданий заднего плана
+        cv::Mat hit_or_miss; // результат Hit or Miss
+        cv::Mat hits; // попадания окон обновляемой области
+    };
+
 private:
     // Проверка типа изображения, а также бинаризация
     cv::Mat TypeCheck(cv::Mat lhs) const; 
@@ -194,16 +551,172 @@ private:
 
     // Проход по изображению структурным элементом 
     //(при foreground=true - переднего плана, иначе заднего), при Hit отметить место попадания
-    cv::Mat MaskMatching(const bool& foreground) const; 
+    void MaskMatching(const bool& foreground, cv::Mat& dst) const; 
+
+    // Проход по изображению сразу обоими структурными элементами (только при выделении 1*1):
+    // задний план проверяется, только если совпал передний, результат пишется сразу
+    void FusedMaskMatching(cv::Mat& dst) const;
+
+    // Общее окно структурных элементов переднего и заднего плана
+    FusedWindow GetFusedWindow() const;
+
+    // Проверять оба элемента в общем окне (выделение 1*1 и общее окно не мешает быстрому проходу)
+    bool UseFusedWindow() const;
+
+    // DoHitOrMiss без записи в статистику (вызывается и из извлечения границ)
+    void HitOrMissInto(cv::Mat& dst) const;
+
+    // DoBoundaryExtraction без записи в статистику
+    void BoundaryInto(cv::Mat& dst) const;
+
+    // Однопроходное извлечение границ без записи в статистику
+    void FusedBoundaryInto(cv::Mat& dst, FusedBoundary::Type type, FusedBoundary::Connectivity connectivity) const;
+
+    // Выполнить body как стадию name; в статистику добавляются интервал, рост внутреннего буфера,
+    // пересоздание dst и, если count_hits, черные пиксели dst
+    template<class Body>
+    void Instrumented(const char* name, cv::Mat& dst, bool count_hits, const Body& body) const;
+
+    // Размер памяти внутреннего буфера в байтах
+    size_t ScratchBytes() const;
+
+    // Счетчики для проверки окон, если статистика собирается, иначе nullptr
+    HitOrMissStats::Counters* CountersSink(HitOrMissStats::Counters& counters) const {
+        return HitOrMissStats::kEnabled && stats_ ? &counters : nullptr;
+    }
+
+    // Добавить счетчики в статистику, если она собирается
+    void RecordCounters(const HitOrMissStats::Counters& counters) const {
+        if (HitOrMissStats::kEnabled && stats_) {
+            stats_->AddCounters(counters);
+        }
+    }
+
+    // Упорядочить значимые пиксели скомпилированных элементов по изображению (при probe_ordering_),
+    // если элементы менялись или изображение изменилось после прошлого упорядочения
+    void OrderProbes();
+
+    // Доля черных пикселей на равномерной сетке kBlackRatioSide * kBlackRatioSide пикселей изображения
+    double SampledBlackRatio() const;
+
+    // Hit or Miss окнами, целиком лежащими в изображении, выбранным движком
+    void InteriorHitOrMiss(cv::Mat& dst) const;
+
+    // При kAuto выбрать движок настройщиком, если изменились структурные элементы,
+    // размер изображения или количество потоков; построить суммы и серии, если нужны выбранному движку
+    void ResolveEngine() const;
+
+    // Hit or Miss окнами, целиком лежащими в изображении, через cv::MORPH_HITMISS по общему окну
+    // (только при выделении 1*1)
+    void OpenCvHitOrMiss(cv::Mat& dst) const;
+
+    // Пересчет пикселей у края, которые выделяют выходящие за край окна (режим границы не kNone):
+    // окна проверяются по одному с чтением пикселей за краем по border_mode_
+    void BorderHitOrMiss(cv::Mat& dst) const;
+
+    // Совпадение структурного элемента в окне с левым верхним углом (mask_row, mask_col),
+    // которое может выходить за край изображения
+    bool BorderMatch(const StructuringElement& compiled, int mask_row, int mask_col) const;
+
+    // Совпадение окна с левым верхним углом (mask_row, mask_col) с учетом режима границы:
+    // при kNone окна, выходящие за край, не совпадают
+    bool WindowMatch(const StructuringElement& compiled, int mask_row, int mask_col) const;
+
+    // Построить сохраненные результаты полным проходом, если они устарели
+    void BuildCache() const;
+
+    // Пересчитать выделение stamp в прямоугольнике pixels по окнам, которые могут его выделить
+    void UpdateStamp(const StructuringElement& compiled, const std::vector<cv::Point>& offsets,
+        const cv::Rect& pixels, cv::Mat& stamp) const;
+
+    // Хотя бы одно окно, выделяющее пиксель (row, col) со сдвигом из offsets, совпало
+    bool BorderStamp(const StructuringElement& compiled, const std::vector<cv::Point>& offsets, int row, int col) const;
+
+    // Извлечение границ с текущими элементами равно однопроходному (квадрат или крест 3*3
+    // из черных значимых пикселей, задний план без значимых пикселей, выделение центра,
+    // за краем белый фон или окна за край не выходят)
+    bool FusedBoundaryMatching(FusedBoundary::Connectivity& connectivity) const;
+
+    // Для элемента есть проход быстрее перебора значимых пикселей
+    // (SeparableErosion, NeighborhoodTable, FixedSizeMatching или SummedAreaTable)
+    bool FastMatching(const StructuringElement& compiled) const;
+
+    // Проход побайтовый: движок kBytewise или kOpenCv, работающий как kBytewise
+    bool BytewiseEngine() const;
+
+    // Элемент проходится по таблице кодов окрестности
+    bool LookupMatching(const StructuringElement& compiled) const;
+
+    // Элемент проходится специализацией для размера его окна
+    bool SpecializedMatching(const StructuringElement& compiled) const;
+
+    // Элемент проходится по интегральному изображению
+    bool SummedAreaMatching(const StructuringElement& compiled) const;
+
+    // Карта попаданий элемента для полосы строк [row_begin, row_end) левых верхних углов окон
+    // самым быстрым подходящим проходом
+    void MatchBand(const StructuringElement& compiled, int row_begin, int row_end, cv::Mat& hits) const;
+
+    // Разбить окна с левыми верхними углами в строках [row_begin, row_end) по тайлам изображения:
+    // окна, которые видят только однородную область, получают общий результат fill(windows, hit),
+    // остальные собираются в прямоугольники для match(windows)
+    template<class Match, class Fill>
+    void TileWindows(const StructuringElement& compiled, int row_begin, int row_end,
+        const Match& match, const Fill& fill) const;
+
+    // BitPlane::Match по упакованному изображению объекта для полосы строк с пропуском однородных тайлов
+    void MatchPlaneBand(const StructuringElement& compiled, const cv::Point& offset,
+        int row_begin, int row_end, BitPlane& dst) const;
+
+    // MaskMatching, разбитый на горизонтальные полосы, которые обрабатываются параллельно
+    // (им же проходится сплошной прямоугольный элемент, см. SeparableErosion)
+    void ParallelMaskMatching(const cv::Mat& kernel, const StructuringElement& compiled,
+        const std::vector<cv::Point>& offsets, cv::Mat& dst) const;
+
+    // Компиляция структурных элементов в списки значимых пикселей (при каждой их установке)
+    void CompileKernels();
+
+    // Смещения выделения при попадании для обоих элементов (при установке элементов и выделения)
+    void CompileHighlight();
+
+    // Построить интегральное изображение, если его использует хотя бы один структурный элемент
+    void PrepareImageSums() const;
+
+    // Построить серии черных пикселей изображения, если выбран движок kRunLength
+    void PrepareImageRuns() const;
+
+    // Обработка строк [0, rows) полосами [row_begin, row_end) в thread_count_ потоков
+    template<class Band>
+    void ParallelBands(int rows, const Band& band) const;
 
     // Сравнение двух изображений как множеств с помощью оператора and (где черный пиксель логически 1, а белый 0)
-    cv::Mat AndOperation(const cv::Mat& lhs, const cv::Mat& rhs) const; 
+    void AndOperation(const cv::Mat& lhs, const cv::Mat& rhs, cv::Mat& dst) const; 
 
     // Сравнение двух изображений как множеств с помощью оператора or (где черный пиксель логически 1, а белый 0)
-    cv::Mat OrOperation(const cv::Mat& lhs, const cv::Mat& rhs) const;
+    void OrOperation(const cv::Mat& lhs, const cv::Mat& rhs, cv::Mat& dst) const;
 
     // Вычитание из первого изображения второго, как множества (где черный пиксель логически 1, а белый 0)
-    cv::Mat SubstractionOperation(const cv::Mat& lhs, const cv::Mat& rhs) const;
+    void SubstractionOperation(const cv::Mat& lhs, const cv::Mat& rhs, cv::Mat& dst) const;
+
+    // Область rows*cols буфера buffer, который пересоздается, только если она в него не помещается
+    cv::Mat ScratchRegion(cv::Mat& buffer, int rows, int cols) const;
+
+    // Hit or Miss над упакованным изображением, результат в упакованном виде в dst;
+    // если заданы области regions (лежат друг под другом, начиная со столбца 0),
+    // учитываются только окна, целиком лежащие в одной области
+    void BitPlaneHitOrMiss(const BitPlane& image, const std::vector<cv::Rect>& regions, BitPlane& dst) const;
+
+    // Сложить изображения друг под другом в упакованный буфер с бинаризацией, regions - их места в нем
+    BitPlane StackImages(const std::vector<cv::Mat>& images, std::vector<cv::Rect>& regions) const;
+
+    // Обнулить попадания окон размера window, не лежащих целиком в одной из областей regions
+    void RestrictHits(const cv::Size& window, const std::vector<cv::Rect>& regions, BitPlane& hits) const;
+
+    // Распаковать результат пакетной обработки и вернуть области изображений
+    std::vector<cv::Mat> UnstackImages(const BitPlane& stack, const std::vector<cv::Rect>& regions) const;
+
+    // Hit or Miss над сериями черных пикселей изображения, результат в сериях
+    RunLengthImage RunLengthHitOrMiss() const;
 
 private:
     // изображение для обработки
@@ -214,15 +727,59 @@ private:
     cv::Mat kernel_background_; 
     // структурный элемент, отвечающий за выделение при попадании
     cv::Mat hit_highlight_; 
+    // скомпилированный структурный элемент для переднего плана
+    StructuringElement compiled_foreground_;
+    // скомпилированный структурный элемент для заднего плана
+    StructuringElement compiled_background_;
+    // оба структурных элемента в общем окне (для выделения 1*1)
+    StructuringElement compiled_fused_;
+    // смещения закрашиваемых при попадании пикселей от левого верхнего угла окна переднего плана
+    std::vector<cv::Point> offsets_foreground_;
+    // то же для окна заднего плана
+    std::vector<cv::Point> offsets_background_;
+    // изображение для обработки, упакованное по 1 биту на пиксель
+    BitPlane image_bits_;
+    // интегральное изображение черных пикселей (пустое, если не нужно структурным элементам и движку;
+    // строится при выборе движка, в том числе во время прохода)
+    mutable SummedAreaTable image_sums_;
+    // серии черных пикселей изображения (пустые, если движок не kRunLength)
+    mutable RunLengthImage image_runs_;
+    // состояния тайлов изображения для обработки (белый, черный, смешанный)
+    TileMap image_tiles_;
+    // движок прохода структурными элементами
+    Engine engine_ = Engine::kAuto;
+    // движок, которым выполняется проход (при kAuto - выбранный настройщиком)
+    mutable Engine active_engine_ = Engine::kBitPlane;
+    // для каких параметров выбран active_engine_ при kAuto
+    mutable Tuning tuning_;
+    // настройщик, выбирающий движок при kAuto
+    std::shared_ptr<EngineTuner> tuner_;
+    // статистика проходов (nullptr - не собирается)
+    std::shared_ptr<HitOrMissStats> stats_;
+    // количество потоков обработки
+    int thread_count_ = 1;
+    // значимые пиксели упорядочиваются по изображению
+    bool probe_ordering_ = true;
+    // по какому изображению упорядочены значимые пиксели
+    ProbeOrder probe_order_;
+    // режим обработки пикселей за краем изображения
+    BorderMode border_mode_ = BorderMode::kNone;
+    // промежуточные результаты обработки
+    mutable Scratch scratch_;
+    // сохраненные результаты для UpdateRegion
+    mutable Cache cache_;
 
 private:
-    const int kWhite = 255; // код белого пикселя
-    const int kBlack = 0; // код черного пкселя
-    const int kDefaulHitHighlight = 1; // размер структурного элемента по выделению (по умолчанию)
-    const int kDefaulKernelForeground = 3; // размер структурного элемента (по умолчанию)
-    const int kDefaulKernelBackground = 1; // размер структурного элемента (по умолчанию)
-    const int kThresholdValue = 127; // пороговое значение бинаризации (по умолчанию)
-    const int kDefaultImageDimension = 200; // размер изображения для обработки (по умочанию)
+    static constexpr int kWhite = 255; // код белого пикселя
+    static constexpr int kBlack = 0; // код черного пкселя
+    static constexpr int kDefaulHitHighlight = 1; // размер структурного элемента по выделению (по умолчанию)
+    static constexpr int kDefaulKernelForeground = 3; // размер структурного элемента (по умолчанию)
+    static constexpr int kDefaulKernelBackground = 1; // размер структурного элемента (по умолчанию)
+    static constexpr int kThresholdValue = 127; // пороговое значение бинаризации (по умолчанию)
+    static constexpr int kDefaultImageDimension = 200; // размер изображения для обработки (по умочанию)
+    static constexpr int kBlackRatioSide = 16; // пикселей сетки доли черных пикселей по каждой оси
+    static constexpr double kProbeOrderDrift = 0.05; // изменение доли черных пикселей, после которого
+                                                     // значимые пиксели упорядочиваются заново
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,123 @@
+﻿/**
+* @file hit_or_miss_bank.hpp
+* @brief Набор пар структурных элементов, проверяемых за один проход
+*
+* Утончение, отсечение ветвей, поиск углов применяют по 8-64 пары структурных
+* элементов. Набор проходит изображение один раз: условия всех пар (пиксель со
+* смещением от центра окна должен быть черным или белым) сливаются в префиксное
+* дерево, поэтому общие условия проверяются один раз для всех пар, а одно
+* несовпавшее условие отбрасывает сразу все пары поддерева. Каждое слово изображения,
+* нужное условиям, читается один раз на положение и общее для всех пар.
+*
+* @author Kiselev K.A.
+* @date 17.10.2026
+*/
+
+#pragma once
+#ifndef HITORMISS_HIT_OR_MISS_BANK_HPP_20261017
+#define HITORMISS_HIT_OR_MISS_BANK_HPP_20261017
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include<hitOrMiss/bit_plane.hpp>
+#include<hitOrMiss/neighborhood_table.hpp>
+#include<hitOrMiss/structuring_element.hpp>
+
+/**
+* @brief Набор пар структурных элементов (передний и задний план)
+*
+* Каждая пара проверяется как HitOrMiss с выделением 1*1: центры элементов совмещаются,
+* окна должны целиком лежать в изображении, при попадании отмечается центр окна.
+* Карта попаданий пары совпадает с HitOrMiss::DoHitOrMiss для этой пары.
+* Набор из не более 64 пар с окном 3*3 сливается в одну таблицу кодов окрестности,
+* и DoLabelMap находит номер пары одним обращением к таблице на положение окна.
+*/
+class HitOrMissBank {
+public:
+    /**
+    * @brief Пара структурных элементов в общем окне
+    */
+    struct Pattern {
+        StructuringElement element; /**< значимые пиксели обоих элементов в общем окне */
+        cv::Point center; /**< отмечаемый при попадании пиксель окна */
+    };
+
+public:
+    /**
+    * @brief Конструктор по умолчанию: пустой набор
+    */
+    HitOrMissBank() = default;
+
+    /**
+    * @brief Добавить пару структурных элементов
+    * @param[in] kernel_foreground структурный элемент переднего плана CV_8UC1
+    * @param[in] kernel_background структурный элемент заднего плана CV_8UC1 того же размера
+    * или 1*1 (пустой - как по умолчанию в HitOrMiss, без значимых пикселей)
+    * @return номер пары в наборе
+    * @throw invalid_argument если элемент пустой или размеры не соответствуют описанию
+    */
+    int AddPattern(cv::Mat kernel_foreground, cv::Mat kernel_background = cv::Mat());
+
+    /**
+    * @brief getter: количество пар в наборе
+    */
+    int get_pattern_count() const { return static_cast<int>(patterns_.size()); }
+
+    /**
+    * @brief getter: пара с номером index
+    */
+    const Pattern& get_pattern(int index) const { return patterns_[index]; }
+
+    /**
+    * @brief Карты попаданий всех пар за один проход
+    * @param[in] image изображение CV_8UC1, бинаризуется как в HitOrMiss
+    * @return по карте на пару (0 - попадание, 255 - нет), как HitOrMiss::DoHitOrMiss
+    * @throw invalid_argument если изображение пустое
+    */
+    std::vector<cv::Mat> DoHitMaps(const cv::Mat& image) const;
+
+    /**
+    * @brief Карта номеров попавших пар за один проход
+    * @param[in] image изображение CV_8UC1, бинаризуется как в HitOrMiss
+    * @return CV_32SC1: 0 - ни одна пара не попала, иначе номер первой попавшей пары + 1
+    * @throw invalid_argument если изображение пустое
+    */
+    cv::Mat DoLabelMap(const cv::Mat& image) const;
+
+private:
+    // Условие: пиксель со смещением probe от центра окна должен быть черным (black) или белым
+    struct Condition {
+        int probe = 0; // номер смещения в probes_
+        bool black = true; // требуемый цвет
+    };
+
+    // Узел префиксного дерева условий
+    struct Node {
+        Condition condition; // условие узла (у корня не проверяется)
+        std::vector<int> children; // дочерние узлы
+        std::vector<int> patterns; // пары, все условия которых проверены на пути к узлу
+    };
+
+    // Перестроить дерево условий по всем парам
+    void BuildTree();
+
+    // Попадания всех пар в упакованном виде (бит центра окна)
+    std::vector<BitPlane> Match(const cv::Mat& image) const;
+
+private:
+    std::vector<Pattern> patterns_; // пары
+    std::vector<cv::Point> probes_; // различные смещения значимых пикселей от центра окна
+    std::vector<Node> nodes_; // префиксное дерево условий, nodes_[0] - корень
+    NeighborhoodTable table_; // общая таблица пар с окном 3*3
+    bool lookup_ = false; // все пары в table_, номера пар ищутся по таблице
+
+private:
+    static constexpr int kWhite = 255; // код белого пикселя
+    static constexpr int kBlack = 0; // код черного пикселя
+    static constexpr int kThresholdValue = 127; // пороговое значение бинаризации
+    static constexpr int kLookupSide = 3; // сторона окна пар для прохода по таблице
+    static constexpr int kMaxLookupPatterns = 64; // наибольшее количество пар в таблице
+};
+
+#endif
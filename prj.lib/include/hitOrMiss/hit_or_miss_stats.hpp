@@ -0,0 +1,171 @@
+﻿/**
+* @file hit_or_miss_stats.hpp
+* @brief Счетчики и интервалы стадий HitOrMiss для поиска медленного места
+*
+* Сбор включается опцией CMake HITORMISS_STATS (макрос HITORMISS_STATS) и объектом,
+* переданным в HitOrMiss::set_stats. Без опции интерфейс остается, но проходы
+* ничего не записывают и не содержат ни одной лишней проверки.
+*
+* @author Kiselev K.A.
+* @date 17.10.2026
+*/
+
+#pragma once
+#ifndef HITORMISS_HIT_OR_MISS_STATS_HPP_20261017
+#define HITORMISS_HIT_OR_MISS_STATS_HPP_20261017
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+* @brief Статистика проходов: счетчики, время по стадиям и интервалы для трассировки
+*
+* Стадия - функция HitOrMiss (DoHitOrMiss, TypeCheck, MaskMatching, AndOperation и т.д.)
+* или полоса ParallelBands. Один объект могут заполнять несколько потоков и копии HitOrMiss
+*/
+class HitOrMissStats {
+public:
+    using Clock = std::chrono::steady_clock;
+
+#ifdef HITORMISS_STATS
+    static constexpr bool kEnabled = true; /**< сбор статистики собран в библиотеку */
+#else
+    static constexpr bool kEnabled = false; /**< сбор статистики собран в библиотеку */
+#endif
+
+    static constexpr int kDepthBins = 32; /**< ячеек гистограммы глубины, последняя - kDepthBins - 1 и больше */
+    static constexpr size_t kMaxSpans = 1 << 20; /**< интервалов сверх этого числа не записывается */
+
+    /**
+    * @brief Счетчики
+    *
+    * Пиксели и глубина считаются при поштучной проверке окон по значимым пикселям;
+    * проходы, проверяющие много окон сразу (упакованное изображение, таблица окрестности,
+    * интегральное изображение), считают только окна, а kRunLength и kOpenCv - ничего
+    */
+    struct Counters {
+        long long windows_tested = 0; /**< проверено окон (окна однородных тайлов не проверяются) */
+        long long pixels_compared = 0; /**< сравнено значимых пикселей */
+        long long hits = 0; /**< черных пикселей в результатах DoHitOrMiss */
+        long long bytes_allocated = 0; /**< выделено под внутренний буфер и результаты */
+        std::array<long long, kDepthBins> exit_depth{}; /**< отвергнутые окна по числу сравненных пикселей */
+
+        /**
+        * @brief Учесть окно, проверенное поштучно
+        * @param[in] compared сравнено пикселей
+        * @param[in] hit окно совпало
+        */
+        void AddWindow(int compared, bool hit) {
+            windows_tested += 1;
+            pixels_compared += compared;
+            if (!hit) {
+                exit_depth[compared < kDepthBins ? compared : kDepthBins - 1] += 1;
+            }
+        }
+    };
+
+    /**
+    * @brief Время стадии
+    */
+    struct Stage {
+        long long calls = 0; /**< вызовов */
+        double seconds = 0; /**< время (для полос - сумма по потокам) */
+    };
+
+    /**
+    * @brief Интервал стадии для трассировки
+    */
+    struct Span {
+        const char* name = nullptr; /**< имя стадии */
+        int thread = 0; /**< номер потока в порядке появления */
+        double begin_us = 0; /**< начало от создания или сброса статистики */
+        double duration_us = 0; /**< длительность */
+    };
+
+    /**
+    * @brief Интервал стадии на время жизни объекта (при stats == nullptr ничего не делает)
+    */
+    class Scope {
+    public:
+        /**
+        * @param[in] stats статистика или nullptr
+        * @param[in] name имя стадии, строковый литерал
+        */
+        Scope(HitOrMissStats* stats, const char* name)
+            : stats_(stats), name_(name), begin_(stats ? Clock::now() : Clock::time_point()) {}
+        ~Scope() {
+            if (stats_) {
+                stats_->AddSpan(name_, begin_, Clock::now());
+            }
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        HitOrMissStats* stats_;
+        const char* name_;
+        Clock::time_point begin_;
+    };
+
+public:
+    /**
+    * @brief Конструктор: пустая статистика, время интервалов отсчитывается от него
+    */
+    HitOrMissStats();
+
+    /**
+    * @brief Очистить статистику и начать отсчет времени заново
+    */
+    void Reset();
+
+    /**
+    * @brief Добавить счетчики (например, накопленные полосой)
+    */
+    void AddCounters(const Counters& counters);
+
+    /**
+    * @brief Добавить интервал стадии name текущего потока
+    */
+    void AddSpan(const char* name, Clock::time_point begin, Clock::time_point end);
+
+    /**
+    * @brief getter: счетчики
+    */
+    Counters get_counters() const;
+
+    /**
+    * @brief getter: время по стадиям
+    */
+    std::map<std::string, Stage> get_stages() const;
+
+    /**
+    * @brief getter: интервалы стадий в порядке завершения
+    */
+    std::vector<Span> get_spans() const;
+
+    /**
+    * @brief Интервалы в формате Chrome trace event (JSON для chrome://tracing и Perfetto)
+    */
+    std::string ChromeTrace() const;
+
+    /**
+    * @brief Записать ChromeTrace() в файл
+    * @return false, если файл не записался
+    */
+    bool WriteChromeTrace(const std::string& path) const;
+
+private:
+    mutable std::mutex mutex_; // доступ ко всем полям
+    Clock::time_point origin_; // начало отсчета интервалов
+    Counters counters_; // счетчики
+    std::map<std::string, Stage> stages_; // время по стадиям
+    std::vector<Span> spans_; // интервалы
+    std::map<std::thread::id, int> threads_; // номера потоков
+};
+
+#endif
@@ -0,0 +1,136 @@
+﻿/**
+* @file hit_or_miss_stream.hpp
+* @brief Построчная обработка изображения алгоритмом Hit or Miss
+*
+* Изображение поступает по одной строке (например, с камеры построчного сканирования)
+* и целиком нигде не хранится: в кольцевом буфере лежат только последние kernel.rows
+* строк и попадания окон, из которых еще собираются выходные строки. Выходная строка
+* выдается, как только завершены все окна, которые могут ее закрасить, то есть
+* с задержкой в kernel.rows - 1 строк.
+*
+* @author Kiselev K.A.
+* @date 17.10.2026
+*/
+
+#pragma once
+#ifndef HITORMISS_HIT_OR_MISS_STREAM_HPP_20261017
+#define HITORMISS_HIT_OR_MISS_STREAM_HPP_20261017
+
+#include <functional>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include<hitOrMiss/bit_plane.hpp>
+#include<hitOrMiss/hit_or_miss.hpp>
+#include<hitOrMiss/structuring_element.hpp>
+
+/**
+* @brief Построчный Hit or Miss
+*
+* Результат построчно совпадает с HitOrMiss::DoHitOrMiss (или DoBoundaryExtraction)
+* для изображения, составленного из переданных строк. Поддерживается только
+* HitOrMiss::BorderMode::kNone.
+*/
+class HitOrMissStream {
+public:
+    /**
+    * @brief Что выдается по строкам
+    */
+    enum class Output {
+        kHitOrMiss, /**< результат HitOrMiss::DoHitOrMiss */
+        kBoundary /**< результат HitOrMiss::DoBoundaryExtraction */
+    };
+
+    /**
+    * @brief Обработчик готовой строки: номер строки и ее пиксели (1*cols, CV_8UC1, 0 и 255)
+    *
+    * Пиксели действительны только во время вызова
+    */
+    using RowHandler = std::function<void(int row, const cv::Mat& pixels)>;
+
+public:
+    /**
+    * @brief Конструктор
+    * @param[in] cols ширина строк изображения
+    * @param[in] settings структурные элементы берутся из этого объекта (изображение не используется)
+    * @param[in] output что выдавать по строкам
+    * @param[in] handler обработчик готовых строк, вызывается по порядку строк
+    * @throw invalid_argument если ширина не положительная, обработчик не задан
+    * или режим границы в settings не kNone
+    */
+    HitOrMissStream(int cols, const HitOrMiss& settings, Output output, RowHandler handler);
+
+    /**
+    * @brief Передать следующую строку изображения
+    *
+    * Строка бинаризуется так же, как изображение в HitOrMiss. Вызывает обработчик
+    * для строки row - (kernel.rows - 1), если она есть
+    * @param[in] row строка 1*cols CV_8UC1
+    * @throw invalid_argument если размер или тип строки не соответствуют описанию
+    */
+    void PushRow(const cv::Mat& row);
+
+    /**
+    * @brief Завершить изображение: выдать оставшиеся строки
+    *
+    * После этого можно передавать строки следующего изображения
+    */
+    void Finish();
+
+    /**
+    * @brief getter: количество переданных строк текущего изображения
+    */
+    int get_rows_pushed() const { return rows_pushed_; }
+
+    /**
+    * @brief getter: количество выданных строк текущего изображения
+    */
+    int get_rows_emitted() const { return rows_emitted_; }
+
+    /**
+    * @brief getter: задержка выдачи в строках (kernel.rows - 1)
+    */
+    int get_latency() const { return window_rows_ - 1; }
+
+private:
+    // Попадания окон с верхней строкой top, если окно помещается в rows строк
+    void MatchRow(int top, int rows);
+
+    // Собрать и выдать строку row
+    void EmitRow(int row);
+
+    // Скопировать строку кольца в ее повторение (слот + window_rows_)
+    void Mirror(BitPlane& ring, int slot) const;
+
+private:
+    int cols_ = 0; // ширина строк
+    Output output_ = Output::kHitOrMiss; // что выдается
+    RowHandler handler_; // обработчик готовых строк
+    StructuringElement foreground_; // скомпилированный структурный элемент переднего плана
+    StructuringElement background_; // скомпилированный структурный элемент заднего плана
+    std::vector<cv::Point> offsets_foreground_; // выделение при попадании переднего плана
+    std::vector<cv::Point> offsets_background_; // выделение при попадании заднего плана
+    int window_rows_ = 1; // высота окна и кольцевых буферов
+
+    /*
+    * кольцевые буферы из 2 * window_rows_ строк: строка t лежит в слотах t % window_rows_
+    * и t % window_rows_ + window_rows_, поэтому любые window_rows_ подряд идущих строк
+    * лежат в буфере подряд и проверяются обычным BitPlane::Match / BitPlane::Stamp
+    */
+    BitPlane image_ring_; // последние строки изображения
+    BitPlane hits_foreground_; // попадания переднего плана по верхним строкам окон
+    BitPlane hits_background_; // попадания заднего плана по верхним строкам окон
+    BitPlane stamp_foreground_; // выделение переднего плана собираемой строки
+    BitPlane stamp_background_; // выделение заднего плана собираемой строки
+    cv::Mat row_binary_; // бинаризованная входная строка
+    cv::Mat row_output_; // распакованная выходная строка
+
+    int rows_pushed_ = 0; // количество переданных строк
+    int rows_emitted_ = 0; // количество выданных строк
+
+private:
+    static constexpr int kWhite = 255; // код белого пикселя
+    static constexpr int kThresholdValue = 127; // пороговое значение бинаризации
+};
+
+#endif
@@ -0,0 +1,154 @@
+﻿/**
+* @file iterative_hit_or_miss.hpp
+* @brief Утончение, утолщение, остов и отсечение ветвей
+*
+* Алгоритмы Гонсалеса и Вудса строятся из повторяемых до сходимости проходов
+* Hit or Miss набором структурных элементов. Окно может изменить результат,
+* только если изменился один из его значимых пикселей, поэтому после первого прохода
+* проверяются лишь окна, задевающие пиксели, измененные на предыдущем шаге:
+* стоимость итерации пропорциональна движущемуся фронту, а не размеру изображения.
+*
+* @author Kiselev K.A.
+* @date 17.10.2026
+*/
+
+#pragma once
+#ifndef HITORMISS_ITERATIVE_HIT_OR_MISS_HPP_20261017
+#define HITORMISS_ITERATIVE_HIT_OR_MISS_HPP_20261017
+
+#include <cstdint>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include<hitOrMiss/hit_or_miss_bank.hpp>
+
+/**
+* @brief Итеративное применение набора пар структурных элементов
+*
+* Одна итерация последовательно применяет пары набора: попадания пары B к изображению A
+* удаляются (утончение, A - (A hmt B)) или добавляются (утолщение, A + (A hmt B)),
+* следующая пара применяется уже к результату. Итерации повторяются, пока изображение
+* не перестанет меняться. Результат совпадает с циклом вызовов HitOrMiss::DoHitOrMiss
+* по каждой паре с выделением 1*1.
+*/
+class IterativeHitOrMiss {
+public:
+    /**
+    * @brief Действие с попаданиями пары
+    */
+    enum class Operation {
+        kThinning, /**< утончение: отмеченные пиксели становятся белыми */
+        kThickening /**< утолщение: отмеченные пиксели становятся черными */
+    };
+
+public:
+    /**
+    * @brief Конструктор по умолчанию: пустой набор, утончение
+    */
+    IterativeHitOrMiss() = default;
+
+    /**
+    * @brief Конструктор пустого набора с заданным действием
+    * @param[in] operation действие с попаданиями
+    */
+    explicit IterativeHitOrMiss(Operation operation);
+
+    /**
+    * @brief Добавить пару структурных элементов (см. HitOrMissBank::AddPattern)
+    * @return номер пары в наборе
+    * @throw invalid_argument если элемент пустой или размеры не соответствуют описанию
+    */
+    int AddPattern(cv::Mat kernel_foreground, cv::Mat kernel_background = cv::Mat());
+
+    /**
+    * @brief Набор утончения Гонсалеса и Вудса: 8 поворотов элемента 3*3
+    */
+    static IterativeHitOrMiss Thinning();
+
+    /**
+    * @brief Набор утолщения: элементы утончения с переставленными цветами
+    */
+    static IterativeHitOrMiss Thickening();
+
+    /**
+    * @brief Набор концевых точек для отсечения ветвей (утончение)
+    */
+    static IterativeHitOrMiss EndPoints();
+
+    /**
+    * @brief Применять набор до сходимости
+    * @param[in] image изображение CV_8UC1, бинаризуется как в HitOrMiss
+    * @param[in] max_iterations наибольшее количество итераций, 0 - без ограничения
+    * @return результат (0 - черный, 255 - белый)
+    * @throw invalid_argument если изображение пустое
+    */
+    cv::Mat Run(const cv::Mat& image, int max_iterations = 0);
+
+    /**
+    * @brief Остов: утончение набором Thinning() до сходимости
+    * @param[in] image изображение CV_8UC1
+    * @return остов толщиной в 1 пиксель с сохранением связности
+    */
+    static cv::Mat Skeleton(const cv::Mat& image);
+
+    /**
+    * @brief Отсечение паразитных ветвей остова длиной не больше length
+    *
+    * X1 - length итераций утончения набором EndPoints(), X2 - концевые точки X1,
+    * X3 - X2, length раз наращенное квадратом 3*3 внутри исходного изображения,
+    * результат - X1 + X3
+    * @param[in] image остов CV_8UC1
+    * @param[in] length длина отсекаемых ветвей
+    * @return остов без коротких ветвей
+    */
+    static cv::Mat Prune(const cv::Mat& image, int length);
+
+    /**
+    * @brief getter: действие с попаданиями
+    */
+    Operation get_operation() const { return operation_; }
+
+    /**
+    * @brief setter: действие с попаданиями
+    */
+    void set_operation(Operation operation) { operation_ = operation; }
+
+    /**
+    * @brief getter: набор пар
+    */
+    const HitOrMissBank& get_bank() const { return bank_; }
+
+    /**
+    * @brief getter: количество итераций последнего Run (включая последнюю, без изменений)
+    */
+    int get_iterations() const { return iterations_; }
+
+    /**
+    * @brief getter: количество проверенных окон за последний Run
+    */
+    int64_t get_evaluations() const { return evaluations_; }
+
+private:
+    // Пара в смещениях от центра окна для изображения с заданной шириной строки
+    struct Compiled {
+        std::vector<cv::Point> points; // смещения значимых пикселей от центра (x - столбец, y - строка)
+        std::vector<int> offsets; // те же смещения в пикселях построчного буфера
+        std::vector<uchar> black; // требуемые цвета значимых пикселей
+        int first_row = 0; // допустимые центры окна: строки [first_row, last_row]
+        int last_row = -1;
+        int first_col = 0; // и столбцы [first_col, last_col]
+        int last_col = -1;
+    };
+
+private:
+    // Скомпилировать пары набора под изображение rows*cols
+    std::vector<Compiled> Compile(int rows, int cols) const;
+
+private:
+    HitOrMissBank bank_; // пары структурных элементов
+    Operation operation_ = Operation::kThinning; // действие с попаданиями
+    int iterations_ = 0; // итераций последнего Run
+    int64_t evaluations_ = 0; // проверенных окон за последний Run
+};
+
+#endif
@@ -0,0 +1,195 @@
+﻿/**
+* @file neighborhood_table.hpp
+* @brief Проход структурными элементами до 3*3 через таблицу кодов окрестности
+*
+* Окно не больше 3*3 задается кодом не длиннее 9 бит (бит - черный пиксель), поэтому любая
+* пара элементов переднего и заднего плана такого размера - булева функция кода и заранее
+* сводится в таблицу из 512 записей. Код окна обновляется при сдвиге вдоль строки: старый
+* столбец уходит сдвигом, новый добавляется, и попадание находится одним обращением к таблице.
+* Таблицы встроенных наборов строятся при компиляции (constexpr), несколько пар одного
+* окна сливаются в одну таблицу: запись хранит маску всех совпавших пар.
+*
+* @author Kiselev K.A.
+* @date 17.10.2026
+*/
+
+#pragma once
+#ifndef HITORMISS_NEIGHBORHOOD_TABLE_HPP_20261017
+#define HITORMISS_NEIGHBORHOOD_TABLE_HPP_20261017
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <opencv2/opencv.hpp>
+
+#include<hitOrMiss/structuring_element.hpp>
+
+/**
+* @brief Таблица попаданий по коду окрестности окна до 3*3
+*
+* Бит col * rows + row кода - пиксель (row, col) окна, установлен для черного пикселя
+* (значение не больше 127, как после бинаризации в HitOrMiss). Запись таблицы - маска пар,
+* совпавших с окном: бит index установлен, если совпала пара с номером index.
+*/
+class NeighborhoodTable {
+public:
+    /**
+    * @brief Конструктор по умолчанию: пустая таблица окна 3*3
+    */
+    constexpr NeighborhoodTable() = default;
+
+    /**
+    * @brief Таблица одного скомпилированного элемента
+    * @param[in] element элемент, для которого Supports() == true
+    */
+    explicit NeighborhoodTable(const StructuringElement& element);
+
+    /**
+    * @brief Таблица окна 3*3 по набору пар, заданных строками (см. AddPattern)
+    */
+    template<size_t Count>
+    static constexpr NeighborhoodTable FromPatterns(const char* const (&patterns)[Count]) {
+        NeighborhoodTable table;
+        for (const char* pixels : patterns) {
+            table.AddPattern(pixels);
+        }
+        return table;
+    }
+
+    /**
+    * @brief Окно элемента не больше 3*3
+    */
+    static bool Supports(const StructuringElement& element) {
+        const cv::Size& size = element.get_size();
+        return size.width > 0 && size.height > 0 && size.width <= kMaxSide && size.height <= kMaxSide;
+    }
+
+    /**
+    * @brief Добавить пару окна 3*3, заданную построчно 9 символами
+    *
+    * '1' - пиксель должен быть черным, '0' - белым, 'x' - не имеет значения
+    * @return номер пары в таблице
+    * @throw invalid_argument если в таблице уже 64 пары или окно таблицы не 3*3
+    */
+    constexpr int AddPattern(const char* pixels) {
+        if (pattern_count_ == kMaxPatterns || rows_ != kMaxSide || cols_ != kMaxSide) {
+            throw std::invalid_argument("The neighborhood table cannot take the pattern");
+        }
+        const uint64_t bit = uint64_t{ 1 } << pattern_count_;
+        for (int code = 0; code < kEntries; code += 1) {
+            bool hit = true;
+            for (int index = 0; index < kMaxSide * kMaxSide && hit; index += 1) {
+                if (pixels[index] == 'x') continue;
+                const int shift = (index % kMaxSide) * kMaxSide + index / kMaxSide;
+                hit = ((code >> shift) & 1) == (pixels[index] == '1' ? 1 : 0);
+            }
+            if (hit) {
+                masks_[code] |= bit;
+            }
+        }
+        pattern_count_ += 1;
+        return pattern_count_ - 1;
+    }
+
+    /**
+    * @brief Добавить скомпилированный элемент того же размера окна, что и у таблицы
+    * @return номер пары в таблице
+    * @throw invalid_argument если в таблице уже 64 пары или размер окна другой
+    */
+    int AddPattern(const StructuringElement& element);
+
+    /**
+    * @brief Маска пар, совпавших с окном с кодом code
+    */
+    constexpr uint64_t Lookup(int code) const { return masks_[code]; }
+
+    /**
+    * @brief Проход по полосе строк [row_begin, row_end) левых верхних углов окон
+    *
+    * visit(row, col, mask) вызывается для каждого окна, целиком лежащего в изображении,
+    * по строкам слева направо; код окна обновляется при сдвиге на столбец
+    * @param[in] image изображение CV_8UC1
+    */
+    template<class Visit>
+    void Scan(const cv::Mat& image, int row_begin, int row_end, Visit&& visit) const {
+        // высота окна - параметр шаблона, чтобы сборка столбца развернулась в 1-3 чтения
+        switch (rows_) {
+        case 1: ScanRows<1>(image, row_begin, row_end, visit); break;
+        case 2: ScanRows<2>(image, row_begin, row_end, visit); break;
+        default: ScanRows<3>(image, row_begin, row_end, visit); break;
+        }
+    }
+
+    /**
+    * @brief Проход для полосы строк [row_begin, row_end) левых верхних углов окон
+    *
+    * Пишет только строки полосы, поэтому разные полосы можно обрабатывать параллельно
+    * @param[in] image изображение CV_8UC1
+    * @param[out] hits карта попаданий CV_8UC1 (1 - совпала хотя бы одна пара, 0 - нет) размера
+    * (rows - get_rows() + 1) * (cols - get_cols() + 1), уже созданная
+    */
+    void Match(const cv::Mat& image, int row_begin, int row_end, cv::Mat& hits) const;
+
+    /**
+    * @brief getter: количество строк окна
+    */
+    constexpr int get_rows() const { return rows_; }
+
+    /**
+    * @brief getter: количество столбцов окна
+    */
+    constexpr int get_cols() const { return cols_; }
+
+    /**
+    * @brief getter: количество пар в таблице
+    */
+    constexpr int get_pattern_count() const { return pattern_count_; }
+
+private:
+    // Scan для окна из Rows строк
+    template<int Rows, class Visit>
+    void ScanRows(const cv::Mat& image, int row_begin, int row_end, Visit& visit) const {
+        const int last_col = image.cols - cols_;
+        if (last_col < 0) {
+            return;
+        }
+        const int top_shift = (cols_ - 1) * Rows;
+        for (int row = row_begin; row < row_end; row += 1) {
+            const uchar* lines[Rows];
+            for (int line = 0; line < Rows; line += 1) {
+                lines[line] = image.ptr<uchar>(row + line);
+            }
+            // столбец окна: по биту на строку, черный пиксель (старший бит сброшен) - 1
+            auto column = [&](int col) {
+                int bits = 0;
+                for (int line = 0; line < Rows; line += 1) {
+                    bits |= ((lines[line][col] >> 7) ^ 1) << line;
+                }
+                return bits;
+            };
+            // первые столбцы кладутся на одну позицию выше: первый сдвиг вернет их на место
+            int code = 0;
+            for (int col = 0; col < cols_ - 1; col += 1) {
+                code |= column(col) << ((col + 1) * Rows);
+            }
+            for (int col = 0; col <= last_col; col += 1) {
+                code = (code >> Rows) | (column(col + cols_ - 1) << top_shift);
+                visit(row, col, masks_[code]);
+            }
+        }
+    }
+
+private:
+    static constexpr int kMaxSide = 3; // наибольшая сторона окна
+    static constexpr int kEntries = 512; // количество кодов окна 3*3
+    static constexpr int kMaxPatterns = 64; // пар в маске записи
+
+private:
+    int rows_ = kMaxSide; // количество строк окна
+    int cols_ = kMaxSide; // количество столбцов окна
+    int pattern_count_ = 0; // количество пар
+    std::array<uint64_t, kEntries> masks_{}; // маски совпавших пар по кодам окна
+};
+
+#endif
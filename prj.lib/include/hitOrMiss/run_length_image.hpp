@@ -0,0 +1,146 @@
+﻿/**
+* @file run_length_image.hpp
+* @brief Бинарное изображение в виде серий черных пикселей по строкам
+*
+* Отсканированные бланки почти целиком белые, и проход по всем положениям окна
+* тратит время на пустые области. Изображение хранится как списки серий черных
+* пикселей по строкам. Окна, где совпадает серия значимых пикселей элемента, образуют
+* по строке интервалы, которые находятся прямо по сериям изображения нужной длины,
+* и попадания элемента - пересечение этих интервалов. Операции над множествами
+* сливают списки серий. Время зависит от количества серий, а не пикселей.
+*
+* @author Kiselev K.A.
+* @date 17.10.2026
+*/
+
+#pragma once
+#ifndef HITORMISS_RUN_LENGTH_IMAGE_HPP_20261017
+#define HITORMISS_RUN_LENGTH_IMAGE_HPP_20261017
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include<hitOrMiss/structuring_element.hpp>
+
+/**
+* @brief Бинарное изображение, хранящее серии черных пикселей каждой строки
+*
+* Серии строки упорядочены по столбцам, не пересекаются и не соприкасаются.
+*/
+class RunLengthImage {
+public:
+    /**
+    * @brief Серия черных пикселей [begin, end) строки
+    */
+    struct Run {
+        int begin = 0; /**< первый столбец серии */
+        int end = 0; /**< столбец за последним пикселем серии */
+    };
+
+public:
+    /**
+    * @brief Конструктор по умолчанию: пустое изображение 0*0
+    */
+    RunLengthImage() = default;
+
+    /**
+    * @brief Конструктор белого изображения (без серий)
+    * @param[in] rows количество строк
+    * @param[in] cols количество столбцов
+    */
+    RunLengthImage(int rows, int cols);
+
+    /**
+    * @brief Построение по изображению CV_8UC1 (черный пиксель - не больше 127, как после бинаризации)
+    */
+    explicit RunLengthImage(const cv::Mat& image);
+
+    /**
+    * @brief Распаковать в изображение CV_8UC1 (0 - черный, 255 - белый)
+    * @param[out] dst изображение, пересоздается под размер серий
+    */
+    void Unpack(cv::Mat& dst) const;
+
+    /**
+    * @brief Пересечение множеств черных пикселей
+    */
+    static RunLengthImage And(const RunLengthImage& lhs, const RunLengthImage& rhs);
+
+    /**
+    * @brief Объединение множеств черных пикселей
+    */
+    static RunLengthImage Or(const RunLengthImage& lhs, const RunLengthImage& rhs);
+
+    /**
+    * @brief Вычитание множеств черных пикселей (lhs and not rhs)
+    */
+    static RunLengthImage Substraction(const RunLengthImage& lhs, const RunLengthImage& rhs);
+
+    /**
+    * @brief Проход по изображению структурным элементом
+    *
+    * Серия (row, [begin, end)) результата - левые верхние углы окон, которые целиком
+    * лежат в изображении и все значимые пиксели которых совпали
+    * @param[in] image изображение
+    * @param[in] element скомпилированный структурный элемент
+    * @return попадания размера (rows - element.rows + 1) * (cols - element.cols + 1),
+    * пустое, если элемент больше изображения
+    */
+    static RunLengthImage Match(const RunLengthImage& image, const StructuringElement& element);
+
+    /**
+    * @brief Выделение попаданий
+    *
+    * Для каждого попадания закрашивает пиксели, смещенные от левого верхнего угла окна на offsets
+    * @param[in] hits попадания по левым верхним углам окон
+    * @param[in] offsets смещения закрашиваемых пикселей (x - столбец, y - строка)
+    * @param[in] size размер результата, в который попадают все смещенные пиксели
+    * @return результат размера size
+    */
+    static RunLengthImage Stamp(const RunLengthImage& hits, const std::vector<cv::Point>& offsets, const cv::Size& size);
+
+    /**
+    * @brief getter: количество строк
+    */
+    int get_rows() const { return rows_; }
+
+    /**
+    * @brief getter: количество столбцов
+    */
+    int get_cols() const { return cols_; }
+
+    /**
+    * @brief getter: количество серий во всем изображении
+    */
+    int get_run_count() const { return static_cast<int>(runs_.size()); }
+
+    /**
+    * @brief Изображение 0*0
+    */
+    bool empty() const { return rows_ == 0 || cols_ == 0; }
+
+    /**
+    * @brief Первая серия строки
+    */
+    const Run* RowBegin(int row) const { return runs_.data() + row_start_[row]; }
+
+    /**
+    * @brief За последней серией строки
+    */
+    const Run* RowEnd(int row) const { return runs_.data() + row_start_[row + 1]; }
+
+private:
+    // Начать изображение rows*cols без строк, строки добавляются AppendRow по порядку
+    void Reset(int rows, int cols);
+
+    // Добавить следующую строку
+    void AppendRow(const std::vector<Run>& runs);
+
+private:
+    int rows_ = 0; // количество строк
+    int cols_ = 0; // количество столбцов
+    std::vector<Run> runs_; // серии всех строк подряд
+    std::vector<int> row_start_; // первая серия строки row - runs_[row_start_[row]], rows_ + 1 значений (у 0*0 пусто)
+};
+
+#endif
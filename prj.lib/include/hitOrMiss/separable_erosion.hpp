@@ -0,0 +1,62 @@
+﻿/**
+* @file separable_erosion.hpp
+* @brief Проход сплошным прямоугольным структурным элементом за O(1) на пиксель
+*
+* Если значимые пиксели элемента одного цвета и заполняют прямоугольник (в том числе
+* линию), совпадение окна - это эрозия по прямоугольнику, которая разделяется на проход
+* по строкам и проход по столбцам. Каждый проход - алгоритм ван Херка / Гиля-Вермана:
+* отрезок разбивается на блоки длины окна, и and окна собирается из суффикса одного блока
+* и префикса следующего, поэтому стоимость не зависит от размера элемента.
+*
+* @author Kiselev K.A.
+* @date 17.10.2026
+*/
+
+#pragma once
+#ifndef HITORMISS_SEPARABLE_EROSION_HPP_20261017
+#define HITORMISS_SEPARABLE_EROSION_HPP_20261017
+
+#include <opencv2/opencv.hpp>
+
+#include<hitOrMiss/bit_plane.hpp>
+#include<hitOrMiss/structuring_element.hpp>
+
+/**
+* @brief Разделимый проход сплошным прямоугольным структурным элементом
+*
+* Результат совпадает с проходом по списку значимых пикселей.
+*/
+class SeparableErosion {
+public:
+    /**
+    * @brief Элемент - сплошной прямоугольник, достаточно большой, чтобы разделимый проход был выгоднее
+    */
+    static bool Supports(const StructuringElement& element);
+
+    /**
+    * @brief Проход по изображению CV_8UC1 для полосы строк [row_begin, row_end) левых верхних углов окон
+    *
+    * Пишет только строки полосы, поэтому разные полосы можно обрабатывать параллельно
+    * @param[in] image бинарное изображение
+    * @param[in] element элемент, для которого Supports() == true
+    * @param[out] hits карта попаданий CV_8UC1 (1 - попадание, 0 - нет) размера
+    * (image.rows - rows + 1) * (image.cols - cols + 1), уже созданная
+    */
+    static void Match(const cv::Mat& image, const StructuringElement& element,
+        int row_begin, int row_end, cv::Mat& hits);
+
+    /**
+    * @brief Проход по упакованному изображению, как BitPlane::Match с полосой строк
+    *
+    * По строке and отрезка собирается сдвигами с удвоением длины (64 окна на слово),
+    * по столбцам - блоками ван Херка / Гиля-Вермана
+    * @param[in] image упакованное изображение
+    * @param[in] element элемент, для которого Supports() == true
+    * @param[in] offset смещение записываемого бита от левого верхнего угла окна (внутри окна)
+    * @param[out] dst результат, уже созданный под размер image
+    */
+    static void Match(const BitPlane& image, const StructuringElement& element, const cv::Point& offset,
+        int row_begin, int row_end, BitPlane& dst);
+};
+
+#endif
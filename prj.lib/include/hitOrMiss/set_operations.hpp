@@ -0,0 +1,67 @@
+﻿/**
+* @file set_operations.hpp
+* @brief Операции над бинарными изображениями как над множествами
+*
+* Черный пиксель (0) считается логической 1, любой другой - логическим 0.
+* Строки обрабатываются целиком векторными инструкциями (SSE2/AVX2/AVX-512),
+* набор инструкций выбирается во время выполнения по возможностям процессора,
+* при их отсутствии используется скалярная реализация.
+*
+* @author Kiselev K.A.
+* @date 17.10.2026
+*/
+
+#pragma once
+#ifndef HITORMISS_SET_OPERATIONS_HPP_20261017
+#define HITORMISS_SET_OPERATIONS_HPP_20261017
+
+#include <opencv2/opencv.hpp>
+
+/**
+* @brief Операции and, or и вычитание над бинарными изображениями CV_8UC1
+*
+* Результат всегда состоит из 0 и 255 и не зависит от выбранного набора инструкций.
+* Выходное изображение пересоздается под размер входных, если нужно.
+*/
+class SetOperations {
+public:
+    /**
+    * @brief Набор инструкций реализации
+    */
+    enum class Isa {
+        kScalar, /**< скалярная реализация */
+        kSse2, /**< 16 пикселей за инструкцию */
+        kAvx2, /**< 32 пикселя за инструкцию */
+        kAvx512 /**< 64 пикселя за инструкцию (AVX-512BW) */
+    };
+
+    /**
+    * @brief Лучший набор инструкций, поддерживаемый процессором
+    */
+    static Isa BestIsa();
+
+    /**
+    * @brief Поддерживается ли набор инструкций процессором
+    */
+    static bool IsSupported(Isa isa);
+
+    /**
+    * @brief Пересечение: черный, если черные оба пикселя
+    * @throw cv::Exception если изображения разного размера или типа не CV_8UC1
+    */
+    static void And(const cv::Mat& lhs, const cv::Mat& rhs, cv::Mat& dst, Isa isa = BestIsa());
+
+    /**
+    * @brief Объединение: черный, если черный хотя бы один пиксель
+    * @throw cv::Exception если изображения разного размера или типа не CV_8UC1
+    */
+    static void Or(const cv::Mat& lhs, const cv::Mat& rhs, cv::Mat& dst, Isa isa = BestIsa());
+
+    /**
+    * @brief Вычитание: черный, если пиксель lhs черный, а rhs - нет
+    * @throw cv::Exception если изображения разного размера или типа не CV_8UC1
+    */
+    static void Substraction(const cv::Mat& lhs, const cv::Mat& rhs, cv::Mat& dst, Isa isa = BestIsa());
+};
+
+#endif
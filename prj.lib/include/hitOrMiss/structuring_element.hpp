@@ -0,0 +1,213 @@
+﻿/**
+* @file structuring_element.hpp
+* @brief Скомпилированный структурный элемент
+*
+* Структурный элемент переводится в список значимых пикселей один раз,
+* при установке, и проход по изображению обходит только этот список,
+* пропуская пиксели, которые не имеют значения.
+*
+* @author Kiselev K.A.
+* @date 17.10.2026
+*/
+
+#pragma once
+#ifndef HITORMISS_STRUCTURING_ELEMENT_HPP_20261017
+#define HITORMISS_STRUCTURING_ELEMENT_HPP_20261017
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+/**
+* @brief Значимый пиксель окна структурного элемента
+*/
+struct CarePixel {
+    int row = 0; /**< строка в окне */
+    int col = 0; /**< столбец в окне */
+    bool black = true; /**< требуемый цвет пикселя изображения: true - черный, false - белый */
+};
+
+/**
+* @brief Структурный элемент в виде списка значимых пикселей
+*
+* Для элемента переднего плана значимы черные пиксели (в изображении должны быть черными),
+* для элемента заднего плана - белые (в изображении должны быть белыми).
+* Значимые пиксели хранятся построчно, чтобы строка изображения выбиралась один раз на строку элемента.
+*/
+class StructuringElement {
+public:
+    /**
+    * @brief Значимые пиксели одной строки окна
+    */
+    struct CareRow {
+        int row = 0; /**< строка в окне */
+        int begin = 0; /**< первый значимый пиксель строки в get_care() */
+        int end = 0; /**< за последним значимым пикселем строки в get_care() */
+    };
+
+    /**
+    * @brief Прямоугольник разложения значимых пикселей одного цвета
+    *
+    * Количество значимых пикселей цвета black в любом наборе пикселей окна равно
+    * сумме количеств по прямоугольникам этого цвета, взятых со знаком sign
+    */
+    struct CareRectangle {
+        cv::Rect rect; /**< прямоугольник в окне */
+        int sign = 1; /**< +1 - пиксели прямоугольника значимы, -1 - вычитаются из предыдущих */
+        bool black = true; /**< цвет значимых пикселей */
+    };
+
+public:
+    /**
+    * @brief Конструктор по умолчанию: пустой элемент 0*0 без значимых пикселей
+    */
+    StructuringElement() = default;
+
+    /**
+    * @brief Компиляция структурного элемента
+    * @param[in] kernel бинарный структурный элемент CV_8UC1
+    * @param[in] foreground true - элемент переднего плана, false - заднего
+    */
+    StructuringElement(const cv::Mat& kernel, bool foreground);
+
+    /**
+    * @brief Объединение двух элементов в общем окне
+    *
+    * Окно совпадает, только если совпали оба элемента; пиксели lhs проверяются первыми
+    * @param[in] lhs первый элемент
+    * @param[in] lhs_shift левый верхний угол lhs в общем окне
+    * @param[in] rhs второй элемент
+    * @param[in] rhs_shift левый верхний угол rhs в общем окне
+    * @param[in] size размер общего окна
+    */
+    static StructuringElement Combine(const StructuringElement& lhs, const cv::Point& lhs_shift,
+        const StructuringElement& rhs, const cv::Point& rhs_shift, const cv::Size& size);
+
+    /**
+    * @brief Упорядочить строки значимых пикселей по вероятности несовпадения с изображением
+    *
+    * Переставляются строки целиком, и каждая строка остается одной CareRow. На равномерной
+    * выборке окон изображения первыми ставятся строки, отвергающие больше всего еще не отвергнутых
+    * окон на сравнение, остальные - по доле отвергнутых окон выборки на сравнение; внутри строки
+    * первыми идут чаще не совпадающие пиксели. У объединенного элемента строки переставляются
+    * внутри своей части, и пиксели lhs по-прежнему проверяются первыми.
+    * Меняется только порядок проверки, множество значимых пикселей остается прежним.
+    * Если окон в изображении мало и выборка не окупится, порядок не меняется.
+    * Буферы выборки хранятся в элементе, и повторные вызовы память не выделяют
+    * @param[in] image бинарное изображение CV_8UC1 (0 и 255)
+    */
+    void OrderProbes(const cv::Mat& image);
+
+    /**
+    * @brief Совпадение с окном изображения CV_8UC1
+    *
+    * Окно с левым верхним углом в (mask_row, mask_col) должно целиком лежать в изображении
+    * @return true, если все значимые пиксели совпали
+    */
+    bool Match(const cv::Mat& image, int mask_row, int mask_col) const {
+        for (const CareRow& care_row : rows_) {
+            const uchar* image_row = image.ptr<uchar>(mask_row + care_row.row) + mask_col;
+            for (int index = care_row.begin; index < care_row.end; index += 1) {
+                const CarePixel& pixel = care_[index];
+                if ((image_row[pixel.col] == 0) != pixel.black) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+    * @brief Совпадение с окном изображения с подсчетом сравненных пикселей (для статистики)
+    * @param[out] compared сколько значимых пикселей сравнено до первого несовпадения или всего
+    * @return true, если все значимые пиксели совпали
+    */
+    bool Match(const cv::Mat& image, int mask_row, int mask_col, int& compared) const {
+        compared = 0;
+        for (const CareRow& care_row : rows_) {
+            const uchar* image_row = image.ptr<uchar>(mask_row + care_row.row) + mask_col;
+            for (int index = care_row.begin; index < care_row.end; index += 1) {
+                const CarePixel& pixel = care_[index];
+                compared += 1;
+                if ((image_row[pixel.col] == 0) != pixel.black) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+    * @brief getter: размер окна
+    */
+    const cv::Size& get_size() const { return size_; }
+
+    /**
+    * @brief getter: значимые пиксели в порядке проверки
+    */
+    const std::vector<CarePixel>& get_care() const { return care_; }
+
+    /**
+    * @brief getter: строки окна, в которых есть значимые пиксели
+    */
+    const std::vector<CareRow>& get_rows() const { return rows_; }
+
+    /**
+    * @brief getter: ограничивающий прямоугольник значимых пикселей в окне
+    */
+    const cv::Rect& get_bounds() const { return bounds_; }
+
+    /**
+    * @brief Значимые пиксели одного цвета и заполняют свой ограничивающий прямоугольник целиком
+    *
+    * Это сплошной прямоугольник или линия (прямоугольник высоты или ширины 1)
+    */
+    bool IsRectangle() const { return rectangle_; }
+
+    /**
+    * @brief getter: разложение значимых пикселей на прямоугольники со знаком
+    *
+    * Для каждого цвета выбирается меньшее из двух разложений: непересекающиеся
+    * прямоугольники значимых пикселей или ограничивающий прямоугольник за вычетом
+    * непересекающихся прямоугольников пропусков (рамка - два прямоугольника)
+    */
+    const std::vector<CareRectangle>& get_rectangles() const { return rectangles_; }
+
+private:
+    // Буферы OrderProbes
+    struct OrderScratch {
+        int samples = 0; // окон выборки
+        std::vector<uchar> mismatch; // несовпадения пикселей в окнах выборки, по пикселям
+        std::vector<int> failures; // отвергнутых окон выборки на пиксель
+        std::vector<CareRow> units; // строки упорядочиваемой части (begin, end - индексы в care_)
+        std::vector<uchar> unit_mismatch; // несовпадения строк в окнах выборки, по строкам
+        std::vector<int> unit_failures; // отвергнутых окон выборки на строку
+        std::vector<int> survivors; // окна выборки, еще не отвергнутые выбранными строками
+        std::vector<int> order; // новый порядок строк части
+        std::vector<uchar> taken; // строка уже в новом порядке
+        std::vector<CarePixel> care; // пиксели в новом порядке
+    };
+
+    // Построить строки и описание формы по списку значимых пикселей
+    void Finalize();
+
+    // Сгруппировать значимые пиксели в строки в порядке проверки
+    void BuildRows();
+
+    // Дописать в order_scratch_.care строки пикселей care_[begin, end) в порядке OrderProbes
+    void OrderPart(int begin, int end);
+
+    // Разложить значимые пиксели цвета black на прямоугольники со знаком
+    void Decompose(bool black);
+
+private:
+    cv::Size size_; // размер окна
+    std::vector<CarePixel> care_; // значимые пиксели
+    std::vector<CareRow> rows_; // значимые пиксели, сгруппированные по строкам
+    cv::Rect bounds_; // ограничивающий прямоугольник значимых пикселей
+    bool rectangle_ = false; // значимые пиксели образуют сплошной прямоугольник одного цвета
+    std::vector<CareRectangle> rectangles_; // разложение значимых пикселей на прямоугольники
+    int lhs_count_ = 0; // пикселей lhs в начале care_ у объединенного элемента, иначе всех пикселей
+    OrderScratch order_scratch_; // буферы OrderProbes
+};
+
+#endif
@@ -0,0 +1,90 @@
+﻿/**
+* @file summed_area_table.hpp
+* @brief Проход структурным элементом по интегральному изображению
+*
+* Интегральное изображение хранит количество черных пикселей в прямоугольнике
+* от начала изображения, поэтому количество черных пикселей в любом прямоугольнике
+* находится за 4 обращения. Элемент, значимые пиксели которого раскладываются на
+* небольшое число прямоугольников (блок, рамка = внешний прямоугольник минус внутренний),
+* проверяется в каждом окне за время, пропорциональное числу прямоугольников.
+*
+* @author Kiselev K.A.
+* @date 17.10.2026
+*/
+
+#pragma once
+#ifndef HITORMISS_SUMMED_AREA_TABLE_HPP_20261017
+#define HITORMISS_SUMMED_AREA_TABLE_HPP_20261017
+
+#include <cstdint>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include<hitOrMiss/structuring_element.hpp>
+
+/**
+* @brief Интегральное изображение количества черных пикселей
+*
+* Окно совпадает, если в черных значимых пикселях столько черных пикселей изображения,
+* сколько этих значимых пикселей, а в белых значимых пикселях черных нет.
+*/
+class SummedAreaTable {
+public:
+    /**
+    * @brief Конструктор по умолчанию: пустая таблица
+    */
+    SummedAreaTable() = default;
+
+    /**
+    * @brief Построение по бинарному изображению CV_8UC1 (черный пиксель - 0)
+    */
+    explicit SummedAreaTable(const cv::Mat& image);
+
+    /**
+    * @brief Перестроить по бинарному изображению CV_8UC1 (память переиспользуется)
+    */
+    void Build(const cv::Mat& image);
+
+    /**
+    * @brief Сделать таблицу пустой, сохранив память под следующее построение
+    */
+    void clear() { rows_ = 0; cols_ = 0; stride_ = 0; sums_.clear(); }
+
+    /**
+    * @brief Элемент раскладывается на меньшее число прямоугольников, чем у него значимых пикселей
+    */
+    static bool Supports(const StructuringElement& element);
+
+    /**
+    * @brief Проход для полосы строк [row_begin, row_end) левых верхних углов окон
+    *
+    * Пишет только строки полосы, поэтому разные полосы можно обрабатывать параллельно
+    * @param[in] element элемент, для которого Supports() == true
+    * @param[out] hits карта попаданий CV_8UC1 (1 - попадание, 0 - нет) размера
+    * (rows - element.rows + 1) * (cols - element.cols + 1), уже созданная
+    */
+    void Match(const StructuringElement& element, int row_begin, int row_end, cv::Mat& hits) const;
+
+    /**
+    * @brief Проход по прямоугольнику windows левых верхних углов окон
+    *
+    * Пишет только попадания окон из windows
+    * @param[in] element элемент, для которого Supports() == true
+    * @param[in] windows прямоугольник левых верхних углов окон
+    * @param[out] hits карта попаданий CV_8UC1, как для прохода по полосе
+    */
+    void Match(const StructuringElement& element, const cv::Rect& windows, cv::Mat& hits) const;
+
+    /**
+    * @brief Таблица не построена
+    */
+    bool empty() const { return sums_.empty(); }
+
+private:
+    int rows_ = 0; // количество строк изображения
+    int cols_ = 0; // количество столбцов изображения
+    int stride_ = 0; // шаг между строками таблицы (cols_ + 1)
+    std::vector<int32_t> sums_; // (rows_ + 1) * (cols_ + 1) сумм, нулевые первые строка и столбец
+};
+
+#endif
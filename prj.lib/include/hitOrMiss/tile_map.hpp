@@ -0,0 +1,125 @@
+﻿/**
+* @file tile_map.hpp
+* @brief Карта заполнения изображения по тайлам
+*
+* Изображение делится на тайлы 32*32, для каждого запоминается, белый он целиком,
+* черный целиком или смешанный. Окно, которое видит только белые (или только черные)
+* пиксели, дает один и тот же результат в любом положении, поэтому для однородных
+* областей результат прохода известен без проверки пикселей.
+*
+* @author Kiselev K.A.
+* @date 17.10.2026
+*/
+
+#pragma once
+#ifndef HITORMISS_TILE_MAP_HPP_20261017
+#define HITORMISS_TILE_MAP_HPP_20261017
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include<hitOrMiss/bit_plane.hpp>
+
+/**
+* @brief Состояние тайлов 32*32 бинарного изображения
+*
+* Последние строка и столбец тайлов могут быть неполными. Количество белых и черных
+* тайлов в любом прямоугольнике тайлов находится за 4 обращения к накопленным суммам.
+*/
+class TileMap {
+public:
+    /**
+    * @brief Состояние тайла или области
+    */
+    enum class Tile : uchar {
+        kWhite, /**< все пиксели белые */
+        kBlack, /**< все пиксели черные */
+        kMixed /**< есть пиксели обоих цветов */
+    };
+
+    static constexpr int kTileSize = 32; /**< сторона тайла в пикселях */
+
+public:
+    /**
+    * @brief Конструктор по умолчанию: пустая карта
+    */
+    TileMap() = default;
+
+    /**
+    * @brief Построение по упакованному изображению (по 32 пикселя строки за операцию)
+    */
+    explicit TileMap(const BitPlane& image);
+
+    /**
+    * @brief Перестроить по упакованному изображению (память переиспользуется)
+    */
+    void Build(const BitPlane& image);
+
+    /**
+    * @brief Пересчитать тайлы, которые задевает прямоугольник, после изменения изображения
+    * @param[in] image изображение, по которому построена карта
+    * @param[in] pixels непустой прямоугольник внутри изображения
+    */
+    void Update(const BitPlane& image, const cv::Rect& pixels);
+
+    /**
+    * @brief Состояние тайла
+    */
+    Tile At(int tile_row, int tile_col) const { return tiles_[static_cast<size_t>(tile_row) * tile_cols_ + tile_col]; }
+
+    /**
+    * @brief Состояние области изображения: kWhite или kBlack, если все тайлы,
+    * которые она задевает, этого цвета, иначе kMixed
+    * @param[in] pixels непустой прямоугольник внутри изображения
+    */
+    Tile Region(const cv::Rect& pixels) const;
+
+    /**
+    * @brief Состояние всех пикселей, которые видят окна размера window
+    * с левыми верхними углами в windows (окна лежат в изображении)
+    */
+    Tile Windows(const cv::Rect& windows, const cv::Size& window) const {
+        return Region(cv::Rect(windows.x, windows.y,
+            windows.width + window.width - 1, windows.height + window.height - 1));
+    }
+
+    /**
+    * @brief Есть хотя бы один однородный тайл
+    */
+    bool HasUniform() const { return uniform_count_ > 0; }
+
+    /**
+    * @brief Карта не построена
+    */
+    bool empty() const { return tiles_.empty(); }
+
+    /**
+    * @brief getter: количество строк тайлов
+    */
+    int get_tile_rows() const { return tile_rows_; }
+
+    /**
+    * @brief getter: количество столбцов тайлов
+    */
+    int get_tile_cols() const { return tile_cols_; }
+
+private:
+    // Состояние тайла по упакованному изображению (по 32 пикселя строки за операцию)
+    Tile Classify(const BitPlane& image, int tile_row, int tile_col) const;
+
+    // Накопленные суммы белых и черных тайлов по tiles_
+    void BuildSums();
+
+    // Количество тайлов в прямоугольнике тайлов [top, bottom) * [left, right) по накопленным суммам
+    int Count(const std::vector<int>& sums, int top, int left, int bottom, int right) const;
+
+private:
+    int tile_rows_ = 0; // количество строк тайлов
+    int tile_cols_ = 0; // количество столбцов тайлов
+    int uniform_count_ = 0; // количество однородных тайлов
+    std::vector<Tile> tiles_; // состояния тайлов построчно
+    std::vector<int> white_sums_; // (tile_rows_ + 1) * (tile_cols_ + 1) накопленных количеств белых тайлов
+    std::vector<int> black_sums_; // то же для черных тайлов
+};
+
+#endif
@@ -0,0 +1,262 @@
+#include<hitOrMiss/iterative_hit_or_miss.hpp>
+#include<hitOrMiss/neighborhood_table.hpp>
+
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+const int kWhite = 255; // код белого пикселя
+const int kBlack = 0; // код черного пикселя
+const int kThresholdValue = 127; // пороговое значение бинаризации, как в HitOrMiss
+
+// Элементы утончения Гонсалеса и Вудса: '1' - черный, '0' - белый, 'x' - не имеет значения
+constexpr const char* kThinningElements[] = { "000x1x111", "x0011011x", "1x01101x0", "11x110x00",
+    "111x1x000", "x1101100x", "0x10110x1", "00x011x11" };
+
+// Элементы концевых точек для отсечения ветвей
+constexpr const char* kEndPointElements[] = { "x00110x00", "x1x010000", "00x01100x", "000010x1x",
+    "100010000", "001010000", "000010001", "000010100" };
+
+// Таблица концевых точек строится при компиляции
+constexpr NeighborhoodTable kEndPointTable = NeighborhoodTable::FromPatterns(kEndPointElements);
+
+// Добавить пару элементов 3*3, заданную строкой из 9 символов; swap_colors меняет '0' и '1' местами
+void AddElement(IterativeHitOrMiss& set, const char* pixels, bool swap_colors) {
+    cv::Mat foreground{ 3, 3, CV_8UC1, cv::Scalar(kWhite) };
+    cv::Mat background{ 3, 3, CV_8UC1, cv::Scalar(kBlack) };
+    for (int index = 0; index < 9; index += 1) {
+        if (pixels[index] == 'x') continue;
+        // пиксели переднего плана значимы черными, заднего - белыми
+        if ((pixels[index] == '1') != swap_colors) {
+            foreground.at<uchar>(index / 3, index % 3) = kBlack;
+        }
+        else {
+            background.at<uchar>(index / 3, index % 3) = kWhite;
+        }
+    }
+    set.AddPattern(foreground, background);
+}
+
+}
+
+IterativeHitOrMiss::IterativeHitOrMiss(Operation operation)
+    : operation_(operation) {
+}
+
+int IterativeHitOrMiss::AddPattern(cv::Mat kernel_foreground, cv::Mat kernel_background) {
+    return bank_.AddPattern(kernel_foreground, kernel_background);
+}
+
+IterativeHitOrMiss IterativeHitOrMiss::Thinning() {
+    IterativeHitOrMiss thinning(Operation::kThinning);
+    for (const char* pixels : kThinningElements) {
+        AddElement(thinning, pixels, false);
+    }
+    return thinning;
+}
+
+IterativeHitOrMiss IterativeHitOrMiss::Thickening() {
+    IterativeHitOrMiss thickening(Operation::kThickening);
+    for (const char* pixels : kThinningElements) {
+        AddElement(thickening, pixels, true);
+    }
+    return thickening;
+}
+
+IterativeHitOrMiss IterativeHitOrMiss::EndPoints() {
+    IterativeHitOrMiss end_points(Operation::kThinning);
+    for (const char* pixels : kEndPointElements) {
+        AddElement(end_points, pixels, false);
+    }
+    return end_points;
+}
+
+std::vector<IterativeHitOrMiss::Compiled> IterativeHitOrMiss::Compile(int rows, int cols) const {
+    std::vector<Compiled> compiled(bank_.get_pattern_count());
+    for (int index = 0; index < bank_.get_pattern_count(); index += 1) {
+        const HitOrMissBank::Pattern& pattern = bank_.get_pattern(index);
+        const cv::Size& window = pattern.element.get_size();
+        Compiled& result = compiled[index];
+        for (const CarePixel& pixel : pattern.element.get_care()) {
+            const cv::Point offset(pixel.col - pattern.center.x, pixel.row - pattern.center.y);
+            result.points.push_back(offset);
+            result.offsets.push_back(offset.y * cols + offset.x);
+            result.black.push_back(pixel.black ? 1 : 0);
+        }
+        // окно должно целиком лежать в изображении
+        result.first_row = pattern.center.y;
+        result.last_row = rows - window.height + pattern.center.y;
+        result.first_col = pattern.center.x;
+        result.last_col = cols - window.width + pattern.center.x;
+    }
+    return compiled;
+}
+
+cv::Mat IterativeHitOrMiss::Run(const cv::Mat& image, int max_iterations) {
+    if (image.empty()) {
+        throw std::invalid_argument("The uploaded image was empty");
+    }
+    CV_Assert(image.type() == CV_8UC1);
+
+    const int rows = image.rows;
+    const int cols = image.cols;
+    // 1 - черный пиксель, 0 - белый
+    std::vector<uchar> pixels(static_cast<size_t>(rows) * cols);
+    for (int row = 0; row < rows; row += 1) {
+        const uchar* image_row = image.ptr<uchar>(row);
+        for (int col = 0; col < cols; col += 1) {
+            pixels[static_cast<size_t>(row) * cols + col] = image_row[col] <= kThresholdValue ? 1 : 0;
+        }
+    }
+
+    const std::vector<Compiled> compiled = Compile(rows, cols);
+    const size_t pattern_count = compiled.size();
+
+    // очереди центров окон, которые нужно проверить каждой паре, и отметки "уже в очереди";
+    // попадание в пиксель, уже имеющий цвет результата, ничего не меняет, такие центры не проверяются
+    const uchar target = operation_ == Operation::kThinning ? 0 : 1;
+    std::vector<std::vector<int>> queues(pattern_count);
+    std::vector<std::vector<uchar>> queued(pattern_count, std::vector<uchar>(pixels.size(), 0));
+    for (size_t index = 0; index < pattern_count; index += 1) {
+        const Compiled& pattern = compiled[index];
+        for (int row = pattern.first_row; row <= pattern.last_row; row += 1) {
+            for (int col = pattern.first_col; col <= pattern.last_col; col += 1) {
+                if (pixels[row * cols + col] != target) {
+                    queues[index].push_back(row * cols + col);
+                    queued[index][row * cols + col] = 1;
+                }
+            }
+        }
+    }
+
+    iterations_ = 0;
+    evaluations_ = 0;
+    std::vector<int> current;
+    std::vector<int> hits;
+    while (max_iterations <= 0 || iterations_ < max_iterations) {
+        iterations_ += 1;
+        bool changed = false;
+        for (size_t index = 0; index < pattern_count; index += 1) {
+            const Compiled& pattern = compiled[index];
+            current.clear();
+            std::swap(current, queues[index]);
+
+            // сначала все попадания пары, затем изменения: пара применяется к изображению целиком
+            hits.clear();
+            for (int center : current) {
+                queued[index][center] = 0;
+                if (pixels[center] == target) continue;
+                evaluations_ += 1;
+                bool hit = true;
+                for (size_t care = 0; care < pattern.offsets.size() && hit; care += 1) {
+                    hit = pixels[center + pattern.offsets[care]] == pattern.black[care];
+                }
+                if (hit) {
+                    hits.push_back(center);
+                }
+            }
+
+            // измененный пиксель заново ставит в очередь все окна, для которых он значим
+            for (int pixel : hits) {
+                pixels[pixel] = target;
+                changed = true;
+                const int pixel_row = pixel / cols;
+                const int pixel_col = pixel % cols;
+                for (size_t other = 0; other < pattern_count; other += 1) {
+                    const Compiled& affected = compiled[other];
+                    for (size_t care = 0; care < affected.points.size(); care += 1) {
+                        const int row = pixel_row - affected.points[care].y;
+                        const int col = pixel_col - affected.points[care].x;
+                        if (row < affected.first_row || row > affected.last_row
+                            || col < affected.first_col || col > affected.last_col) {
+                            continue;
+                        }
+                        const int center = row * cols + col;
+                        if (!queued[other][center]) {
+                            queued[other][center] = 1;
+                            queues[other].push_back(center);
+                        }
+                    }
+                }
+            }
+        }
+        if (!changed) {
+            break;
+        }
+    }
+
+    cv::Mat result{ rows, cols, CV_8UC1 };
+    for (int row = 0; row < rows; row += 1) {
+        uchar* result_row = result.ptr<uchar>(row);
+        for (int col = 0; col < cols; col += 1) {
+            result_row[col] = pixels[static_cast<size_t>(row) * cols + col] ? kBlack : kWhite;
+        }
+    }
+    return result;
+}
+
+cv::Mat IterativeHitOrMiss::Skeleton(const cv::Mat& image) {
+    IterativeHitOrMiss thinning = Thinning();
+    return thinning.Run(image);
+}
+
+cv::Mat IterativeHitOrMiss::Prune(const cv::Mat& image, int length) {
+    if (image.empty()) {
+        throw std::invalid_argument("The uploaded image was empty");
+    }
+    if (length < 0) {
+        throw std::invalid_argument("The pruning length was negative");
+    }
+    CV_Assert(image.type() == CV_8UC1);
+    cv::Mat source;
+    cv::threshold(image, source, kThresholdValue, kWhite, cv::THRESH_BINARY);
+    if (length == 0) {
+        return source;
+    }
+
+    IterativeHitOrMiss end_points = EndPoints();
+    cv::Mat result = end_points.Run(source, length);
+
+    // концевые точки остатка наращиваются обратно вдоль исходных ветвей: поиск в ширину
+    // на length шагов по 8-связным черным пикселям исходного изображения
+    std::vector<cv::Point> frontier;
+    kEndPointTable.Scan(result, 0, result.rows - 2, [&](int row, int col, uint64_t mask) {
+        if (mask != 0) {
+            frontier.emplace_back(col + 1, row + 1);
+        }
+    });
+    cv::Mat grown{ source.rows, source.cols, CV_8UC1, cv::Scalar(0) };
+    for (const cv::Point& point : frontier) {
+        grown.at<uchar>(point) = 1;
+    }
+    std::vector<cv::Point> next;
+    for (int step = 0; step < length && !frontier.empty(); step += 1) {
+        next.clear();
+        for (const cv::Point& point : frontier) {
+            for (int dy = -1; dy <= 1; dy += 1) {
+                for (int dx = -1; dx <= 1; dx += 1) {
+                    const cv::Point neighbour(point.x + dx, point.y + dy);
+                    if (neighbour.x < 0 || neighbour.y < 0 || neighbour.x >= source.cols || neighbour.y >= source.rows) {
+                        continue;
+                    }
+                    if (grown.at<uchar>(neighbour) || source.at<uchar>(neighbour) != kBlack) {
+                        continue;
+                    }
+                    grown.at<uchar>(neighbour) = 1;
+                    next.push_back(neighbour);
+                }
+            }
+        }
+        std::swap(frontier, next);
+    }
+
+    for (int row = 0; row < result.rows; row += 1) {
+        for (int col = 0; col < result.cols; col += 1) {
+            if (grown.at<uchar>(row, col)) {
+                result.at<uchar>(row, col) = kBlack;
+            }
+        }
+    }
+    return result;
+}
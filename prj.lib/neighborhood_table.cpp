@@ -0,0 +1,44 @@
+#include<hitOrMiss/neighborhood_table.hpp>
+
+NeighborhoodTable::NeighborhoodTable(const StructuringElement& element) {
+    CV_Assert(Supports(element));
+    rows_ = element.get_size().height;
+    cols_ = element.get_size().width;
+    AddPattern(element);
+}
+
+int NeighborhoodTable::AddPattern(const StructuringElement& element) {
+    if (pattern_count_ == kMaxPatterns
+        || element.get_size().height != rows_ || element.get_size().width != cols_) {
+        throw std::invalid_argument("The neighborhood table cannot take the pattern");
+    }
+
+    // маски значимых пикселей и их требуемых цветов в битах кода
+    int care = 0;
+    int black = 0;
+    for (const CarePixel& pixel : element.get_care()) {
+        const int bit = 1 << (pixel.col * rows_ + pixel.row);
+        if ((care & bit) && ((black & bit) != 0) != pixel.black) {
+            // пиксель должен быть и черным, и белым: пара не совпадает ни с одним окном
+            pattern_count_ += 1;
+            return pattern_count_ - 1;
+        }
+        care |= bit;
+        black |= pixel.black ? bit : 0;
+    }
+
+    const uint64_t mask = uint64_t{ 1 } << pattern_count_;
+    for (int code = 0; code < (1 << (rows_ * cols_)); code += 1) {
+        if ((code & care) == black) {
+            masks_[code] |= mask;
+        }
+    }
+    pattern_count_ += 1;
+    return pattern_count_ - 1;
+}
+
+void NeighborhoodTable::Match(const cv::Mat& image, int row_begin, int row_end, cv::Mat& hits) const {
+    Scan(image, row_begin, row_end, [&](int row, int col, uint64_t mask) {
+        hits.ptr<uchar>(row)[col] = mask != 0;
+    });
+}
@@ -0,0 +1,327 @@
+#include<hitOrMiss/run_length_image.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+using Run = RunLengthImage::Run;
+
+const int kWhite = 255; // код белого пикселя
+const int kBlack = 0; // код черного пикселя
+const int kThresholdValue = 127; // пороговое значение бинаризации, как в HitOrMiss
+
+// Серия значимых пикселей одного цвета в строке окна структурного элемента
+struct CareRun {
+    int row = 0; // строка окна
+    int begin = 0; // первый столбец
+    int end = 0; // столбец за последним
+    bool black = true; // требуемый цвет
+};
+
+// Добавить серию в конец упорядоченного списка, сливая ее с последней, если они соприкасаются
+void Append(std::vector<Run>& dst, const Run& run) {
+    if (!dst.empty() && run.begin <= dst.back().end) {
+        dst.back().end = std::max(dst.back().end, run.end);
+        return;
+    }
+    dst.push_back(run);
+}
+
+// Пересечение упорядоченных списков серий
+void Intersect(const Run* lhs, const Run* lhs_end, const Run* rhs, const Run* rhs_end, std::vector<Run>& dst) {
+    dst.clear();
+    while (lhs != lhs_end && rhs != rhs_end) {
+        const int begin = std::max(lhs->begin, rhs->begin);
+        const int end = std::min(lhs->end, rhs->end);
+        if (begin < end) {
+            dst.push_back({ begin, end });
+        }
+        // серия, которая кончается раньше, дальше ни с чем не пересекается
+        if (lhs->end < rhs->end) {
+            ++lhs;
+        }
+        else {
+            ++rhs;
+        }
+    }
+}
+
+// Объединение упорядоченных списков серий
+void Unite(const Run* lhs, const Run* lhs_end, const Run* rhs, const Run* rhs_end, std::vector<Run>& dst) {
+    dst.clear();
+    while (lhs != lhs_end || rhs != rhs_end) {
+        if (rhs == rhs_end || (lhs != lhs_end && lhs->begin <= rhs->begin)) {
+            Append(dst, *lhs++);
+        }
+        else {
+            Append(dst, *rhs++);
+        }
+    }
+}
+
+// Вычитание упорядоченных списков серий (lhs and not rhs)
+void Subtract(const Run* lhs, const Run* lhs_end, const Run* rhs, const Run* rhs_end, std::vector<Run>& dst) {
+    dst.clear();
+    for (; lhs != lhs_end; ++lhs) {
+        // серии rhs, кончившиеся до начала серии lhs, не нужны и следующим сериям lhs
+        while (rhs != rhs_end && rhs->end <= lhs->begin) {
+            ++rhs;
+        }
+        int begin = lhs->begin;
+        for (const Run* cut = rhs; cut != rhs_end && cut->begin < lhs->end; ++cut) {
+            if (cut->begin > begin) {
+                dst.push_back({ begin, cut->begin });
+            }
+            begin = std::max(begin, cut->end);
+        }
+        if (begin < lhs->end) {
+            dst.push_back({ begin, lhs->end });
+        }
+    }
+}
+
+// Промежутки между сериями строки ширины cols (серии белых пикселей)
+void Complement(const Run* runs, const Run* runs_end, int cols, std::vector<Run>& dst) {
+    dst.clear();
+    int begin = 0;
+    for (; runs != runs_end; ++runs) {
+        if (runs->begin > begin) {
+            dst.push_back({ begin, runs->begin });
+        }
+        begin = runs->end;
+    }
+    if (begin < cols) {
+        dst.push_back({ begin, cols });
+    }
+}
+
+// Серии значимых пикселей элемента; false, если пиксель должен быть и черным, и белым
+bool CareRuns(const StructuringElement& element, std::vector<CareRun>& care_runs) {
+    const cv::Size& size = element.get_size();
+    // 0 - пиксель не имеет значения, 1 - должен быть черным, 2 - белым
+    std::vector<int> state(static_cast<size_t>(size.area()), 0);
+    for (const CarePixel& pixel : element.get_care()) {
+        int& pixel_state = state[pixel.row * size.width + pixel.col];
+        const int want = pixel.black ? 1 : 2;
+        if (pixel_state != 0 && pixel_state != want) {
+            return false;
+        }
+        pixel_state = want;
+    }
+
+    care_runs.clear();
+    for (int row = 0; row < size.height; row += 1) {
+        for (int col = 0; col < size.width;) {
+            const int want = state[row * size.width + col];
+            int end = col + 1;
+            while (end < size.width && state[row * size.width + end] == want) {
+                end += 1;
+            }
+            if (want != 0) {
+                care_runs.push_back({ row, col, end, want == 1 });
+            }
+            col = end;
+        }
+    }
+
+    // черные серии изображения редки, а длинные серии элемента подходят к немногим из них:
+    // такие условия сильнее всего сужают окна и проверяются первыми
+    std::stable_sort(care_runs.begin(), care_runs.end(), [](const CareRun& lhs, const CareRun& rhs) {
+        if (lhs.black != rhs.black) return lhs.black;
+        return lhs.end - lhs.begin > rhs.end - rhs.begin;
+    });
+    return true;
+}
+
+}
+
+RunLengthImage::RunLengthImage(int rows, int cols) {
+    Reset(rows, cols);
+    row_start_.assign(static_cast<size_t>(rows) + 1, 0);
+}
+
+RunLengthImage::RunLengthImage(const cv::Mat& image) {
+    CV_Assert(image.type() == CV_8UC1);
+    Reset(image.rows, image.cols);
+    std::vector<Run> runs;
+    for (int row = 0; row < image.rows; row += 1) {
+        const uchar* image_row = image.ptr<uchar>(row);
+        runs.clear();
+        for (int col = 0; col < image.cols;) {
+            if (image_row[col] > kThresholdValue) {
+                col += 1;
+                continue;
+            }
+            const int begin = col;
+            while (col < image.cols && image_row[col] <= kThresholdValue) {
+                col += 1;
+            }
+            runs.push_back({ begin, col });
+        }
+        AppendRow(runs);
+    }
+}
+
+void RunLengthImage::Unpack(cv::Mat& dst) const {
+    dst.create(rows_, cols_, CV_8UC1);
+    for (int row = 0; row < rows_; row += 1) {
+        uchar* dst_row = dst.ptr<uchar>(row);
+        std::memset(dst_row, kWhite, cols_);
+        for (const Run* run = RowBegin(row); run != RowEnd(row); ++run) {
+            std::memset(dst_row + run->begin, kBlack, run->end - run->begin);
+        }
+    }
+}
+
+RunLengthImage RunLengthImage::And(const RunLengthImage& lhs, const RunLengthImage& rhs) {
+    CV_Assert(lhs.rows_ == rhs.rows_ && lhs.cols_ == rhs.cols_);
+    RunLengthImage result;
+    result.Reset(lhs.rows_, lhs.cols_);
+    std::vector<Run> runs;
+    for (int row = 0; row < lhs.rows_; row += 1) {
+        Intersect(lhs.RowBegin(row), lhs.RowEnd(row), rhs.RowBegin(row), rhs.RowEnd(row), runs);
+        result.AppendRow(runs);
+    }
+    return result;
+}
+
+RunLengthImage RunLengthImage::Or(const RunLengthImage& lhs, const RunLengthImage& rhs) {
+    CV_Assert(lhs.rows_ == rhs.rows_ && lhs.cols_ == rhs.cols_);
+    RunLengthImage result;
+    result.Reset(lhs.rows_, lhs.cols_);
+    std::vector<Run> runs;
+    for (int row = 0; row < lhs.rows_; row += 1) {
+        Unite(lhs.RowBegin(row), lhs.RowEnd(row), rhs.RowBegin(row), rhs.RowEnd(row), runs);
+        result.AppendRow(runs);
+    }
+    return result;
+}
+
+RunLengthImage RunLengthImage::Substraction(const RunLengthImage& lhs, const RunLengthImage& rhs) {
+    CV_Assert(lhs.rows_ == rhs.rows_ && lhs.cols_ == rhs.cols_);
+    RunLengthImage result;
+    result.Reset(lhs.rows_, lhs.cols_);
+    std::vector<Run> runs;
+    for (int row = 0; row < lhs.rows_; row += 1) {
+        Subtract(lhs.RowBegin(row), lhs.RowEnd(row), rhs.RowBegin(row), rhs.RowEnd(row), runs);
+        result.AppendRow(runs);
+    }
+    return result;
+}
+
+RunLengthImage RunLengthImage::Match(const RunLengthImage& image, const StructuringElement& element) {
+    const cv::Size& size = element.get_size();
+    const int last_row = image.rows_ - size.height;
+    const int last_col = image.cols_ - size.width;
+    if (size.empty() || last_row < 0 || last_col < 0) {
+        return RunLengthImage();
+    }
+
+    std::vector<CareRun> care_runs;
+    if (!CareRuns(element, care_runs)) {
+        return RunLengthImage(last_row + 1, last_col + 1);
+    }
+
+    RunLengthImage hits;
+    hits.Reset(last_row + 1, last_col + 1);
+    std::vector<Run> candidates;
+    std::vector<Run> intervals;
+    std::vector<Run> narrowed;
+    std::vector<Run> gaps;
+    for (int mask_row = 0; mask_row <= last_row; mask_row += 1) {
+        candidates.assign(1, { 0, last_col + 1 });
+        for (const CareRun& care_run : care_runs) {
+            const int line = mask_row + care_run.row;
+            const Run* source = image.RowBegin(line);
+            const Run* source_end = image.RowEnd(line);
+            if (!care_run.black) {
+                Complement(source, source_end, image.cols_, gaps);
+                source = gaps.data();
+                source_end = gaps.data() + gaps.size();
+            }
+
+            // серия элемента [begin, end) лежит в серии изображения [s, t) при левом
+            // верхнем угле окна в столбцах [s - begin, t - end]
+            const int length = care_run.end - care_run.begin;
+            intervals.clear();
+            for (; source != source_end; ++source) {
+                if (source->end - source->begin < length) continue;
+                const int begin = std::max(0, source->begin - care_run.begin);
+                const int end = std::min(last_col + 1, source->end - care_run.end + 1);
+                if (begin < end) {
+                    intervals.push_back({ begin, end });
+                }
+            }
+
+            Intersect(candidates.data(), candidates.data() + candidates.size(),
+                intervals.data(), intervals.data() + intervals.size(), narrowed);
+            std::swap(candidates, narrowed);
+            if (candidates.empty()) break;
+        }
+        hits.AppendRow(candidates);
+    }
+    return hits;
+}
+
+RunLengthImage RunLengthImage::Stamp(const RunLengthImage& hits, const std::vector<cv::Point>& offsets, const cv::Size& size) {
+    // смещения одной строки, идущие подряд по столбцам, закрашивают серию, расширенную на их диапазон
+    struct Shift {
+        int row = 0; // смещение по строкам
+        int first = 0; // первое смещение по столбцам
+        int last = 0; // последнее смещение по столбцам
+    };
+    std::vector<cv::Point> sorted = offsets;
+    std::sort(sorted.begin(), sorted.end(), [](const cv::Point& lhs, const cv::Point& rhs) {
+        return lhs.y != rhs.y ? lhs.y < rhs.y : lhs.x < rhs.x;
+    });
+    std::vector<Shift> shifts;
+    for (const cv::Point& offset : sorted) {
+        if (!shifts.empty() && shifts.back().row == offset.y && shifts.back().last + 1 >= offset.x) {
+            shifts.back().last = std::max(shifts.back().last, offset.x);
+            continue;
+        }
+        shifts.push_back({ offset.y, offset.x, offset.x });
+    }
+
+    RunLengthImage result;
+    result.Reset(size.height, size.width);
+    std::vector<Run> shifted;
+    std::vector<Run> runs;
+    for (int row = 0; row < size.height; row += 1) {
+        shifted.clear();
+        for (const Shift& shift : shifts) {
+            const int hits_row = row - shift.row;
+            if (hits_row < 0 || hits_row >= hits.rows_) continue;
+            for (const Run* run = hits.RowBegin(hits_row); run != hits.RowEnd(hits_row); ++run) {
+                const int begin = std::max(0, run->begin + shift.first);
+                const int end = std::min(size.width, run->end + shift.last);
+                if (begin < end) {
+                    shifted.push_back({ begin, end });
+                }
+            }
+        }
+        std::sort(shifted.begin(), shifted.end(), [](const Run& lhs, const Run& rhs) {
+            return lhs.begin < rhs.begin;
+        });
+        runs.clear();
+        for (const Run& run : shifted) {
+            Append(runs, run);
+        }
+        result.AppendRow(runs);
+    }
+    return result;
+}
+
+void RunLengthImage::Reset(int rows, int cols) {
+    rows_ = rows;
+    cols_ = cols;
+    runs_.clear();
+    row_start_.assign(1, 0);
+}
+
+void RunLengthImage::AppendRow(const std::vector<Run>& runs) {
+    runs_.insert(runs_.end(), runs.begin(), runs.end());
+    row_start_.push_back(static_cast<int>(runs_.size()));
+}
@@ -0,0 +1,238 @@
+#include<hitOrMiss/separable_erosion.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+const int kBlack = 0; // код черного пикселя
+const int kWordBits = 64; // количество пикселей в слове
+const int kMinCare = 16; // меньшие элементы быстрее проверить по списку значимых пикселей
+
+// and подряд идущих отрезков длины length: dst[i] = src[i] & ... & src[i + length - 1], i < count,
+// по блокам ван Херка / Гиля-Вермана; prefix и suffix - рабочие буферы на count + length - 1 элементов
+template<typename T>
+void RunAnd(const T* src, int count, int length, T* dst, T* prefix, T* suffix) {
+    const int size = count + length - 1;
+    for (int index = 0; index < size; index += 1) {
+        prefix[index] = index % length == 0 ? src[index] : prefix[index - 1] & src[index];
+    }
+    for (int index = size - 1; index >= 0; index -= 1) {
+        const bool block_end = index % length == length - 1 || index == size - 1;
+        suffix[index] = block_end ? src[index] : suffix[index + 1] & src[index];
+    }
+    // отрезок лежит не более чем в двух блоках: хвост первого и начало второго
+    for (int index = 0; index < count; index += 1) {
+        dst[index] = suffix[index] & prefix[index + length - 1];
+    }
+}
+
+// dst = биты src, начиная с пикселя shift (сдвиг влево по изображению), биты за words считаются нулевыми
+void ShiftLeft(const uint64_t* src, int words, int shift, uint64_t* dst) {
+    const int word_shift = shift / kWordBits;
+    const int bit_shift = shift % kWordBits;
+    for (int word = 0; word < words; word += 1) {
+        const int source = word + word_shift;
+        uint64_t value = source < words ? src[source] >> bit_shift : 0;
+        if (bit_shift != 0 && source + 1 < words) {
+            value |= src[source + 1] << (kWordBits - bit_shift);
+        }
+        dst[word] = value;
+    }
+}
+
+// dst |= src, сдвинутая вправо по изображению на shift пикселей
+void OrShiftedRight(const uint64_t* src, int words, int shift, uint64_t* dst) {
+    const int word_shift = shift / kWordBits;
+    const int bit_shift = shift % kWordBits;
+    for (int word = words - 1; word >= word_shift; word -= 1) {
+        uint64_t value = src[word - word_shift] << bit_shift;
+        if (bit_shift != 0 && word - word_shift - 1 >= 0) {
+            value |= src[word - word_shift - 1] >> (kWordBits - bit_shift);
+        }
+        dst[word] |= value;
+    }
+}
+
+// Промежуточные буферы проходов, память под которые переиспользуется между вызовами в одном потоке
+struct Buffers {
+    std::vector<uchar> pixels;
+    std::vector<uchar> prefix;
+    std::vector<uchar> suffix;
+    std::vector<uchar> horizontal;
+    std::vector<uchar> prefix_rows;
+    std::vector<uchar> suffix_rows;
+    std::vector<uint64_t> words_horizontal;
+    std::vector<uint64_t> words_prefix;
+    std::vector<uint64_t> words_suffix;
+    std::vector<uint64_t> run;
+    std::vector<uint64_t> shifted;
+};
+
+Buffers& ThreadBuffers() {
+    thread_local Buffers buffers;
+    return buffers;
+}
+
+}
+
+bool SeparableErosion::Supports(const StructuringElement& element) {
+    return element.IsRectangle() && static_cast<int>(element.get_care().size()) >= kMinCare;
+}
+
+void SeparableErosion::Match(const cv::Mat& image, const StructuringElement& element,
+    int row_begin, int row_end, cv::Mat& hits) {
+    const cv::Size& window = element.get_size();
+    const int last_row = std::min(image.rows - window.height, row_end - 1);
+    const int last_col = image.cols - window.width;
+    if (window.empty() || last_row < row_begin || last_col < 0 || element.get_care().empty()) {
+        return;
+    }
+
+    const cv::Rect& rect = element.get_bounds();
+    const bool black = element.get_care().front().black;
+    const int cols = last_col + 1;
+    const int band_rows = last_row - row_begin + 1;
+    const int source_rows = band_rows + rect.height - 1;
+
+    // проход по строкам: для каждой нужной строки изображения and отрезков длины rect.width
+    Buffers& buffers = ThreadBuffers();
+    const size_t area = static_cast<size_t>(source_rows) * cols;
+    std::vector<uchar>& pixels = buffers.pixels;
+    pixels.resize(cols + rect.width - 1);
+    buffers.prefix.resize(pixels.size());
+    buffers.suffix.resize(pixels.size());
+    buffers.horizontal.resize(area);
+    uchar* horizontal = buffers.horizontal.data();
+    for (int row = 0; row < source_rows; row += 1) {
+        const uchar* image_row = image.ptr<uchar>(row_begin + rect.y + row) + rect.x;
+        for (int col = 0; col < static_cast<int>(pixels.size()); col += 1) {
+            pixels[col] = (image_row[col] == kBlack) == black;
+        }
+        RunAnd(pixels.data(), cols, rect.width, horizontal + static_cast<size_t>(row) * cols,
+            buffers.prefix.data(), buffers.suffix.data());
+    }
+
+    // проход по столбцам теми же блоками, но целыми строками
+    buffers.prefix_rows.resize(area);
+    buffers.suffix_rows.resize(area);
+    uchar* prefix_rows = buffers.prefix_rows.data();
+    uchar* suffix_rows = buffers.suffix_rows.data();
+    for (int row = 0; row < source_rows; row += 1) {
+        const uchar* src = horizontal + static_cast<size_t>(row) * cols;
+        uchar* dst = prefix_rows + static_cast<size_t>(row) * cols;
+        if (row % rect.height == 0) {
+            std::copy(src, src + cols, dst);
+            continue;
+        }
+        const uchar* previous = dst - cols;
+        for (int col = 0; col < cols; col += 1) {
+            dst[col] = previous[col] & src[col];
+        }
+    }
+    for (int row = source_rows - 1; row >= 0; row -= 1) {
+        const uchar* src = horizontal + static_cast<size_t>(row) * cols;
+        uchar* dst = suffix_rows + static_cast<size_t>(row) * cols;
+        if (row % rect.height == rect.height - 1 || row == source_rows - 1) {
+            std::copy(src, src + cols, dst);
+            continue;
+        }
+        const uchar* next = dst + cols;
+        for (int col = 0; col < cols; col += 1) {
+            dst[col] = next[col] & src[col];
+        }
+    }
+    for (int row = 0; row < band_rows; row += 1) {
+        const uchar* suffix_row = suffix_rows + static_cast<size_t>(row) * cols;
+        const uchar* prefix_row = prefix_rows + static_cast<size_t>(row + rect.height - 1) * cols;
+        uchar* hits_row = hits.ptr<uchar>(row_begin + row);
+        for (int col = 0; col < cols; col += 1) {
+            hits_row[col] = suffix_row[col] & prefix_row[col];
+        }
+    }
+}
+
+void SeparableErosion::Match(const BitPlane& image, const StructuringElement& element, const cv::Point& offset,
+    int row_begin, int row_end, BitPlane& dst) {
+    const cv::Size& window = element.get_size();
+    const int last_row = std::min(image.get_rows() - window.height, row_end - 1);
+    const int last_col = image.get_cols() - window.width;
+    if (window.empty() || last_row < row_begin || last_col < 0 || element.get_care().empty()) {
+        return;
+    }
+
+    const cv::Rect& rect = element.get_bounds();
+    const uint64_t invert = element.get_care().front().black ? 0 : ~uint64_t{ 0 };
+    const int words = image.get_words_per_row();
+    const int band_rows = last_row - row_begin + 1;
+    const int source_rows = band_rows + rect.height - 1;
+
+    const int last_word = last_col / kWordBits;
+    const int tail = last_col % kWordBits + 1;
+    const uint64_t last_mask = tail == kWordBits ? ~uint64_t{ 0 } : (uint64_t{ 1 } << tail) - 1;
+
+    // проход по строкам: бит col - and пикселей [col + rect.x, col + rect.x + rect.width) строки
+    Buffers& buffers = ThreadBuffers();
+    std::vector<uint64_t>& horizontal = buffers.words_horizontal;
+    std::vector<uint64_t>& run = buffers.run;
+    std::vector<uint64_t>& shifted = buffers.shifted;
+    horizontal.resize(static_cast<size_t>(source_rows) * words);
+    run.resize(words);
+    shifted.resize(words);
+    for (int row = 0; row < source_rows; row += 1) {
+        const uint64_t* image_row = image.Row(row_begin + rect.y + row);
+        for (int word = 0; word < words; word += 1) {
+            run[word] = image_row[word] ^ invert;
+        }
+        // длина отрезка удваивается, пока не превысит rect.width, остаток добирается одним сдвигом
+        int length = 1;
+        while (length < rect.width) {
+            const int step = std::min(length, rect.width - length);
+            ShiftLeft(run.data(), words, step, shifted.data());
+            for (int word = 0; word < words; word += 1) {
+                run[word] &= shifted[word];
+            }
+            length += step;
+        }
+        ShiftLeft(run.data(), words, rect.x, horizontal.data() + static_cast<size_t>(row) * words);
+    }
+
+    // проход по столбцам блоками ван Херка / Гиля-Вермана над строками слов
+    std::vector<uint64_t>& prefix = buffers.words_prefix;
+    std::vector<uint64_t>& suffix = buffers.words_suffix;
+    prefix.resize(horizontal.size());
+    suffix.resize(horizontal.size());
+    for (int row = 0; row < source_rows; row += 1) {
+        const uint64_t* src = horizontal.data() + static_cast<size_t>(row) * words;
+        uint64_t* prefix_row = prefix.data() + static_cast<size_t>(row) * words;
+        for (int word = 0; word < words; word += 1) {
+            prefix_row[word] = row % rect.height == 0 ? src[word] : prefix_row[word - words] & src[word];
+        }
+    }
+    for (int row = source_rows - 1; row >= 0; row -= 1) {
+        const uint64_t* src = horizontal.data() + static_cast<size_t>(row) * words;
+        uint64_t* suffix_row = suffix.data() + static_cast<size_t>(row) * words;
+        const bool block_end = row % rect.height == rect.height - 1 || row == source_rows - 1;
+        for (int word = 0; word < words; word += 1) {
+            suffix_row[word] = block_end ? src[word] : suffix_row[word + words] & src[word];
+        }
+    }
+
+    for (int row = 0; row < band_rows; row += 1) {
+        const uint64_t* suffix_row = suffix.data() + static_cast<size_t>(row) * words;
+        const uint64_t* prefix_row = prefix.data() + static_cast<size_t>(row + rect.height - 1) * words;
+        for (int word = 0; word < words; word += 1) {
+            shifted[word] = word <= last_word ? suffix_row[word] & prefix_row[word] : 0;
+        }
+        shifted[last_word] &= last_mask;
+
+        uint64_t* dst_row = dst.Row(row_begin + row + offset.y);
+        if (offset.x == 0) {
+            std::copy(shifted.begin(), shifted.end(), dst_row);
+        }
+        else {
+            OrShiftedRight(shifted.data(), words, offset.x, dst_row);
+        }
+    }
+}
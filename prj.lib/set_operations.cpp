@@ -0,0 +1,166 @@
+#include<hitOrMiss/set_operations.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define HITORMISS_X86
+#include <immintrin.h>
+#endif
+
+// gcc и clang требуют явно разрешить набор инструкций для функции, msvc - нет
+#if defined(__GNUC__) || defined(__clang__)
+#define HITORMISS_TARGET(isa) __attribute__((target(isa)))
+#else
+#define HITORMISS_TARGET(isa)
+#endif
+
+namespace {
+
+const uchar kWhite = 255; // код белого пикселя
+const uchar kBlack = 0; // код черного пикселя
+
+enum class Operation { kAnd, kOr, kSubstraction };
+
+// Обработка строки из count пикселей
+typedef void (*RowFunction)(const uchar* lhs, const uchar* rhs, uchar* dst, int count);
+
+template <Operation operation>
+void ScalarRow(const uchar* lhs, const uchar* rhs, uchar* dst, int count) {
+    for (int col = 0; col < count; col += 1) {
+        const bool lhs_black = lhs[col] == kBlack;
+        const bool rhs_black = rhs[col] == kBlack;
+        bool black = false;
+        if (operation == Operation::kAnd) black = lhs_black && rhs_black;
+        if (operation == Operation::kOr) black = lhs_black || rhs_black;
+        if (operation == Operation::kSubstraction) black = lhs_black && !rhs_black;
+        dst[col] = black ? kBlack : kWhite;
+    }
+}
+
+#ifdef HITORMISS_X86
+
+template <Operation operation>
+HITORMISS_TARGET("sse2")
+void Sse2Row(const uchar* lhs, const uchar* rhs, uchar* dst, int count) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i white = _mm_set1_epi8(static_cast<char>(kWhite));
+    int col = 0;
+    for (; col + 16 <= count; col += 16) {
+        const __m128i lhs_black = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + col)), zero);
+        const __m128i rhs_black = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + col)), zero);
+        __m128i black;
+        if (operation == Operation::kAnd) black = _mm_and_si128(lhs_black, rhs_black);
+        if (operation == Operation::kOr) black = _mm_or_si128(lhs_black, rhs_black);
+        if (operation == Operation::kSubstraction) black = _mm_andnot_si128(rhs_black, lhs_black);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + col), _mm_andnot_si128(black, white));
+    }
+    ScalarRow<operation>(lhs + col, rhs + col, dst + col, count - col);
+}
+
+template <Operation operation>
+HITORMISS_TARGET("avx2")
+void Avx2Row(const uchar* lhs, const uchar* rhs, uchar* dst, int count) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i white = _mm256_set1_epi8(static_cast<char>(kWhite));
+    int col = 0;
+    for (; col + 32 <= count; col += 32) {
+        const __m256i lhs_black = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + col)), zero);
+        const __m256i rhs_black = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + col)), zero);
+        __m256i black;
+        if (operation == Operation::kAnd) black = _mm256_and_si256(lhs_black, rhs_black);
+        if (operation == Operation::kOr) black = _mm256_or_si256(lhs_black, rhs_black);
+        if (operation == Operation::kSubstraction) black = _mm256_andnot_si256(rhs_black, lhs_black);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + col), _mm256_andnot_si256(black, white));
+    }
+    ScalarRow<operation>(lhs + col, rhs + col, dst + col, count - col);
+}
+
+template <Operation operation>
+HITORMISS_TARGET("avx512f,avx512bw")
+void Avx512Row(const uchar* lhs, const uchar* rhs, uchar* dst, int count) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i white = _mm512_set1_epi8(static_cast<char>(kWhite));
+    // хвост строки обрабатывается маскированными загрузкой и записью
+    for (int col = 0; col < count; col += 64) {
+        const int left = count - col;
+        const __mmask64 tail = left >= 64 ? ~__mmask64{ 0 } : (__mmask64{ 1 } << left) - 1;
+        const __mmask64 lhs_black = _mm512_cmpeq_epi8_mask(_mm512_maskz_loadu_epi8(tail, lhs + col), zero);
+        const __mmask64 rhs_black = _mm512_cmpeq_epi8_mask(_mm512_maskz_loadu_epi8(tail, rhs + col), zero);
+        __mmask64 black = 0;
+        if (operation == Operation::kAnd) black = lhs_black & rhs_black;
+        if (operation == Operation::kOr) black = lhs_black | rhs_black;
+        if (operation == Operation::kSubstraction) black = lhs_black & ~rhs_black;
+        _mm512_mask_storeu_epi8(dst + col, tail, _mm512_maskz_mov_epi8(~black, white));
+    }
+}
+
+#endif
+
+template <Operation operation>
+RowFunction SelectRow(SetOperations::Isa isa) {
+#ifdef HITORMISS_X86
+    switch (isa) {
+    case SetOperations::Isa::kAvx512: return Avx512Row<operation>;
+    case SetOperations::Isa::kAvx2: return Avx2Row<operation>;
+    case SetOperations::Isa::kSse2: return Sse2Row<operation>;
+    default: break;
+    }
+#endif
+    return ScalarRow<operation>;
+}
+
+template <Operation operation>
+void Apply(const cv::Mat& lhs, const cv::Mat& rhs, cv::Mat& dst, SetOperations::Isa isa) {
+    CV_Assert(lhs.type() == CV_8UC1 && rhs.type() == CV_8UC1);
+    CV_Assert(lhs.rows == rhs.rows && lhs.cols == rhs.cols);
+    CV_Assert(SetOperations::IsSupported(isa));
+
+    dst.create(lhs.rows, lhs.cols, CV_8UC1);
+
+    const RowFunction row_function = SelectRow<operation>(isa);
+
+    // непрерывные изображения обрабатываются одной строкой
+    if (lhs.isContinuous() && rhs.isContinuous() && dst.isContinuous()) {
+        row_function(lhs.ptr<uchar>(0), rhs.ptr<uchar>(0), dst.ptr<uchar>(0), lhs.rows * lhs.cols);
+        return;
+    }
+    for (int row = 0; row < lhs.rows; row += 1) {
+        row_function(lhs.ptr<uchar>(row), rhs.ptr<uchar>(row), dst.ptr<uchar>(row), lhs.cols);
+    }
+}
+
+}
+
+SetOperations::Isa SetOperations::BestIsa() {
+    static const Isa best = [] {
+        for (Isa isa : { Isa::kAvx512, Isa::kAvx2, Isa::kSse2 }) {
+            if (IsSupported(isa)) {
+                return isa;
+            }
+        }
+        return Isa::kScalar;
+    }();
+    return best;
+}
+
+bool SetOperations::IsSupported(Isa isa) {
+#ifdef HITORMISS_X86
+    switch (isa) {
+    case Isa::kAvx512: return cv::checkHardwareSupport(CV_CPU_AVX_512BW);
+    case Isa::kAvx2: return cv::checkHardwareSupport(CV_CPU_AVX2);
+    case Isa::kSse2: return cv::checkHardwareSupport(CV_CPU_SSE2);
+    default: break;
+    }
+#endif
+    return isa == Isa::kScalar;
+}
+
+void SetOperations::And(const cv::Mat& lhs, const cv::Mat& rhs, cv::Mat& dst, Isa isa) {
+    Apply<Operation::kAnd>(lhs, rhs, dst, isa);
+}
+
+void SetOperations::Or(const cv::Mat& lhs, const cv::Mat& rhs, cv::Mat& dst, Isa isa) {
+    Apply<Operation::kOr>(lhs, rhs, dst, isa);
+}
+
+void SetOperations::Substraction(const cv::Mat& lhs, const cv::Mat& rhs, cv::Mat& dst, Isa isa) {
+    Apply<Operation::kSubstraction>(lhs, rhs, dst, isa);
+}
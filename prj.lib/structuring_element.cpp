@@ -0,0 +1,309 @@
+#include<hitOrMiss/structuring_element.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+const int kWhite = 255; // код белого пикселя
+const int kBlack = 0; // код черного пикселя
+const int kSampleSide = 16; // окон выборки для порядка проверки по каждой оси
+const int kGreedyRows = 8; // первых строк, выбираемых по еще не отвергнутым окнам выборки
+const int kWindowsPerSample = 8; // наименьшее число окон изображения на окно выборки
+
+// Жадное разбиение отмеченных клеток сетки rows*cols на непересекающиеся прямоугольники:
+// от первой свободной клетки прямоугольник растет вправо, затем вниз, пока строки целиком отмечены
+std::vector<cv::Rect> GreedyRectangles(std::vector<bool> marked, int rows, int cols) {
+    std::vector<cv::Rect> rectangles;
+    for (int row = 0; row < rows; row += 1) {
+        for (int col = 0; col < cols; col += 1) {
+            if (!marked[row * cols + col]) continue;
+
+            int width = 1;
+            while (col + width < cols && marked[row * cols + col + width]) {
+                width += 1;
+            }
+            int height = 1;
+            while (row + height < rows) {
+                bool full = true;
+                for (int step = 0; step < width && full; step += 1) {
+                    full = marked[(row + height) * cols + col + step];
+                }
+                if (!full) break;
+                height += 1;
+            }
+
+            for (int step_row = row; step_row < row + height; step_row += 1) {
+                for (int step_col = col; step_col < col + width; step_col += 1) {
+                    marked[step_row * cols + step_col] = false;
+                }
+            }
+            rectangles.emplace_back(col, row, width, height);
+        }
+    }
+    return rectangles;
+}
+
+}
+
+StructuringElement::StructuringElement(const cv::Mat& kernel, bool foreground) {
+    size_ = kernel.size();
+    for (int step_row = 0; step_row < kernel.rows; step_row += 1) {
+        for (int step_col = 0; step_col < kernel.cols; step_col += 1) {
+            const int kernel_pixel = kernel.at<uchar>(step_row, step_col);
+            // белые пиксели переднего плана и черные пиксели заднего плана не имеют значения
+            if (kernel_pixel == (foreground ? kBlack : kWhite)) {
+                care_.push_back({ step_row, step_col, foreground });
+            }
+        }
+    }
+    lhs_count_ = static_cast<int>(care_.size());
+    Finalize();
+}
+
+StructuringElement StructuringElement::Combine(const StructuringElement& lhs, const cv::Point& lhs_shift,
+    const StructuringElement& rhs, const cv::Point& rhs_shift, const cv::Size& size) {
+    StructuringElement result;
+    result.size_ = size;
+    for (const CarePixel& pixel : lhs.care_) {
+        result.care_.push_back({ pixel.row + lhs_shift.y, pixel.col + lhs_shift.x, pixel.black });
+    }
+    for (const CarePixel& pixel : rhs.care_) {
+        result.care_.push_back({ pixel.row + rhs_shift.y, pixel.col + rhs_shift.x, pixel.black });
+    }
+    result.lhs_count_ = static_cast<int>(lhs.care_.size());
+    result.Finalize();
+    return result;
+}
+
+void StructuringElement::OrderProbes(const cv::Mat& image) {
+    const int last_row = image.rows - size_.height;
+    const int last_col = image.cols - size_.width;
+    const int sample_rows = std::min(last_row + 1, kSampleSide);
+    const int sample_cols = std::min(last_col + 1, kSampleSide);
+    const int care_count = static_cast<int>(care_.size());
+    if (care_count < 2 || last_row < 0 || last_col < 0
+        || static_cast<long long>(last_row + 1) * (last_col + 1) < kWindowsPerSample * kSampleSide * kSampleSide) {
+        return;
+    }
+
+    // несовпадения значимых пикселей в окнах выборки, равномерно расставленных по изображению
+    OrderScratch& scratch = order_scratch_;
+    const int samples = sample_rows * sample_cols;
+    scratch.samples = samples;
+    scratch.mismatch.resize(static_cast<size_t>(care_count) * samples);
+    scratch.failures.assign(care_count, 0);
+    for (int sample = 0; sample < samples; sample += 1) {
+        const int mask_row = sample / sample_cols * (last_row + 1) / sample_rows;
+        const int mask_col = sample % sample_cols * (last_col + 1) / sample_cols;
+        for (int index = 0; index < care_count; index += 1) {
+            const CarePixel& pixel = care_[index];
+            const bool miss = (image.at<uchar>(mask_row + pixel.row, mask_col + pixel.col) == kBlack) != pixel.black;
+            scratch.mismatch[static_cast<size_t>(index) * samples + sample] = miss;
+            scratch.failures[index] += miss;
+        }
+    }
+
+    // окна, отвергнутые строками lhs, не учитываются и при выборе строк rhs
+    scratch.survivors.resize(samples);
+    std::iota(scratch.survivors.begin(), scratch.survivors.end(), 0);
+    scratch.care.clear();
+    OrderPart(0, lhs_count_);
+    OrderPart(lhs_count_, care_count);
+
+    // прямоугольники и границы от порядка не зависят, перестраиваются только строки
+    care_.swap(scratch.care);
+    // строка на границе частей могла разделиться на две
+    rows_.reserve(rows_.size() + 1);
+    BuildRows();
+}
+
+void StructuringElement::OrderPart(int begin, int end) {
+    OrderScratch& scratch = order_scratch_;
+    const int samples = scratch.samples;
+
+    // строки части - непрерывные последовательности пикселей с одинаковым номером строки
+    scratch.units.clear();
+    for (int index = begin; index < end; index += 1) {
+        if (scratch.units.empty() || scratch.units.back().row != care_[index].row) {
+            scratch.units.push_back({ care_[index].row, index, index });
+        }
+        scratch.units.back().end = index + 1;
+    }
+    const int unit_count = static_cast<int>(scratch.units.size());
+    if (unit_count == 0) {
+        return;
+    }
+
+    // строка отвергает окно, если не совпал хотя бы один ее пиксель
+    scratch.unit_mismatch.assign(static_cast<size_t>(unit_count) * samples, 0);
+    scratch.unit_failures.assign(unit_count, 0);
+    for (int unit = 0; unit < unit_count; unit += 1) {
+        uchar* unit_mismatch = &scratch.unit_mismatch[static_cast<size_t>(unit) * samples];
+        for (int index = scratch.units[unit].begin; index < scratch.units[unit].end; index += 1) {
+            const uchar* mismatch = &scratch.mismatch[static_cast<size_t>(index) * samples];
+            for (int sample = 0; sample < samples; sample += 1) {
+                unit_mismatch[sample] |= mismatch[sample];
+            }
+        }
+        for (int sample = 0; sample < samples; sample += 1) {
+            scratch.unit_failures[unit] += unit_mismatch[sample];
+        }
+    }
+    auto width = [&](int unit) { return scratch.units[unit].end - scratch.units[unit].begin; };
+
+    // первые строки выбираются жадно: каждая отвергает больше всего окон, прошедших предыдущие,
+    // в расчете на одно сравнение; при равенстве сохраняется прежний порядок
+    scratch.order.clear();
+    scratch.taken.assign(unit_count, 0);
+    while (static_cast<int>(scratch.order.size()) < std::min(unit_count, kGreedyRows) && !scratch.survivors.empty()) {
+        int best = -1;
+        int best_rejected = 0;
+        int best_width = 1;
+        for (int unit = 0; unit < unit_count; unit += 1) {
+            if (scratch.taken[unit]) continue;
+            const uchar* unit_mismatch = &scratch.unit_mismatch[static_cast<size_t>(unit) * samples];
+            int rejected = 0;
+            for (int sample : scratch.survivors) {
+                rejected += unit_mismatch[sample];
+            }
+            if (rejected * best_width > best_rejected * width(unit)) {
+                best = unit;
+                best_rejected = rejected;
+                best_width = width(unit);
+            }
+        }
+        // оставшиеся окна совпадают со всеми строками, дальше порядок по всей выборке
+        if (best < 0) break;
+
+        scratch.taken[best] = 1;
+        scratch.order.push_back(best);
+        const uchar* unit_mismatch = &scratch.unit_mismatch[static_cast<size_t>(best) * samples];
+        scratch.survivors.erase(std::remove_if(scratch.survivors.begin(), scratch.survivors.end(),
+            [&](int sample) { return unit_mismatch[sample] != 0; }), scratch.survivors.end());
+    }
+
+    const size_t greedy = scratch.order.size();
+    for (int unit = 0; unit < unit_count; unit += 1) {
+        if (!scratch.taken[unit]) scratch.order.push_back(unit);
+    }
+    // сортировка вставками устойчива и не выделяет память; строк в элементе немного
+    auto rejects_more = [&](int lhs, int rhs) {
+        return scratch.unit_failures[lhs] * width(rhs) > scratch.unit_failures[rhs] * width(lhs);
+    };
+    for (size_t step = greedy + 1; step < scratch.order.size(); step += 1) {
+        const int unit = scratch.order[step];
+        size_t place = step;
+        while (place > greedy && rejects_more(unit, scratch.order[place - 1])) {
+            scratch.order[place] = scratch.order[place - 1];
+            place -= 1;
+        }
+        scratch.order[place] = unit;
+    }
+
+    // внутри строки первыми проверяются чаще не совпадающие пиксели
+    for (int unit : scratch.order) {
+        const int unit_begin = scratch.units[unit].begin;
+        for (int step = unit_begin + 1; step < scratch.units[unit].end; step += 1) {
+            const CarePixel pixel = care_[step];
+            const int failures = scratch.failures[step];
+            int place = step;
+            while (place > unit_begin && scratch.failures[place - 1] < failures) {
+                care_[place] = care_[place - 1];
+                scratch.failures[place] = scratch.failures[place - 1];
+                place -= 1;
+            }
+            care_[place] = pixel;
+            scratch.failures[place] = failures;
+        }
+        scratch.care.insert(scratch.care.end(), care_.begin() + unit_begin, care_.begin() + scratch.units[unit].end);
+    }
+}
+
+void StructuringElement::Finalize() {
+    BuildRows();
+
+    rectangles_.clear();
+    Decompose(true);
+    Decompose(false);
+
+    bounds_ = cv::Rect();
+    rectangle_ = false;
+    if (care_.empty()) {
+        return;
+    }
+
+    int top = care_.front().row;
+    int bottom = care_.front().row;
+    int left = care_.front().col;
+    int right = care_.front().col;
+    bool same_color = true;
+    for (const CarePixel& pixel : care_) {
+        top = std::min(top, pixel.row);
+        bottom = std::max(bottom, pixel.row);
+        left = std::min(left, pixel.col);
+        right = std::max(right, pixel.col);
+        same_color = same_color && pixel.black == care_.front().black;
+    }
+    bounds_ = cv::Rect(left, top, right - left + 1, bottom - top + 1);
+
+    // пиксели не повторяются, поэтому прямоугольник сплошной, если их столько же, сколько в нем мест
+    rectangle_ = same_color && static_cast<int>(care_.size()) == bounds_.area();
+}
+
+void StructuringElement::BuildRows() {
+    // строкой считается непрерывная последовательность пикселей с одинаковым номером строки,
+    // порядок проверки пикселей при этом не меняется
+    rows_.clear();
+    for (int index = 0; index < static_cast<int>(care_.size()); index += 1) {
+        if (rows_.empty() || rows_.back().row != care_[index].row) {
+            rows_.push_back({ care_[index].row, index, index });
+        }
+        rows_.back().end = index + 1;
+    }
+}
+
+void StructuringElement::Decompose(bool black) {
+    int top = size_.height;
+    int bottom = -1;
+    int left = size_.width;
+    int right = -1;
+    for (const CarePixel& pixel : care_) {
+        if (pixel.black != black) continue;
+        top = std::min(top, pixel.row);
+        bottom = std::max(bottom, pixel.row);
+        left = std::min(left, pixel.col);
+        right = std::max(right, pixel.col);
+    }
+    if (bottom < 0) {
+        return;
+    }
+
+    const cv::Rect bounds(left, top, right - left + 1, bottom - top + 1);
+    std::vector<bool> marked(bounds.area(), false);
+    for (const CarePixel& pixel : care_) {
+        if (pixel.black == black) {
+            marked[(pixel.row - top) * bounds.width + pixel.col - left] = true;
+        }
+    }
+    std::vector<bool> holes(marked.size());
+    for (size_t index = 0; index < marked.size(); index += 1) {
+        holes[index] = !marked[index];
+    }
+
+    const std::vector<cv::Rect> direct = GreedyRectangles(marked, bounds.height, bounds.width);
+    const std::vector<cv::Rect> subtracted = GreedyRectangles(holes, bounds.height, bounds.width);
+
+    const cv::Point shift = bounds.tl();
+    if (direct.size() <= subtracted.size() + 1) {
+        for (const cv::Rect& rect : direct) {
+            rectangles_.push_back({ rect + shift, 1, black });
+        }
+        return;
+    }
+    rectangles_.push_back({ bounds, 1, black });
+    for (const cv::Rect& rect : subtracted) {
+        rectangles_.push_back({ rect + shift, -1, black });
+    }
+}
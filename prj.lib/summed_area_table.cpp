@@ -0,0 +1,111 @@
+#include<hitOrMiss/summed_area_table.hpp>
+
+#include <algorithm>
+
+namespace {
+
+const int kBlack = 0; // код черного пикселя
+
+// Прямоугольник разложения в виде смещений четырех углов в таблице от левого верхнего угла окна
+struct Probe {
+    int top_left = 0;
+    int top_right = 0;
+    int bottom_left = 0;
+    int bottom_right = 0;
+    int sign = 1;
+};
+
+// Прямоугольники разложения, память под которые переиспользуется между проходами в одном потоке
+std::vector<Probe>& ThreadProbes() {
+    thread_local std::vector<Probe> probes;
+    return probes;
+}
+
+}
+
+SummedAreaTable::SummedAreaTable(const cv::Mat& image) {
+    Build(image);
+}
+
+void SummedAreaTable::Build(const cv::Mat& image) {
+    CV_Assert(image.type() == CV_8UC1);
+
+    rows_ = image.rows;
+    cols_ = image.cols;
+    stride_ = cols_ + 1;
+    sums_.assign(static_cast<size_t>(rows_ + 1) * stride_, 0);
+    for (int row = 0; row < rows_; row += 1) {
+        const uchar* pixels = image.ptr<uchar>(row);
+        const int32_t* above = sums_.data() + static_cast<size_t>(row) * stride_;
+        int32_t* sums = sums_.data() + static_cast<size_t>(row + 1) * stride_;
+        int32_t row_sum = 0;
+        for (int col = 0; col < cols_; col += 1) {
+            row_sum += pixels[col] == kBlack;
+            sums[col + 1] = above[col + 1] + row_sum;
+        }
+    }
+}
+
+bool SummedAreaTable::Supports(const StructuringElement& element) {
+    const size_t rectangles = element.get_rectangles().size();
+    return rectangles > 0 && rectangles < element.get_care().size();
+}
+
+void SummedAreaTable::Match(const StructuringElement& element, int row_begin, int row_end, cv::Mat& hits) const {
+    Match(element, cv::Rect(0, row_begin, cols_, row_end - row_begin), hits);
+}
+
+void SummedAreaTable::Match(const StructuringElement& element, const cv::Rect& windows, cv::Mat& hits) const {
+    const cv::Size& window = element.get_size();
+    const int row_begin = windows.y;
+    const int col_begin = windows.x;
+    const int last_row = std::min(rows_ - window.height, windows.y + windows.height - 1);
+    const int last_col = std::min(cols_ - window.width, windows.x + windows.width - 1);
+    if (window.empty() || last_row < row_begin || last_col < col_begin) {
+        return;
+    }
+
+    // черные прямоугольники разложения идут первыми
+    std::vector<Probe>& probes = ThreadProbes();
+    probes.clear();
+    int black_probes = 0;
+    for (const StructuringElement::CareRectangle& care : element.get_rectangles()) {
+        const int top = care.rect.y * stride_;
+        const int bottom = (care.rect.y + care.rect.height) * stride_;
+        probes.push_back({ top + care.rect.x, top + care.rect.x + care.rect.width,
+            bottom + care.rect.x, bottom + care.rect.x + care.rect.width, care.sign });
+        black_probes += care.black;
+    }
+    int black_total = 0;
+    for (const CarePixel& pixel : element.get_care()) {
+        black_total += pixel.black;
+    }
+
+    const int probe_count = static_cast<int>(probes.size());
+    for (int mask_row = row_begin; mask_row <= last_row; mask_row += 1) {
+        const int32_t* origin = sums_.data() + static_cast<size_t>(mask_row) * stride_;
+        uchar* hits_row = hits.ptr<uchar>(mask_row);
+        for (int mask_col = col_begin; mask_col <= last_col; mask_col += 1) {
+            // все черные значимые пиксели черные
+            int black = 0;
+            for (int index = 0; index < black_probes; index += 1) {
+                const Probe& probe = probes[index];
+                black += probe.sign * (origin[mask_col + probe.bottom_right] - origin[mask_col + probe.bottom_left]
+                    - origin[mask_col + probe.top_right] + origin[mask_col + probe.top_left]);
+            }
+            if (black != black_total) {
+                hits_row[mask_col] = 0;
+                continue;
+            }
+
+            // среди белых значимых пикселей нет черных
+            black = 0;
+            for (int index = black_probes; index < probe_count; index += 1) {
+                const Probe& probe = probes[index];
+                black += probe.sign * (origin[mask_col + probe.bottom_right] - origin[mask_col + probe.bottom_left]
+                    - origin[mask_col + probe.top_right] + origin[mask_col + probe.top_left]);
+            }
+            hits_row[mask_col] = black == 0;
+        }
+    }
+}
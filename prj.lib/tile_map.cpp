@@ -0,0 +1,109 @@
+#include<hitOrMiss/tile_map.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+const int kWordBits = 64; // количество пикселей в слове упакованного изображения
+
+}
+
+static_assert(kWordBits == 2 * TileMap::kTileSize, "a packed word holds two tiles");
+
+TileMap::TileMap(const BitPlane& image) {
+    Build(image);
+}
+
+void TileMap::Build(const BitPlane& image) {
+    tile_rows_ = (image.get_rows() + kTileSize - 1) / kTileSize;
+    tile_cols_ = (image.get_cols() + kTileSize - 1) / kTileSize;
+    tiles_.assign(static_cast<size_t>(tile_rows_) * tile_cols_, Tile::kMixed);
+    for (int tile_row = 0; tile_row < tile_rows_; tile_row += 1) {
+        for (int tile_col = 0; tile_col < tile_cols_; tile_col += 1) {
+            tiles_[static_cast<size_t>(tile_row) * tile_cols_ + tile_col] = Classify(image, tile_row, tile_col);
+        }
+    }
+    BuildSums();
+}
+
+void TileMap::Update(const BitPlane& image, const cv::Rect& pixels) {
+    const int top = pixels.y / kTileSize;
+    const int left = pixels.x / kTileSize;
+    const int bottom = (pixels.y + pixels.height - 1) / kTileSize + 1;
+    const int right = (pixels.x + pixels.width - 1) / kTileSize + 1;
+    bool changed = false;
+    for (int tile_row = top; tile_row < bottom; tile_row += 1) {
+        for (int tile_col = left; tile_col < right; tile_col += 1) {
+            Tile& tile = tiles_[static_cast<size_t>(tile_row) * tile_cols_ + tile_col];
+            const Tile updated = Classify(image, tile_row, tile_col);
+            changed = changed || updated != tile;
+            tile = updated;
+        }
+    }
+
+    // суммы пересчитываются по тайлам, а не по пикселям, и только если состояние изменилось
+    if (changed) {
+        BuildSums();
+    }
+}
+
+TileMap::Tile TileMap::Classify(const BitPlane& image, int tile_row, int tile_col) const {
+
+    // в слове два тайла: младшие 32 бита - четный, старшие - нечетный
+    const int row_end = std::min(image.get_rows(), (tile_row + 1) * kTileSize);
+    const int width = std::min(kTileSize, image.get_cols() - tile_col * kTileSize);
+    const uint32_t mask = width == kTileSize ? ~uint32_t{ 0 } : (uint32_t{ 1 } << width) - 1;
+    uint32_t any_black = 0;
+    bool all_black = true;
+    for (int row = tile_row * kTileSize; row < row_end; row += 1) {
+        const uint32_t bits = static_cast<uint32_t>(image.Row(row)[tile_col / 2] >> (tile_col % 2 * kTileSize));
+        any_black |= bits;
+        all_black = all_black && bits == mask;
+    }
+    if (any_black == 0) {
+        return Tile::kWhite;
+    }
+    return all_black ? Tile::kBlack : Tile::kMixed;
+}
+
+void TileMap::BuildSums() {
+
+    // накопленные суммы с нулевыми первыми строкой и столбцом
+    const int stride = tile_cols_ + 1;
+    white_sums_.assign(static_cast<size_t>(tile_rows_ + 1) * stride, 0);
+    black_sums_.assign(white_sums_.size(), 0);
+    for (int tile_row = 0; tile_row < tile_rows_; tile_row += 1) {
+        int white = 0;
+        int black = 0;
+        for (int tile_col = 0; tile_col < tile_cols_; tile_col += 1) {
+            white += At(tile_row, tile_col) == Tile::kWhite;
+            black += At(tile_row, tile_col) == Tile::kBlack;
+            const size_t index = static_cast<size_t>(tile_row + 1) * stride + tile_col + 1;
+            white_sums_[index] = white_sums_[index - stride] + white;
+            black_sums_[index] = black_sums_[index - stride] + black;
+        }
+    }
+    uniform_count_ = Count(white_sums_, 0, 0, tile_rows_, tile_cols_) + Count(black_sums_, 0, 0, tile_rows_, tile_cols_);
+}
+
+TileMap::Tile TileMap::Region(const cv::Rect& pixels) const {
+    const int top = pixels.y / kTileSize;
+    const int left = pixels.x / kTileSize;
+    const int bottom = (pixels.y + pixels.height - 1) / kTileSize + 1;
+    const int right = (pixels.x + pixels.width - 1) / kTileSize + 1;
+    const int area = (bottom - top) * (right - left);
+    if (Count(white_sums_, top, left, bottom, right) == area) {
+        return Tile::kWhite;
+    }
+    if (Count(black_sums_, top, left, bottom, right) == area) {
+        return Tile::kBlack;
+    }
+    return Tile::kMixed;
+}
+
+int TileMap::Count(const std::vector<int>& sums, int top, int left, int bottom, int right) const {
+    const int stride = tile_cols_ + 1;
+    return sums[static_cast<size_t>(bottom) * stride + right] - sums[static_cast<size_t>(bottom) * stride + left]
+        - sums[static_cast<size_t>(top) * stride + right] + sums[static_cast<size_t>(top) * stride + left];
+}
@@ -0,0 +1,167 @@
+#include<hitOrMiss/binary_image.hpp>
+#include<hitOrMiss/hit_or_miss.hpp>
+#include "test_utils.hpp"
+
+#include <iostream>
+#include <random>
+
+// Случайное изображение заданного типа, значения равномерно по диапазону [0, range]
+cv::Mat RandomImage(std::mt19937& rng, int rows, int cols, int type, double range) {
+    std::uniform_real_distribution<double> value(0.0, range);
+    cv::Mat image{ rows, cols, type };
+    for (int row = 0; row < rows; row += 1) {
+        for (int col = 0; col < cols * image.channels(); col += 1) {
+            switch (image.depth()) {
+            case CV_8U:
+                image.ptr<uchar>(row)[col] = static_cast<uchar>(value(rng));
+                break;
+            case CV_16U:
+                image.ptr<ushort>(row)[col] = static_cast<ushort>(value(rng));
+                break;
+            default:
+                image.ptr<float>(row)[col] = static_cast<float>(value(rng));
+                break;
+            }
+        }
+    }
+    return image;
+}
+
+// Эталонная бинаризация: сначала преобразование, потом порог
+cv::Mat ReferenceBinary(const cv::Mat& src, double threshold) {
+    cv::Mat gray = src;
+    if (src.type() == CV_8UC3) {
+        cv::cvtColor(src, gray, cv::COLOR_BGR2GRAY);
+    }
+    cv::Mat binary{ src.rows, src.cols, CV_8UC1 };
+    for (int row = 0; row < src.rows; row += 1) {
+        for (int col = 0; col < src.cols; col += 1) {
+            double value = 0;
+            switch (gray.depth()) {
+            case CV_8U:
+                value = gray.at<uchar>(row, col);
+                break;
+            case CV_16U:
+                value = gray.at<ushort>(row, col);
+                break;
+            default:
+                value = gray.at<float>(row, col);
+                break;
+            }
+            binary.at<uchar>(row, col) = value > threshold ? 255 : 0;
+        }
+    }
+    return binary;
+}
+
+int main() {
+    std::mt19937 rng(20261017);
+    int failures = 0;
+
+    // преобразование и порог за один проход совпадают с эталоном, исходное изображение не меняется
+    struct Case {
+        int type;
+        double range;
+        double threshold;
+    };
+    const Case cases[] = {
+        { CV_8UC1, 255, 127 }, { CV_8UC1, 255, 200.5 }, { CV_8UC1, 255, -3 },
+        { CV_8UC3, 255, 127 }, { CV_8UC3, 255, 60 },
+        { CV_16UC1, 65535, 32767 }, { CV_16UC1, 4095, 1000 },
+        { CV_32FC1, 1, 0.5 }, { CV_32FC1, 255, 127 },
+    };
+    for (const Case& test : cases) {
+        for (int size = 1; size < 80; size += 13) {
+            const cv::Mat src = RandomImage(rng, size, size + 7, test.type, test.range);
+            const cv::Mat original = src.clone();
+            const BinaryImage binary(src, test.threshold);
+            if (!Equal(binary.get_image(), ReferenceBinary(src, test.threshold)) || !Equal(src, original)
+                || !BinaryImage::IsBinary(binary.get_image())) {
+                std::cout << "Binarization mismatch: type " << test.type << ", threshold " << test.threshold << std::endl;
+                failures += 1;
+            }
+        }
+    }
+
+    // порог по умолчанию и прямоугольник внутри большего изображения
+    const cv::Mat wide = RandomImage(rng, 40, 90, CV_16UC1, 65535);
+    const cv::Mat roi = wide(cv::Rect(11, 5, 50, 30));
+    if (!Equal(BinaryImage(roi).get_image(), ReferenceBinary(roi, 32767))) {
+        std::cout << "ROI binarization mismatch" << std::endl;
+        failures += 1;
+    }
+    const cv::Mat unit = RandomImage(rng, 20, 20, CV_32FC1, 1);
+    if (!Equal(BinaryImage(unit).get_image(), ReferenceBinary(unit, 0.5))) {
+        std::cout << "Default float threshold mismatch" << std::endl;
+        failures += 1;
+    }
+
+    // проверка бинарности
+    const cv::Mat binary = ReferenceBinary(RandomImage(rng, 30, 30, CV_8UC1, 255), 127);
+    cv::Mat gray = binary.clone();
+    gray.at<uchar>(17, 3) = 128;
+    if (!BinaryImage::IsBinary(binary) || BinaryImage::IsBinary(gray)
+        || BinaryImage::IsBinary(cv::Mat{ 2, 2, CV_8UC3, cv::Scalar(0) })) {
+        std::cout << "IsBinary mismatch" << std::endl;
+        failures += 1;
+    }
+
+    // обертка над бинарным изображением не копирует его, Assign не пишет в чужую память
+    BinaryImage wrapped = BinaryImage::FromBinary(binary);
+    if (wrapped.get_image().data != binary.data) {
+        std::cout << "FromBinary copied the image" << std::endl;
+        failures += 1;
+    }
+#ifndef NDEBUG
+    // в отладочной сборке небинарное изображение не оборачивается
+    try {
+        BinaryImage::FromBinary(gray);
+        std::cout << "FromBinary accepted a non-binary image in a debug build" << std::endl;
+        failures += 1;
+    }
+    catch (const cv::Exception&) {
+    }
+#endif
+    const cv::Mat kept = binary.clone();
+    wrapped.Assign(gray, 250);
+    if (!Equal(binary, kept) || !Equal(wrapped.get_image(), ReferenceBinary(gray, 250))) {
+        std::cout << "Assign wrote into a wrapped image" << std::endl;
+        failures += 1;
+    }
+    const uchar* data = wrapped.get_image().data;
+    wrapped.Assign(binary);
+    if (wrapped.get_image().data != data || !Equal(wrapped.get_image(), binary)) {
+        std::cout << "Assign did not reuse its memory" << std::endl;
+        failures += 1;
+    }
+
+    // HitOrMiss не меняет переданное изображение и принимает его в любом поддерживаемом типе
+    const cv::Mat color = RandomImage(rng, 60, 70, CV_8UC3, 255);
+    cv::Mat color_gray;
+    cv::cvtColor(color, color_gray, cv::COLOR_BGR2GRAY);
+    const cv::Mat color_original = color.clone();
+    const cv::Mat gray_original = color_gray.clone();
+    const cv::Mat kernel{ 3, 3, CV_8UC1, cv::Scalar(0) };
+    HitOrMiss from_gray(color_gray, kernel);
+    HitOrMiss from_color(color, kernel);
+    HitOrMiss from_binary;
+    from_binary.set_kernel_foreground(kernel);
+    from_binary.set_image(BinaryImage(color_gray));
+    if (!Equal(color, color_original) || !Equal(color_gray, gray_original)) {
+        std::cout << "HitOrMiss modified the caller's image" << std::endl;
+        failures += 1;
+    }
+    if (!Equal(from_gray.DoHitOrMiss(), from_color.DoHitOrMiss())
+        || !Equal(from_gray.DoHitOrMiss(), from_binary.DoHitOrMiss())
+        || !Equal(from_gray.DoBoundaryExtraction(), from_binary.DoBoundaryExtraction())) {
+        std::cout << "HitOrMiss result depends on the input type" << std::endl;
+        failures += 1;
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include<hitOrMiss/hit_or_miss.hpp>
+#include<hitOrMiss/bit_plane.hpp>
+#include "test_utils.hpp"
+
+#include <iostream>
+#include <random>
+
+int main() {
+    std::mt19937 rng(20231017);
+    int failures = 0;
+
+    // упаковка и распаковка не меняют изображение
+    for (int cols : { 1, 7, 63, 64, 65, 130 }) {
+        cv::Mat image = RandomBinary(rng, 5, cols, 0.5);
+        cv::Mat unpacked;
+        BitPlane::Pack(image).Unpack(unpacked);
+        if (!Equal(image, unpacked)) {
+            std::cout << "Pack/Unpack mismatch, cols=" << cols << std::endl;
+            failures += 1;
+        }
+    }
+
+    // упакованный движок совпадает с побайтовым проходом
+    for (int test = 0; test < 200; test += 1) {
+        std::uniform_int_distribution<int> image_size(1, 150);
+        std::uniform_int_distribution<int> kernel_size(1, 7);
+        const int kernel_rows = kernel_size(rng);
+        const int kernel_cols = kernel_size(rng);
+
+        const double image_black = test % 2 == 0 ? 0.9 : 0.5;
+        const double kernel_black = test % 2 == 0 ? 0.7 : 0.3;
+
+        HitOrMiss hit_or_miss(RandomBinary(rng, image_size(rng), image_size(rng), image_black));
+        hit_or_miss.set_kernel_foreground(RandomBinary(rng, kernel_rows, kernel_cols, kernel_black));
+        if (test % 3 != 0) {
+            hit_or_miss.set_kernel_background(RandomBinary(rng, kernel_rows, kernel_cols, kernel_black));
+        }
+        if (test % 4 == 0) {
+            hit_or_miss.set_hit_highlight(RandomBinary(rng, kernel_rows, kernel_cols, 0.5));
+        }
+
+        hit_or_miss.set_engine(HitOrMiss::Engine::kBytewise);
+        const cv::Mat expected_hit = hit_or_miss.DoHitOrMiss();
+        const cv::Mat expected_boundary = hit_or_miss.DoBoundaryExtraction();
+
+        hit_or_miss.set_engine(HitOrMiss::Engine::kBitPlane);
+        if (!Equal(expected_hit, hit_or_miss.DoHitOrMiss())) {
+            std::cout << "DoHitOrMiss mismatch, test " << test << std::endl;
+            failures += 1;
+        }
+        if (!Equal(expected_boundary, hit_or_miss.DoBoundaryExtraction())) {
+            std::cout << "DoBoundaryExtraction mismatch, test " << test << std::endl;
+            failures += 1;
+        }
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include<hitOrMiss/hit_or_miss.hpp>
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+// Изображение, дополненное на pad_rows строк и pad_cols столбцов с каждой стороны по режиму границы
+cv::Mat Pad(const cv::Mat& image, int pad_rows, int pad_cols, HitOrMiss::BorderMode mode) {
+    cv::Mat padded{ image.rows + 2 * pad_rows, image.cols + 2 * pad_cols, CV_8UC1 };
+    for (int row = 0; row < padded.rows; row += 1) {
+        for (int col = 0; col < padded.cols; col += 1) {
+            const int source_row = row - pad_rows;
+            const int source_col = col - pad_cols;
+            uchar value = mode == HitOrMiss::BorderMode::kBlack ? 0 : 255;
+            if (source_row >= 0 && source_row < image.rows && source_col >= 0 && source_col < image.cols) {
+                value = image.at<uchar>(source_row, source_col);
+            }
+            else if (mode == HitOrMiss::BorderMode::kReplicate) {
+                value = image.at<uchar>(std::clamp(source_row, 0, image.rows - 1), std::clamp(source_col, 0, image.cols - 1));
+            }
+            padded.at<uchar>(row, col) = value;
+        }
+    }
+    return padded;
+}
+
+// Эталон: Hit or Miss без выхода за край по дополненному изображению, вырезанный по исходному
+cv::Mat ReferenceHitOrMiss(const cv::Mat& image, const cv::Mat& foreground, const cv::Mat& background,
+    const cv::Mat& highlight, HitOrMiss::BorderMode mode) {
+    const int pad_rows = std::max(foreground.rows, background.rows) - 1;
+    const int pad_cols = std::max(foreground.cols, background.cols) - 1;
+    HitOrMiss padded(Pad(image, pad_rows, pad_cols, mode), foreground, background, highlight);
+    padded.set_engine(HitOrMiss::Engine::kBytewise);
+    return padded.DoHitOrMiss()(cv::Rect(pad_cols, pad_rows, image.cols, image.rows)).clone();
+}
+
+int main() {
+    std::mt19937 rng(20261017);
+    int failures = 0;
+
+    const HitOrMiss::BorderMode modes[] = { HitOrMiss::BorderMode::kWhite, HitOrMiss::BorderMode::kBlack,
+        HitOrMiss::BorderMode::kReplicate };
+    const HitOrMiss::Engine engines[] = { HitOrMiss::Engine::kBytewise, HitOrMiss::Engine::kBitPlane,
+        HitOrMiss::Engine::kRunLength };
+
+    for (int test = 0; test < 60; test += 1) {
+        std::uniform_int_distribution<int> image_size(1, 60);
+        std::uniform_int_distribution<int> kernel_size(1, test % 5 == 0 ? 9 : 4);
+        const int kernel_rows = kernel_size(rng);
+        const int kernel_cols = kernel_size(rng);
+        const cv::Mat image = RandomBinary(rng, image_size(rng), image_size(rng), test % 3 == 0 ? 0.8 : 0.4);
+        const cv::Mat foreground = RandomBinary(rng, kernel_rows, kernel_cols, 0.6);
+
+        // задний план: белые пиксели там, где передний план не требует черных
+        cv::Mat background = RandomBinary(rng, kernel_rows, kernel_cols, 0.7);
+        for (int row = 0; row < kernel_rows; row += 1) {
+            for (int col = 0; col < kernel_cols; col += 1) {
+                if (foreground.at<uchar>(row, col) == 0) background.at<uchar>(row, col) = 0;
+            }
+        }
+        const cv::Mat highlight = test % 2 == 0 ? cv::Mat{ 1, 1, CV_8UC1, cv::Scalar(0) }
+            : RandomBinary(rng, kernel_rows, kernel_cols, 0.3);
+
+        for (HitOrMiss::BorderMode mode : modes) {
+            const cv::Mat expected = ReferenceHitOrMiss(image, foreground, background, highlight, mode);
+            cv::Mat expected_boundary{ image.rows, image.cols, CV_8UC1 };
+            for (int row = 0; row < image.rows; row += 1) {
+                for (int col = 0; col < image.cols; col += 1) {
+                    const bool boundary = image.at<uchar>(row, col) == 0 && expected.at<uchar>(row, col) != 0;
+                    expected_boundary.at<uchar>(row, col) = boundary ? 0 : 255;
+                }
+            }
+            for (HitOrMiss::Engine engine : engines) {
+                HitOrMiss hit_or_miss(image, foreground, background, highlight);
+                hit_or_miss.set_engine(engine);
+                hit_or_miss.set_border_mode(mode);
+                hit_or_miss.set_thread_count(1 + test % 3);
+                if (!Equal(hit_or_miss.DoHitOrMiss(), expected) || !Equal(hit_or_miss.DoBoundaryExtraction(), expected_boundary)) {
+                    std::cout << "Border mode mismatch: test " << test << ", mode " << static_cast<int>(mode)
+                        << ", engine " << static_cast<int>(engine) << std::endl;
+                    failures += 1;
+                }
+            }
+        }
+    }
+
+    // черный квадрат 3*3: за белым краем граница совпадает с однопроходной, за черным - нет
+    const cv::Mat image{ 8, 8, CV_8UC1, cv::Scalar(0) };
+    const cv::Mat square{ 3, 3, CV_8UC1, cv::Scalar(0) };
+    HitOrMiss hit_or_miss(image, square, square);
+    hit_or_miss.set_border_mode(HitOrMiss::BorderMode::kWhite);
+    const bool white_edge = cv::countNonZero(hit_or_miss.DoBoundaryExtraction()) == 36;
+    hit_or_miss.set_border_mode(HitOrMiss::BorderMode::kBlack);
+    const bool black_edge = cv::countNonZero(hit_or_miss.DoBoundaryExtraction()) == 64;
+    hit_or_miss.set_border_mode(HitOrMiss::BorderMode::kNone);
+    const bool none_edge = cv::countNonZero(hit_or_miss.DoBoundaryExtraction()) == 36;
+    if (!white_edge || !black_edge || !none_edge) {
+        std::cout << "Square boundary mismatch" << std::endl;
+        failures += 1;
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
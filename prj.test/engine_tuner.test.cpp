@@ -0,0 +1,161 @@
+#include<hitOrMiss/engine_tuner.hpp>
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+int main() {
+    std::mt19937 rng(20261017);
+    int failures = 0;
+
+    if (HitOrMiss().get_engine() != HitOrMiss::Engine::kAuto) {
+        std::cout << "The default engine is not kAuto" << std::endl;
+        failures += 1;
+    }
+
+    const HitOrMiss::BorderMode modes[] = { HitOrMiss::BorderMode::kNone, HitOrMiss::BorderMode::kWhite,
+        HitOrMiss::BorderMode::kReplicate };
+
+    // kOpenCv и выбранный настройщиком движок дают те же результаты, что и остальные движки
+    for (int test = 0; test < 24; test += 1) {
+        std::uniform_int_distribution<int> kernel_size(1, test % 4 == 0 ? 9 : 4);
+        const int kernel_rows = kernel_size(rng);
+        const int kernel_cols = kernel_size(rng);
+        const cv::Mat foreground = RandomBinary(rng, kernel_rows, kernel_cols, 0.6);
+        cv::Mat background = RandomBinary(rng, kernel_rows, kernel_cols, 0.7);
+        for (int row = 0; row < kernel_rows; row += 1) {
+            for (int col = 0; col < kernel_cols; col += 1) {
+                if (foreground.at<uchar>(row, col) == 0) background.at<uchar>(row, col) = 0;
+            }
+        }
+        const cv::Mat highlight = test % 3 == 0 ? RandomBinary(rng, kernel_rows, kernel_cols, 0.3)
+            : cv::Mat{ 1, 1, CV_8UC1, cv::Scalar(0) };
+        const cv::Mat image = RandomBinary(rng, 60 + test, 90 - test, test % 2 == 0 ? 0.3 : 0.8);
+
+        HitOrMiss reference(image, foreground, background, highlight);
+        reference.set_engine(HitOrMiss::Engine::kBytewise);
+        reference.set_border_mode(modes[test % 3]);
+        const cv::Mat expected = reference.DoHitOrMiss();
+        const cv::Mat expected_boundary = reference.DoBoundaryExtraction();
+
+        HitOrMiss opencv(reference);
+        opencv.set_engine(HitOrMiss::Engine::kOpenCv);
+        if (!Equal(opencv.DoHitOrMiss(), expected) || !Equal(opencv.DoBoundaryExtraction(), expected_boundary)) {
+            std::cout << "OpenCV engine mismatch, test " << test << std::endl;
+            failures += 1;
+        }
+
+        const std::shared_ptr<EngineTuner> tuner = std::make_shared<EngineTuner>();
+        tuner->set_verify(true);
+        HitOrMiss tuned(reference);
+        tuned.set_engine(HitOrMiss::Engine::kAuto);
+        tuned.set_engine_tuner(tuner);
+        if (!Equal(tuned.DoHitOrMiss(), expected) || !Equal(tuned.DoBoundaryExtraction(), expected_boundary)) {
+            std::cout << "Auto engine mismatch, test " << test << std::endl;
+            failures += 1;
+        }
+
+        // движок выбран один раз и записан в профиль под сигнатурой параметров
+        HitOrMiss::Engine recorded = HitOrMiss::Engine::kAuto;
+        const std::vector<HitOrMiss::Engine> candidates = EngineTuner::Candidates(tuned);
+        if (tuner->size() != 1 || !tuner->Find(EngineTuner::Signature(tuned), recorded)
+            || recorded != tuned.get_active_engine()
+            || std::find(candidates.begin(), candidates.end(), recorded) == candidates.end()) {
+            std::cout << "Tuner profile mismatch, test " << test << std::endl;
+            failures += 1;
+        }
+
+        // новый размер изображения - новая сигнатура
+        tuned.set_image(RandomBinary(rng, 40, 50, 0.5));
+        tuned.DoHitOrMiss();
+        if (tuner->size() != 2) {
+            std::cout << "Tuner did not record a new image size, test " << test << std::endl;
+            failures += 1;
+        }
+    }
+
+    // значимые пиксели переднего и заднего плана в одних местах: ни одно окно не совпадает
+    {
+        cv::Mat image{ 20, 20, CV_8UC1, cv::Scalar(255) };
+        image(cv::Rect(0, 0, 8, 8)).setTo(cv::Scalar(0));
+        const cv::Mat foreground{ 3, 3, CV_8UC1, cv::Scalar(0) };
+        const cv::Mat background{ 3, 3, CV_8UC1, cv::Scalar(255) };
+        const cv::Mat highlight{ 1, 1, CV_8UC1, cv::Scalar(0) };
+        const cv::Mat white{ image.rows, image.cols, CV_8UC1, cv::Scalar(255) };
+        const HitOrMiss::Engine engines[] = { HitOrMiss::Engine::kBytewise, HitOrMiss::Engine::kBitPlane,
+            HitOrMiss::Engine::kRunLength, HitOrMiss::Engine::kOpenCv, HitOrMiss::Engine::kAuto };
+        for (HitOrMiss::Engine engine : engines) {
+            HitOrMiss conflicting(image, foreground, background, highlight);
+            conflicting.set_engine(engine);
+            const std::shared_ptr<EngineTuner> tuner = std::make_shared<EngineTuner>();
+            tuner->set_verify(true);
+            conflicting.set_engine_tuner(tuner);
+            try {
+                if (!Equal(conflicting.DoHitOrMiss(), white)) {
+                    std::cout << "Conflicting care pixels matched, engine " << static_cast<int>(engine) << std::endl;
+                    failures += 1;
+                }
+            }
+            catch (const std::logic_error&) {
+                std::cout << "Conflicting care pixels failed verification, engine " << static_cast<int>(engine) << std::endl;
+                failures += 1;
+            }
+        }
+    }
+
+    // профиль на диске: записывается после замера и читается новым настройщиком вместо замера
+    {
+        const std::string path = "engine_tuner.test.profile";
+        std::remove(path.c_str());
+        const cv::Mat image = RandomBinary(rng, 50, 70, 0.5);
+        HitOrMiss hit_or_miss(image);
+        hit_or_miss.set_engine_tuner(std::make_shared<EngineTuner>(path));
+        hit_or_miss.DoHitOrMiss();
+
+        const std::string signature = EngineTuner::Signature(hit_or_miss);
+        HitOrMiss::Engine loaded = HitOrMiss::Engine::kAuto;
+        if (!EngineTuner(path).Find(signature, loaded) || loaded != hit_or_miss.get_active_engine()) {
+            std::cout << "Profile was not saved" << std::endl;
+            failures += 1;
+        }
+
+        {
+            std::ofstream file(path);
+            file << "run_length " << signature << "\n" << "broken\n";
+        }
+        HitOrMiss profiled(image);
+        profiled.set_engine_tuner(std::make_shared<EngineTuner>(path));
+        HitOrMiss reference(image);
+        reference.set_engine(HitOrMiss::Engine::kBitPlane);
+        if (!Equal(profiled.DoHitOrMiss(), reference.DoHitOrMiss())
+            || profiled.get_active_engine() != HitOrMiss::Engine::kRunLength) {
+            std::cout << "Profile was not used" << std::endl;
+            failures += 1;
+        }
+        std::remove(path.c_str());
+    }
+
+    // без настройщика kAuto работать не может
+    bool thrown = false;
+    try {
+        HitOrMiss().set_engine_tuner(nullptr);
+    }
+    catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    if (!thrown) {
+        std::cout << "Empty tuner accepted" << std::endl;
+        failures += 1;
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
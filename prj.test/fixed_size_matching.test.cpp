@@ -0,0 +1,106 @@
+#include<hitOrMiss/fixed_size_matching.hpp>
+#include<hitOrMiss/hit_or_miss.hpp>
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Элемент со случайными значимыми пикселями обоих цветов; contradictory - с пикселями,
+// которые должны быть и черными, и белыми
+StructuringElement RandomElement(std::mt19937& rng, const cv::Size& size, bool contradictory = false) {
+    const cv::Mat foreground = RandomBinary(rng, size.height, size.width, 0.3);
+    cv::Mat background = RandomBinary(rng, size.height, size.width, 0.7);
+    for (int row = 0; row < size.height && !contradictory; row += 1) {
+        for (int col = 0; col < size.width; col += 1) {
+            if (foreground.at<uchar>(row, col) == 0) background.at<uchar>(row, col) = 0;
+        }
+    }
+    return StructuringElement::Combine(StructuringElement(foreground, true), cv::Point(),
+        StructuringElement(background, false), cv::Point(), size);
+}
+
+// Проход по списку значимых пикселей
+void GenericMatch(const cv::Mat& image, const StructuringElement& element, cv::Mat& hits) {
+    for (int row = 0; row < hits.rows; row += 1) {
+        uchar* hits_row = hits.ptr<uchar>(row);
+        for (int col = 0; col < hits.cols; col += 1) {
+            hits_row[col] = element.Match(image, row, col);
+        }
+    }
+}
+
+int main() {
+    std::mt19937 rng(20231017);
+    int failures = 0;
+
+    // каждая специализация совпадает с проходом по списку значимых пикселей
+    std::vector<cv::Size> sizes;
+    for (int rows = 1; rows <= 7; rows += 1) {
+        for (int cols = 1; cols <= 7; cols += 1) {
+            sizes.emplace_back(cols, rows);
+        }
+    }
+    for (int side = 9; side <= 21; side += 2) {
+        sizes.emplace_back(side, side);
+    }
+    std::uniform_int_distribution<int> extra(0, 40);
+    for (const cv::Size& size : sizes) {
+        if (!FixedSizeMatching::Supports(RandomElement(rng, size))) {
+            std::cout << "No specialization for " << size.height << "*" << size.width << std::endl;
+            failures += 1;
+            continue;
+        }
+        for (int test = 0; test < 4; test += 1) {
+            const StructuringElement element = RandomElement(rng, size, test == 3);
+            const cv::Mat image = RandomBinary(rng, size.height + extra(rng), size.width + extra(rng), 0.7);
+            cv::Mat expected{ image.rows - size.height + 1, image.cols - size.width + 1, CV_8UC1 };
+            cv::Mat hits{ expected.rows, expected.cols, CV_8UC1, cv::Scalar(2) };
+            GenericMatch(image, element, expected);
+            FixedSizeMatching::Match(image, element, 0, hits.rows, hits);
+            for (int row = 0; row < hits.rows; row += 1) {
+                if (std::memcmp(hits.ptr<uchar>(row), expected.ptr<uchar>(row), hits.cols) != 0) {
+                    std::cout << "Mismatch for " << size.height << "*" << size.width << ", test " << test << std::endl;
+                    failures += 1;
+                    break;
+                }
+            }
+        }
+    }
+    for (const cv::Size& size : { cv::Size(8, 8), cv::Size(10, 10), cv::Size(9, 7), cv::Size(23, 23) }) {
+        if (FixedSizeMatching::Find(size) != nullptr) {
+            std::cout << "Unexpected specialization for " << size.height << "*" << size.width << std::endl;
+            failures += 1;
+        }
+    }
+
+    // специализация против прохода по списку значимых пикселей
+    const cv::Mat image = RandomBinary(rng, 1024, 1024, 0.8);
+    for (int side : { 3, 5, 7, 15 }) {
+        const StructuringElement element = RandomElement(rng, cv::Size(side, side));
+        cv::Mat hits{ image.rows - side + 1, image.cols - side + 1, CV_8UC1 };
+        double generic = 0;
+        double fixed = 0;
+        for (int run = 0; run < 3; run += 1) {
+            int64 start = cv::getTickCount();
+            GenericMatch(image, element, hits);
+            const double generic_elapsed = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+            start = cv::getTickCount();
+            FixedSizeMatching::Match(image, element, 0, hits.rows, hits);
+            const double fixed_elapsed = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+            generic = run == 0 ? generic_elapsed : std::min(generic, generic_elapsed);
+            fixed = run == 0 ? fixed_elapsed : std::min(fixed, fixed_elapsed);
+        }
+        std::cout << side << "*" << side << " on 1024*1024: generic " << generic << " ms, specialized "
+            << fixed << " ms" << std::endl;
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
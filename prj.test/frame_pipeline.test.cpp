@@ -0,0 +1,230 @@
+#include<hitOrMiss/frame_pipeline.hpp>
+#include "test_utils.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+// Счетчик выделений памяти через глобальный operator new (стадии работают в разных потоках)
+std::atomic<long> g_allocations{ 0 };
+
+// Все operator new выделяют через std::malloc, все operator delete освобождают через std::free
+void* CountedMalloc(std::size_t size) {
+    g_allocations += 1;
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) {
+    return CountedMalloc(size);
+}
+
+void* operator new[](std::size_t size) {
+    return CountedMalloc(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+// Случайное изображение в оттенках серого с заданной долей темных пикселей
+cv::Mat RandomGray(std::mt19937& rng, int rows, int cols, double dark_ratio) {
+    std::bernoulli_distribution dark(dark_ratio);
+    std::uniform_int_distribution<int> level(0, 120);
+    cv::Mat image{ rows, cols, CV_8UC1 };
+    for (int row = 0; row < rows; row += 1) {
+        for (int col = 0; col < cols; col += 1) {
+            image.at<uchar>(row, col) = static_cast<uchar>(dark(rng) ? level(rng) : 255 - level(rng));
+        }
+    }
+    return image;
+}
+
+int main() {
+    std::mt19937 rng(20261017);
+    int failures = 0;
+
+    cv::Mat corner{ 3, 3, CV_8UC1, cv::Scalar(255) };
+    corner.at<uchar>(1, 1) = 0;
+    corner.at<uchar>(1, 2) = 0;
+    corner.at<uchar>(2, 1) = 0;
+    cv::Mat corner_background{ 3, 3, CV_8UC1, cv::Scalar(0) };
+    corner_background.at<uchar>(0, 0) = 255;
+    const cv::Mat center{ 1, 1, CV_8UC1, cv::Scalar(0) };
+
+    std::vector<cv::Mat> frames;
+    for (int index = 0; index < 5; index += 1) {
+        frames.push_back(RandomGray(rng, 120, 160, 0.4));
+    }
+    HitOrMiss settings(frames[0], corner, corner_background, center);
+    settings.set_border_mode(HitOrMiss::BorderMode::kWhite);
+
+    // результаты совпадают с прямым вызовом, кадры выдаются по порядку в памяти из постоянного набора
+    const int frame_count = 40;
+    for (FramePipeline::Output output : { FramePipeline::Output::kHitOrMiss, FramePipeline::Output::kBoundary }) {
+        std::vector<cv::Mat> expected;
+        for (const cv::Mat& frame : frames) {
+            HitOrMiss reference(settings);
+            reference.set_image(frame);
+            expected.push_back(output == FramePipeline::Output::kBoundary ? reference.DoBoundaryExtraction()
+                : reference.DoHitOrMiss());
+        }
+
+        FramePipeline pipeline(settings, output, 3);
+        for (int run = 0; run < 2; run += 1) {
+            int read = 0;
+            int next_index = 0;
+            int mismatches = 0;
+            std::set<const uchar*> buffers;
+            long allocations_before = 0;
+            long allocations = 0;
+            const FramePipeline::Stats stats = pipeline.Run(
+                [&](cv::Mat& frame) {
+                    if (read == frame_count) {
+                        return false;
+                    }
+                    frames[read % frames.size()].copyTo(frame);
+                    read += 1;
+                    return true;
+                },
+                [&](int index, const cv::Mat& result) {
+                    if (index == 10) {
+                        allocations_before = g_allocations;
+                    }
+                    if (index == frame_count - 1) {
+                        allocations = g_allocations - allocations_before;
+                    }
+                    if (index != next_index || !Equal(result, expected[index % expected.size()])) {
+                        mismatches += 1;
+                    }
+                    next_index += 1;
+                    if (buffers.size() < 8) {
+                        buffers.insert(result.data);
+                    }
+                });
+            if (mismatches != 0 || next_index != frame_count) {
+                std::cout << "Pipeline result mismatch: " << mismatches << " frames, " << next_index << " emitted"
+                    << std::endl;
+                failures += 1;
+            }
+            if (buffers.size() > 3) {
+                std::cout << "Pipeline results use " << buffers.size() << " buffers" << std::endl;
+                failures += 1;
+            }
+            if (allocations != 0) {
+                std::cout << "Pipeline run " << run << ": " << allocations << " allocations in steady state" << std::endl;
+                failures += 1;
+            }
+            if (stats.frames != frame_count || stats.decode.frames != frame_count || stats.binarize.frames != frame_count
+                || stats.match.frames != frame_count || stats.encode.frames != frame_count || stats.Fps() <= 0) {
+                std::cout << "Pipeline stats mismatch: " << stats.frames << " frames" << std::endl;
+                failures += 1;
+            }
+        }
+    }
+
+    // стадии работают одновременно: время прогона ближе к самой медленной стадии, чем к сумме
+    {
+        const auto delay = std::chrono::milliseconds(10);
+        const int count = 20;
+        int read = 0;
+        FramePipeline pipeline(settings, FramePipeline::Output::kHitOrMiss);
+        const FramePipeline::Stats stats = pipeline.Run(
+            [&](cv::Mat& frame) {
+                if (read == count) {
+                    return false;
+                }
+                std::this_thread::sleep_for(delay);
+                frames[0].copyTo(frame);
+                read += 1;
+                return true;
+            },
+            [&](int, const cv::Mat&) { std::this_thread::sleep_for(delay); });
+        const double serial = stats.decode.busy_seconds + stats.binarize.busy_seconds + stats.match.busy_seconds
+            + stats.encode.busy_seconds;
+        if (stats.frames != count || stats.seconds > 0.8 * serial) {
+            std::cout << "Pipeline stages do not overlap: " << stats.seconds << " s of " << serial << " s" << std::endl;
+            failures += 1;
+        }
+    }
+
+    // исключение стадии останавливает конвейер и передается из Run
+    for (int failing_stage = 0; failing_stage < 2; failing_stage += 1) {
+        FramePipeline pipeline(settings, FramePipeline::Output::kHitOrMiss, 2);
+        bool thrown = false;
+        int read = 0;
+        try {
+            pipeline.Run(
+                [&](cv::Mat& frame) {
+                    if (failing_stage == 0 && read == 5) {
+                        throw std::runtime_error("reader");
+                    }
+                    read += 1;
+                    frames[0].copyTo(frame);
+                    return true;
+                },
+                [&](int index, const cv::Mat&) {
+                    if (failing_stage == 1 && index == 5) {
+                        throw std::runtime_error("handler");
+                    }
+                });
+        }
+        catch (const std::runtime_error& error) {
+            thrown = std::string(error.what()) == (failing_stage == 0 ? "reader" : "handler");
+        }
+        if (!thrown) {
+            std::cout << "Stage " << failing_stage << " exception is lost" << std::endl;
+            failures += 1;
+        }
+    }
+
+    // пустые последовательности и неверные аргументы
+    {
+        FramePipeline pipeline(settings, FramePipeline::Output::kHitOrMiss);
+        int emitted = 0;
+        const FramePipeline::Stats stats = pipeline.Run(std::vector<std::string>(),
+            [&](int, const cv::Mat&) { emitted += 1; });
+        if (emitted != 0 || stats.frames != 0) {
+            std::cout << "Empty sequence emitted frames" << std::endl;
+            failures += 1;
+        }
+        bool thrown = false;
+        try {
+            FramePipeline invalid(settings, FramePipeline::Output::kHitOrMiss, 0);
+        }
+        catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        if (!thrown) {
+            std::cout << "Zero queue size accepted" << std::endl;
+            failures += 1;
+        }
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include<hitOrMiss/fused_boundary.hpp>
+#include<hitOrMiss/hit_or_miss.hpp>
+#include "test_utils.hpp"
+
+#include <iostream>
+#include <random>
+
+// Эталон: перебор соседей, за краем изображения белый фон
+cv::Mat ReferenceBoundary(const cv::Mat& image, FusedBoundary::Type type, FusedBoundary::Connectivity connectivity) {
+    cv::Mat boundary{ image.rows, image.cols, CV_8UC1, cv::Scalar(255) };
+    for (int row = 0; row < image.rows; row += 1) {
+        for (int col = 0; col < image.cols; col += 1) {
+            bool white_neighbor = false;
+            bool black_neighbor = false;
+            for (int dy = -1; dy <= 1; dy += 1) {
+                for (int dx = -1; dx <= 1; dx += 1) {
+                    if ((dy == 0 && dx == 0)
+                        || (connectivity == FusedBoundary::Connectivity::kFour && dy != 0 && dx != 0)) {
+                        continue;
+                    }
+                    const int y = row + dy;
+                    const int x = col + dx;
+                    const bool black = y >= 0 && y < image.rows && x >= 0 && x < image.cols && image.at<uchar>(y, x) == 0;
+                    white_neighbor = white_neighbor || !black;
+                    black_neighbor = black_neighbor || black;
+                }
+            }
+            const bool black = image.at<uchar>(row, col) == 0;
+            const bool edge = type == FusedBoundary::Type::kInner ? black && white_neighbor : !black && black_neighbor;
+            if (edge) boundary.at<uchar>(row, col) = 0;
+        }
+    }
+    return boundary;
+}
+
+int main() {
+    std::mt19937 rng(20261017);
+    int failures = 0;
+
+    const FusedBoundary::Type types[] = { FusedBoundary::Type::kInner, FusedBoundary::Type::kOuter };
+    const FusedBoundary::Connectivity connectivities[] = {
+        FusedBoundary::Connectivity::kFour, FusedBoundary::Connectivity::kEight };
+
+    // совпадение с эталоном, в том числе для изображений в одну строку или столбец и по полосам
+    for (int test = 0; test < 120; test += 1) {
+        std::uniform_int_distribution<int> size(1, 70);
+        std::uniform_real_distribution<double> ratio(0.0, 1.0);
+        const cv::Mat image = RandomBinary(rng, size(rng), size(rng), ratio(rng));
+        for (FusedBoundary::Type type : types) {
+            for (FusedBoundary::Connectivity connectivity : connectivities) {
+                const cv::Mat expected = ReferenceBoundary(image, type, connectivity);
+                cv::Mat dst;
+                FusedBoundary::Extract(image, type, connectivity, dst);
+                cv::Mat banded{ image.rows, image.cols, CV_8UC1 };
+                for (int row = 0; row < image.rows; row += 7) {
+                    FusedBoundary::Extract(image, type, connectivity, row, std::min(image.rows, row + 7), banded);
+                }
+                if (!Equal(dst, expected) || !Equal(banded, expected)) {
+                    std::cout << "Boundary mismatch: " << image.rows << "x" << image.cols << std::endl;
+                    failures += 1;
+                }
+            }
+        }
+    }
+
+    // квадрат и крест 3*3 идут однопроходным путем и совпадают с Hit or Miss
+    // с выделением центра окном 3*3 при любом движке и количестве потоков
+    const cv::Mat square{ 3, 3, CV_8UC1, cv::Scalar(0) };
+    cv::Mat cross = square.clone();
+    cross.at<uchar>(0, 0) = cross.at<uchar>(0, 2) = cross.at<uchar>(2, 0) = cross.at<uchar>(2, 2) = 255;
+    cv::Mat center{ 3, 3, CV_8UC1, cv::Scalar(255) };
+    center.at<uchar>(1, 1) = 0;
+    const cv::Mat no_background{ 3, 3, CV_8UC1, cv::Scalar(0) };
+    for (int test = 0; test < 10; test += 1) {
+        const cv::Mat image = RandomBinary(rng, 90 + test, 130 - test, 0.3 + 0.05 * test);
+        for (const cv::Mat& kernel : { square, cross }) {
+            const FusedBoundary::Connectivity connectivity = kernel.at<uchar>(0, 0) == 0
+                ? FusedBoundary::Connectivity::kEight : FusedBoundary::Connectivity::kFour;
+            const cv::Mat expected = ReferenceBoundary(image, FusedBoundary::Type::kInner, connectivity);
+            for (HitOrMiss::Engine engine : { HitOrMiss::Engine::kBytewise, HitOrMiss::Engine::kBitPlane,
+                HitOrMiss::Engine::kRunLength }) {
+                HitOrMiss fused(image, kernel, no_background);
+                HitOrMiss highlighted(image, kernel, no_background, center);
+                fused.set_engine(engine);
+                highlighted.set_engine(engine);
+                fused.set_thread_count(1 + test % 3);
+                if (!Equal(fused.DoBoundaryExtraction(), expected) || !Equal(highlighted.DoBoundaryExtraction(), expected)
+                    || !Equal(fused.DoBoundaryExtraction(FusedBoundary::Type::kInner, connectivity), expected)) {
+                    std::cout << "HitOrMiss boundary mismatch, test " << test << std::endl;
+                    failures += 1;
+                }
+            }
+        }
+    }
+
+    // внешняя граница через HitOrMiss, выход на месте изображения пересоздается
+    const cv::Mat image = RandomBinary(rng, 64, 48, 0.4);
+    HitOrMiss hit_or_miss(image);
+    hit_or_miss.set_thread_count(2);
+    cv::Mat aliased = hit_or_miss.get_image();
+    hit_or_miss.DoBoundaryExtraction(aliased, FusedBoundary::Type::kOuter, FusedBoundary::Connectivity::kFour);
+    if (!Equal(aliased, ReferenceBoundary(image, FusedBoundary::Type::kOuter, FusedBoundary::Connectivity::kFour))
+        || !Equal(hit_or_miss.get_image(), image)) {
+        std::cout << "Outer boundary mismatch" << std::endl;
+        failures += 1;
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
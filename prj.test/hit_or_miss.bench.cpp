@@ -0,0 +1,339 @@
+#include<hitOrMiss/hit_or_miss.hpp>
+#include<hitOrMiss/set_operations.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Параметры запуска
+struct Options {
+    std::string output = "hit_or_miss.bench.json"; // файл результатов JSON
+    int max_size = 16384; // наибольшая сторона изображения
+    int repeats = 5; // замеров на конфигурацию
+    double budget_seconds = 2.0; // после этого времени замеры конфигурации прекращаются
+    int thread_count = 1; // потоков прохода (HitOrMiss и OpenCV)
+    std::string filter; // только замеры, в имени которых есть эта строка
+};
+
+// Изображение и структурные элементы одного замера
+struct Config {
+    int size = 0; // сторона квадратного изображения
+    std::string kernel; // форма элемента: solid, frame, cross, sparse
+    int kernel_size = 0; // сторона элемента
+    double density = 0; // доля черных пикселей изображения
+};
+
+// Результат одного замера
+struct Result {
+    std::string name;
+    std::string operation;
+    std::string implementation;
+    Config config;
+    int runs = 0;
+    double min_ms = 0;
+    double median_ms = 0;
+};
+
+const int kImageSeed = 20261017;
+const int kKernelSeed = 17;
+
+// Быстрый генератор для изображений 16k*16k
+class XorShift {
+public:
+    explicit XorShift(uint64_t seed) : state_(seed * 0x9E3779B97F4A7C15ull + 1) {}
+
+    uint32_t Next() {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 7;
+        state_ ^= state_ << 17;
+        return static_cast<uint32_t>(state_ >> 32);
+    }
+
+private:
+    uint64_t state_;
+};
+
+// Случайное бинарное изображение с заданной долей черных пикселей
+cv::Mat RandomBinary(int rows, int cols, double density, uint64_t seed) {
+    XorShift random(seed);
+    const uint32_t black_below = static_cast<uint32_t>(std::min(density, 1.0) * 4294967295.0);
+    cv::Mat image{ rows, cols, CV_8UC1 };
+    for (int row = 0; row < rows; row += 1) {
+        uchar* pixels = image.ptr<uchar>(row);
+        for (int col = 0; col < cols; col += 1) {
+            pixels[col] = random.Next() < black_below ? 0 : 255;
+        }
+    }
+    return image;
+}
+
+// Элементы переднего и заднего плана одной формы и размера, как в tests/test_1..9:
+// solid - черный квадрат, frame - черное пятно в белой рамке, cross - черный крест на белом,
+// sparse - случайные черные и белые значимые пиксели
+void MakeKernels(const std::string& shape, int size, cv::Mat& foreground, cv::Mat& background) {
+    foreground = cv::Mat{ size, size, CV_8UC1, cv::Scalar(255) };
+    background = cv::Mat{ size, size, CV_8UC1, cv::Scalar(0) };
+    const int center = size / 2;
+    XorShift random(kKernelSeed + size);
+    for (int row = 0; row < size; row += 1) {
+        for (int col = 0; col < size; col += 1) {
+            const bool edge = row == 0 || col == 0 || row == size - 1 || col == size - 1;
+            bool black = false;
+            bool white = false;
+            if (shape == "solid") {
+                black = true;
+            }
+            else if (shape == "frame") {
+                black = !edge || size < 3;
+                white = !black;
+            }
+            else if (shape == "cross") {
+                black = row == center || col == center;
+                white = !black;
+            }
+            else {
+                black = (row == center && col == center) || random.Next() % 5 == 0;
+                white = !black && random.Next() % 5 == 0;
+            }
+            if (black) foreground.at<uchar>(row, col) = 0;
+            if (white) background.at<uchar>(row, col) = 255;
+        }
+    }
+}
+
+// Тот же элемент для cv::MORPH_HITMISS: 1 - объект (черный), -1 - фон (белый), 0 - не важно
+cv::Mat OpenCvKernel(const cv::Mat& foreground, const cv::Mat& background) {
+    cv::Mat kernel{ foreground.rows, foreground.cols, CV_32SC1, cv::Scalar(0) };
+    for (int row = 0; row < kernel.rows; row += 1) {
+        for (int col = 0; col < kernel.cols; col += 1) {
+            if (foreground.at<uchar>(row, col) == 0) {
+                kernel.at<int>(row, col) = 1;
+            }
+            else if (background.at<uchar>(row, col) != 0) {
+                kernel.at<int>(row, col) = -1;
+            }
+        }
+    }
+    return kernel;
+}
+
+std::string ConfigName(const Config& config) {
+    std::ostringstream name;
+    name << config.size << "x" << config.size << "/";
+    if (!config.kernel.empty()) {
+        name << config.kernel << config.kernel_size << "/";
+    }
+    name << "d" << config.density;
+    return name.str();
+}
+
+// Время выполнения run: один прогрев, затем до options.repeats замеров, но не дольше бюджета
+Result Measure(const Options& options, const std::function<void()>& run) {
+    using Clock = std::chrono::steady_clock;
+    run();
+
+    std::vector<double> times;
+    const Clock::time_point begin = Clock::now();
+    while (static_cast<int>(times.size()) < options.repeats) {
+        const Clock::time_point start = Clock::now();
+        run();
+        const Clock::time_point stop = Clock::now();
+        times.push_back(std::chrono::duration<double, std::milli>(stop - start).count());
+        if (std::chrono::duration<double>(stop - begin).count() > options.budget_seconds) {
+            break;
+        }
+    }
+
+    std::sort(times.begin(), times.end());
+    Result result;
+    result.runs = static_cast<int>(times.size());
+    result.min_ms = times.front();
+    result.median_ms = times[times.size() / 2];
+    return result;
+}
+
+class Bench {
+public:
+    explicit Bench(const Options& options) : options_(options) {}
+
+    // Проход структурными элементами и извлечение границ всеми движками и cv::morphologyEx
+    // (kAuto выбирает движок при прогреве, замеряется уже выбранный)
+    void HitOrMissConfig(const Config& config) {
+        if (config.size > options_.max_size) {
+            return;
+        }
+        const cv::Mat image = RandomBinary(config.size, config.size, config.density, kImageSeed + config.size);
+        cv::Mat foreground;
+        cv::Mat background;
+        MakeKernels(config.kernel, config.kernel_size, foreground, background);
+        const cv::Mat highlight{ 1, 1, CV_8UC1, cv::Scalar(0) };
+
+        const std::pair<const char*, HitOrMiss::Engine> engines[] = { { "bytewise", HitOrMiss::Engine::kBytewise },
+            { "bit_plane", HitOrMiss::Engine::kBitPlane }, { "run_length", HitOrMiss::Engine::kRunLength },
+            { "auto", HitOrMiss::Engine::kAuto } };
+        for (const auto& engine : engines) {
+            HitOrMiss hit_or_miss(image, foreground, background, highlight);
+            hit_or_miss.set_engine(engine.second);
+            hit_or_miss.set_thread_count(options_.thread_count);
+            cv::Mat dst;
+            Add("hit_or_miss", engine.first, config, [&] { hit_or_miss.DoHitOrMiss(dst); });
+            Add("boundary", engine.first, config, [&] { hit_or_miss.DoBoundaryExtraction(dst); });
+        }
+
+        // побайтовый проход с построчным порядком значимых пикселей - база для порядка по изображению
+        HitOrMiss raster(image, foreground, background, highlight);
+        raster.set_engine(HitOrMiss::Engine::kBytewise);
+        raster.set_thread_count(options_.thread_count);
+        raster.set_probe_ordering(false);
+        cv::Mat raster_dst;
+        Add("hit_or_miss", "bytewise_raster", config, [&] { raster.DoHitOrMiss(raster_dst); });
+
+        // OpenCV ищет ненулевые пиксели, поэтому черные пиксели переводятся в 255 заранее
+        cv::Mat inverted;
+        cv::bitwise_not(image, inverted);
+        const cv::Mat kernel = OpenCvKernel(foreground, background);
+        cv::Mat hits;
+        cv::Mat boundary;
+        Add("hit_or_miss", "opencv", config, [&] { cv::morphologyEx(inverted, hits, cv::MORPH_HITMISS, kernel); });
+        Add("boundary", "opencv", config, [&] {
+            cv::morphologyEx(inverted, hits, cv::MORPH_HITMISS, kernel);
+            cv::subtract(inverted, hits, boundary);
+        });
+    }
+
+    // Операции над множествами на всех поддерживаемых наборах инструкций
+    void SetOperationsConfig(const Config& config) {
+        if (config.size > options_.max_size) {
+            return;
+        }
+        const cv::Mat lhs = RandomBinary(config.size, config.size, config.density, kImageSeed + config.size);
+        const cv::Mat rhs = RandomBinary(config.size, config.size, config.density, kImageSeed + config.size + 1);
+        const std::pair<const char*, SetOperations::Isa> isas[] = { { "scalar", SetOperations::Isa::kScalar },
+            { "sse2", SetOperations::Isa::kSse2 }, { "avx2", SetOperations::Isa::kAvx2 },
+            { "avx512", SetOperations::Isa::kAvx512 } };
+        cv::Mat dst;
+        for (const auto& isa : isas) {
+            if (!SetOperations::IsSupported(isa.second)) {
+                continue;
+            }
+            const SetOperations::Isa value = isa.second;
+            Add("and", isa.first, config, [&] { SetOperations::And(lhs, rhs, dst, value); });
+            Add("or", isa.first, config, [&] { SetOperations::Or(lhs, rhs, dst, value); });
+            Add("substraction", isa.first, config, [&] { SetOperations::Substraction(lhs, rhs, dst, value); });
+        }
+    }
+
+    bool Write() const {
+        std::ofstream file(options_.output);
+        if (!file) {
+            std::cerr << "Can not write " << options_.output << std::endl;
+            return false;
+        }
+        file << "{\n"
+            << "  \"opencv_version\": \"" << CV_VERSION << "\",\n"
+            << "  \"threads\": " << options_.thread_count << ",\n"
+            << "  \"repeats\": " << options_.repeats << ",\n"
+            << "  \"results\": [";
+        for (size_t index = 0; index < results_.size(); index += 1) {
+            const Result& result = results_[index];
+            const double pixels = static_cast<double>(result.config.size) * result.config.size;
+            file << (index == 0 ? "\n" : ",\n")
+                << "    {\"name\": \"" << result.name << "\", \"operation\": \"" << result.operation
+                << "\", \"implementation\": \"" << result.implementation
+                << "\", \"rows\": " << result.config.size << ", \"cols\": " << result.config.size
+                << ", \"kernel\": \"" << result.config.kernel << "\", \"kernel_size\": " << result.config.kernel_size
+                << ", \"density\": " << result.config.density << ", \"runs\": " << result.runs
+                << ", \"min_ms\": " << result.min_ms << ", \"median_ms\": " << result.median_ms
+                << ", \"mpixels_per_s\": " << pixels / (result.median_ms * 1000.0) << "}";
+        }
+        file << "\n  ]\n}\n";
+        return static_cast<bool>(file);
+    }
+
+private:
+    void Add(const char* operation, const char* implementation, const Config& config, const std::function<void()>& run) {
+        const std::string name = std::string(operation) + "/" + implementation + "/" + ConfigName(config);
+        // разделы перебора пересекаются, одинаковые замеры выполняются один раз
+        if (name.find(options_.filter) == std::string::npos || !measured_.insert(name).second) {
+            return;
+        }
+        Result result = Measure(options_, run);
+        result.name = name;
+        result.operation = operation;
+        result.implementation = implementation;
+        result.config = config;
+        results_.push_back(result);
+        std::cout << name << ": " << result.median_ms << " ms (" << result.runs << " runs)" << std::endl;
+    }
+
+private:
+    Options options_;
+    std::vector<Result> results_;
+    std::set<std::string> measured_;
+};
+
+void PrintHelp() {
+    std::cout << "Hit or Miss benchmarks\n"
+        << "-O=file   results JSON (default hit_or_miss.bench.json)\n"
+        << "-M=n      largest image side (default 16384)\n"
+        << "-R=n      measurements per benchmark (default 5)\n"
+        << "-T=s      time budget per benchmark in seconds (default 2)\n"
+        << "-J=n      threads (default 1)\n"
+        << "-F=text   run only benchmarks whose name contains text\n"
+        << "-H        this help" << std::endl;
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int index = 1; index < argc; index += 1) {
+        const std::string arg = argv[index];
+        const std::string value = arg.size() > 3 ? arg.substr(3) : std::string();
+        if (arg.rfind("-O=", 0) == 0) options.output = value;
+        else if (arg.rfind("-M=", 0) == 0) options.max_size = std::atoi(value.c_str());
+        else if (arg.rfind("-R=", 0) == 0) options.repeats = std::max(1, std::atoi(value.c_str()));
+        else if (arg.rfind("-T=", 0) == 0) options.budget_seconds = std::atof(value.c_str());
+        else if (arg.rfind("-J=", 0) == 0) options.thread_count = std::max(1, std::atoi(value.c_str()));
+        else if (arg.rfind("-F=", 0) == 0) options.filter = value;
+        else {
+            PrintHelp();
+            return arg == "-H" ? 0 : 1;
+        }
+    }
+    cv::setNumThreads(options.thread_count);
+
+    Bench bench(options);
+
+    // размер изображения: элемент границы 3*3 и крест 5*5
+    for (int size : { 200, 1024, 4096, 16384 }) {
+        bench.HitOrMissConfig({ size, "solid", 3, 0.5 });
+        bench.HitOrMissConfig({ size, "cross", 5, 0.5 });
+        bench.SetOperationsConfig({ size, "", 0, 0.5 });
+    }
+
+    // форма и размер элемента
+    for (const char* shape : { "solid", "frame", "cross", "sparse" }) {
+        for (int kernel_size : { 3, 7, 15 }) {
+            bench.HitOrMissConfig({ 1024, shape, kernel_size, 0.5 });
+        }
+    }
+
+    // доля черных пикселей изображения
+    for (double density : { 0.01, 0.1, 0.9, 0.99 }) {
+        bench.HitOrMissConfig({ 1024, "cross", 5, density });
+        bench.HitOrMissConfig({ 1024, "frame", 7, density });
+    }
+
+    return bench.Write() ? 0 : 1;
+}
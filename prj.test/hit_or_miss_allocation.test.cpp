@@ -0,0 +1,182 @@
+#include<hitOrMiss/hit_or_miss.hpp>
+#include "test_utils.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+
+// Счетчик выделений памяти через глобальный operator new
+long g_allocations = 0;
+
+void* operator new(std::size_t size) {
+    g_allocations += 1;
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+// Почти белая страница со строками "текста" из черных пятен
+cv::Mat RandomPage(std::mt19937& rng, int rows, int cols) {
+    cv::Mat image{ rows, cols, CV_8UC1, cv::Scalar(255) };
+    std::uniform_int_distribution<int> top(0, rows - 20);
+    std::uniform_int_distribution<int> left(0, cols - 60);
+    std::bernoulli_distribution black(0.6);
+    for (int block = 0; block < 6; block += 1) {
+        const int block_top = top(rng);
+        const int block_left = left(rng);
+        for (int row = block_top; row < block_top + 20; row += 1) {
+            for (int col = block_left; col < block_left + 60; col += 1) {
+                if (black(rng)) image.at<uchar>(row, col) = 0;
+            }
+        }
+    }
+    return image;
+}
+
+// Настройка структурных элементов: каждая ведет к своему проходу
+struct Setup {
+    const char* name;
+    cv::Mat foreground;
+    cv::Mat background;
+    cv::Mat highlight;
+};
+
+int main() {
+    std::mt19937 rng(20231017);
+    int failures = 0;
+
+    cv::Mat frame{ 7, 7, CV_8UC1, cv::Scalar(0) };
+    frame(cv::Rect(1, 1, 5, 5)).setTo(cv::Scalar(255));
+    cv::Mat large_frame{ 25, 25, CV_8UC1, cv::Scalar(0) };
+    large_frame(cv::Rect(1, 1, 23, 23)).setTo(cv::Scalar(255));
+    cv::Mat corner{ 3, 3, CV_8UC1, cv::Scalar(255) };
+    corner.at<uchar>(1, 1) = 0;
+    corner.at<uchar>(1, 2) = 0;
+    corner.at<uchar>(2, 1) = 0;
+    cv::Mat corner_background{ 3, 3, CV_8UC1, cv::Scalar(0) };
+    corner_background.at<uchar>(0, 0) = 255;
+    cv::Mat highlight{ 3, 3, CV_8UC1, cv::Scalar(255) };
+    highlight.at<uchar>(1, 1) = 0;
+    highlight.at<uchar>(0, 1) = 0;
+
+    const Setup setups[] = {
+        { "3x3 black", cv::Mat{ 3, 3, CV_8UC1, cv::Scalar(0) }, cv::Mat{ 1, 1, CV_8UC1, cv::Scalar(0) },
+            cv::Mat{ 1, 1, CV_8UC1, cv::Scalar(0) } },
+        { "5x5 black", cv::Mat{ 5, 5, CV_8UC1, cv::Scalar(0) }, cv::Mat{ 1, 1, CV_8UC1, cv::Scalar(0) },
+            cv::Mat{ 1, 1, CV_8UC1, cv::Scalar(0) } },
+        { "7x7 frame", frame, cv::Mat{ 1, 1, CV_8UC1, cv::Scalar(0) }, cv::Mat{ 1, 1, CV_8UC1, cv::Scalar(0) } },
+        { "25x25 frame", large_frame, cv::Mat{ 1, 1, CV_8UC1, cv::Scalar(0) },
+            cv::Mat{ 1, 1, CV_8UC1, cv::Scalar(0) } },
+        { "3x3 corner", corner, corner_background, cv::Mat{ 1, 1, CV_8UC1, cv::Scalar(0) } },
+        { "3x3 corner, highlight", corner, corner_background, highlight },
+    };
+
+    // кадры одного размера, как в видеопотоке
+    const cv::Mat frames[] = { RandomPage(rng, 480, 640), RandomPage(rng, 480, 640), RandomPage(rng, 480, 640) };
+
+    for (const Setup& setup : setups) {
+        for (HitOrMiss::Engine engine : { HitOrMiss::Engine::kBytewise, HitOrMiss::Engine::kBitPlane }) {
+            HitOrMiss hit_or_miss(frames[0], setup.foreground, setup.background, setup.highlight);
+            hit_or_miss.set_engine(engine);
+
+            // первые кадры заполняют внутренний буфер и выходные изображения
+            cv::Mat dst;
+            cv::Mat boundary;
+            for (int index = 0; index < 2; index += 1) {
+                hit_or_miss.set_image(frames[index]);
+                hit_or_miss.DoHitOrMiss(dst);
+                hit_or_miss.DoBoundaryExtraction(boundary);
+            }
+            const uchar* dst_data = dst.data;
+            const uchar* boundary_data = boundary.data;
+
+            // кадр бинаризуется в память, переиспользуемую от кадра к кадру
+            BinaryImage input(frames[0]);
+
+            long allocations = 0;
+            for (int index = 0; index < 6; index += 1) {
+                const long before = g_allocations;
+                input.Assign(frames[index % 3]);
+                hit_or_miss.set_image(input);
+                hit_or_miss.DoHitOrMiss(dst);
+                hit_or_miss.DoBoundaryExtraction(boundary);
+                allocations += g_allocations - before;
+
+                if (!Equal(dst, hit_or_miss.DoHitOrMiss()) || !Equal(boundary, hit_or_miss.DoBoundaryExtraction())) {
+                    std::cout << "Result mismatch: " << setup.name << ", frame " << index << std::endl;
+                    failures += 1;
+                }
+            }
+            if (allocations != 0 || dst.data != dst_data || boundary.data != boundary_data) {
+                std::cout << setup.name << (engine == HitOrMiss::Engine::kBytewise ? ", bytewise: " : ", bit plane: ")
+                    << allocations << " allocations in steady state" << std::endl;
+                failures += 1;
+            }
+        }
+    }
+
+    // копия получает оба структурных элемента, перемещение сохраняет результат
+    HitOrMiss source(frames[0], corner, corner_background, highlight);
+    const cv::Mat expected = source.DoHitOrMiss();
+    HitOrMiss copy(source);
+    if (!Equal(copy.get_kernel_background(), corner_background) || !Equal(copy.get_kernel_foreground(), corner)
+        || !Equal(copy.DoHitOrMiss(), expected)) {
+        std::cout << "Copy constructor mismatch" << std::endl;
+        failures += 1;
+    }
+    HitOrMiss assigned;
+    assigned = source;
+    if (!Equal(assigned.get_kernel_background(), corner_background) || !Equal(assigned.DoHitOrMiss(), expected)) {
+        std::cout << "Copy assignment mismatch" << std::endl;
+        failures += 1;
+    }
+    HitOrMiss moved(std::move(copy));
+    if (!Equal(moved.DoHitOrMiss(), expected)) {
+        std::cout << "Move constructor mismatch" << std::endl;
+        failures += 1;
+    }
+    HitOrMiss move_assigned;
+    move_assigned = std::move(assigned);
+    if (!Equal(move_assigned.DoHitOrMiss(), expected)) {
+        std::cout << "Move assignment mismatch" << std::endl;
+        failures += 1;
+    }
+
+    // выход, разделяющий данные с изображением для обработки, пересоздается
+    cv::Mat aliased = source.get_image();
+    source.DoBoundaryExtraction(aliased);
+    HitOrMiss reference(frames[0], corner, corner_background, highlight);
+    if (!Equal(aliased, reference.DoBoundaryExtraction()) || aliased.data == source.get_image().data) {
+        std::cout << "Aliased output mismatch" << std::endl;
+        failures += 1;
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
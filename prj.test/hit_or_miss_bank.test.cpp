@@ -0,0 +1,133 @@
+#include<hitOrMiss/hit_or_miss.hpp>
+#include<hitOrMiss/hit_or_miss_bank.hpp>
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Элемент 3*3 по строке из 9 символов: 'x' - черный, '.' - белый
+cv::Mat Kernel(const char* pixels) {
+    cv::Mat kernel{ 3, 3, CV_8UC1 };
+    for (int index = 0; index < 9; index += 1) {
+        kernel.at<uchar>(index / 3, index % 3) = pixels[index] == 'x' ? 0 : 255;
+    }
+    return kernel;
+}
+
+// Карты набора совпадают с HitOrMiss по каждой паре, карта номеров - с первой попавшей парой
+int Check(const HitOrMissBank& bank, const std::vector<cv::Mat>& foregrounds,
+    const std::vector<cv::Mat>& backgrounds, const cv::Mat& image, int test) {
+    int failures = 0;
+    const std::vector<cv::Mat> maps = bank.DoHitMaps(image);
+    const cv::Mat labels = bank.DoLabelMap(image);
+    for (int index = 0; index < bank.get_pattern_count(); index += 1) {
+        HitOrMiss hit_or_miss(image, foregrounds[index]);
+        if (!backgrounds[index].empty()) {
+            hit_or_miss.set_kernel_background(backgrounds[index]);
+        }
+        if (!Equal(hit_or_miss.DoHitOrMiss(), maps[index])) {
+            std::cout << "Hit map mismatch, pattern " << index << ", test " << test << std::endl;
+            failures += 1;
+        }
+    }
+    for (int row = 0; row < image.rows; row += 1) {
+        for (int col = 0; col < image.cols; col += 1) {
+            int expected = 0;
+            for (int index = bank.get_pattern_count() - 1; index >= 0; index -= 1) {
+                if (maps[index].at<uchar>(row, col) == 0) expected = index + 1;
+            }
+            if (labels.at<int>(row, col) != expected) {
+                std::cout << "Label mismatch at (" << row << ", " << col << "), test " << test << std::endl;
+                return failures + 1;
+            }
+        }
+    }
+    return failures;
+}
+
+int main() {
+    std::mt19937 rng(20231017);
+    int failures = 0;
+
+    // случайные пары разных размеров, с задним планом и без
+    for (int test = 0; test < 40; test += 1) {
+        std::uniform_int_distribution<int> pattern_count(1, 12);
+        std::uniform_int_distribution<int> kernel_size(1, 9);
+        std::uniform_int_distribution<int> image_size(1, 150);
+
+        HitOrMissBank bank;
+        std::vector<cv::Mat> foregrounds;
+        std::vector<cv::Mat> backgrounds;
+        const int count = pattern_count(rng);
+        for (int index = 0; index < count; index += 1) {
+            const int kernel_rows = kernel_size(rng);
+            const int kernel_cols = kernel_size(rng);
+            foregrounds.push_back(RandomBinary(rng, kernel_rows, kernel_cols, 0.3));
+            backgrounds.push_back(index % 3 == 0 ? cv::Mat() : RandomBinary(rng, kernel_rows, kernel_cols, 0.8));
+            if (bank.AddPattern(foregrounds.back(), backgrounds.back()) != index) {
+                std::cout << "Wrong pattern index, test " << test << std::endl;
+                failures += 1;
+            }
+        }
+        failures += Check(bank, foregrounds, backgrounds, RandomBinary(rng, image_size(rng), image_size(rng), 0.6), test);
+    }
+
+    // набор утончения: 8 поворотов двух элементов 3*3 с общими условиями
+    const char* thinning_foregrounds[] = { "....x.xxx", "...xx.xx.", "x..xx.x..", "xx.xx....",
+        "xxx.x....", ".xx.xx...", "..x.xx..x", "....xx.xx" };
+    const char* thinning_backgrounds[] = { "...xxxxxx", "x..xx.xxx", "xx.xx.xx.", "xxxxx.x..",
+        "xxxxxx...", "xxx.xx..x", ".xx.xx.xx", "..x.xxxxx" };
+    HitOrMissBank thinning;
+    std::vector<cv::Mat> foregrounds;
+    std::vector<cv::Mat> backgrounds;
+    for (int index = 0; index < 8; index += 1) {
+        foregrounds.push_back(Kernel(thinning_foregrounds[index]));
+        backgrounds.push_back(Kernel(thinning_backgrounds[index]));
+        thinning.AddPattern(foregrounds.back(), backgrounds.back());
+    }
+    failures += Check(thinning, foregrounds, backgrounds, RandomBinary(rng, 200, 300, 0.5), 40);
+
+    // один проход набора против 8 отдельных проходов
+    const cv::Mat large = RandomBinary(rng, 1024, 1024, 0.5);
+    double bank_time = 0;
+    double separate_time = 0;
+    for (int run = 0; run < 3; run += 1) {
+        int64 start = cv::getTickCount();
+        thinning.DoHitMaps(large);
+        const double bank_elapsed = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+        start = cv::getTickCount();
+        for (int index = 0; index < 8; index += 1) {
+            HitOrMiss(large, foregrounds[index], backgrounds[index]).DoHitOrMiss();
+        }
+        const double separate_elapsed = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+        bank_time = run == 0 ? bank_elapsed : std::min(bank_time, bank_elapsed);
+        separate_time = run == 0 ? separate_elapsed : std::min(separate_time, separate_elapsed);
+    }
+    std::cout << "8 patterns on 1024*1024: bank " << bank_time << " ms, separate " << separate_time << " ms" << std::endl;
+
+    // неверные аргументы
+    try {
+        HitOrMissBank bank;
+        bank.AddPattern(cv::Mat{ 3, 3, CV_8UC1, cv::Scalar(0) }, cv::Mat{ 2, 2, CV_8UC1, cv::Scalar(0) });
+        std::cout << "Size mismatch accepted" << std::endl;
+        failures += 1;
+    }
+    catch (const std::invalid_argument&) {
+    }
+    try {
+        thinning.DoHitMaps(cv::Mat());
+        std::cout << "Empty image accepted" << std::endl;
+        failures += 1;
+    }
+    catch (const std::invalid_argument&) {
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include<hitOrMiss/hit_or_miss.hpp>
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+int main() {
+    std::mt19937 rng(20231017);
+    int failures = 0;
+
+    // результат для каждого изображения совпадает с обработкой по одному
+    for (int test = 0; test < 40; test += 1) {
+        std::uniform_int_distribution<int> kernel_size(1, 7);
+        const int kernel_rows = kernel_size(rng);
+        const int kernel_cols = kernel_size(rng);
+
+        HitOrMiss hit_or_miss;
+        const cv::Mat foreground = RandomBinary(rng, kernel_rows, kernel_cols, 0.5);
+        hit_or_miss.set_kernel_foreground(foreground);
+        if (test % 3 != 0) {
+            cv::Mat background = RandomBinary(rng, kernel_rows, kernel_cols, 0.7);
+            for (int row = 0; row < kernel_rows; row += 1) {
+                for (int col = 0; col < kernel_cols; col += 1) {
+                    if (foreground.at<uchar>(row, col) == 0) background.at<uchar>(row, col) = 0;
+                }
+            }
+            hit_or_miss.set_kernel_background(background);
+        }
+        if (test % 2 == 0) {
+            hit_or_miss.set_hit_highlight(RandomBinary(rng, kernel_rows, kernel_cols, 0.5));
+        }
+        hit_or_miss.set_thread_count(test % 4 == 0 ? 3 : 1);
+
+        // изображения разного размера, в том числе меньше структурного элемента
+        std::uniform_int_distribution<int> image_size(1, 90);
+        std::vector<cv::Mat> images;
+        for (int index = 0; index < 12; index += 1) {
+            images.push_back(RandomBinary(rng, image_size(rng), image_size(rng), 0.85));
+        }
+        // не только 0 и 255: бинаризация при упаковке
+        images.front().at<uchar>(0, 0) = 100;
+
+        const std::vector<cv::Mat> hits = hit_or_miss.DoHitOrMissBatch(images);
+        const std::vector<cv::Mat> boundaries = hit_or_miss.DoBoundaryExtractionBatch(images);
+        for (size_t index = 0; index < images.size(); index += 1) {
+            hit_or_miss.set_image(images[index]);
+            if (!Equal(hit_or_miss.DoHitOrMiss(), hits[index])) {
+                std::cout << "Hit or Miss mismatch, test " << test << ", image " << index << std::endl;
+                failures += 1;
+            }
+            if (!Equal(hit_or_miss.DoBoundaryExtraction(), boundaries[index])) {
+                std::cout << "Boundary mismatch, test " << test << ", image " << index << std::endl;
+                failures += 1;
+            }
+        }
+    }
+
+    // пропускная способность на вырезках 50*50, как tests/test_6
+    std::vector<cv::Mat> crops;
+    for (int index = 0; index < 2000; index += 1) {
+        crops.push_back(RandomBinary(rng, 50, 50, 0.7));
+    }
+    HitOrMiss crop_matcher(crops.front(), cv::Mat{ 3, 3, CV_8UC1, cv::Scalar(0) });
+
+    // лучшее время из нескольких запусков
+    double loop = 0;
+    double batch = 0;
+    for (int run = 0; run < 3; run += 1) {
+        int64 start = cv::getTickCount();
+        for (const cv::Mat& crop : crops) {
+            crop_matcher.set_image(crop);
+            crop_matcher.DoHitOrMiss();
+        }
+        const double loop_run = (cv::getTickCount() - start) / cv::getTickFrequency();
+
+        start = cv::getTickCount();
+        crop_matcher.DoHitOrMissBatch(crops);
+        const double batch_run = (cv::getTickCount() - start) / cv::getTickFrequency();
+
+        loop = run == 0 ? loop_run : std::min(loop, loop_run);
+        batch = run == 0 ? batch_run : std::min(batch, batch_run);
+    }
+
+    std::cout << "DoHitOrMiss loop: " << crops.size() / loop << " crops/s" << std::endl;
+    std::cout << "DoHitOrMissBatch: " << crops.size() / batch << " crops/s" << std::endl;
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include<hitOrMiss/hit_or_miss.hpp>
+#include "test_utils.hpp"
+
+#include <iostream>
+#include <random>
+#include <thread>
+
+// Время одного вызова DoHitOrMiss в миллисекундах (лучшее из нескольких)
+double Measure(const HitOrMiss& hit_or_miss) {
+    double best = 0;
+    for (int run = 0; run < 3; run += 1) {
+        const int64 start = cv::getTickCount();
+        hit_or_miss.DoHitOrMiss();
+        const double elapsed = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+        best = run == 0 ? elapsed : std::min(best, elapsed);
+    }
+    return best;
+}
+
+int main() {
+    std::mt19937 rng(20231017);
+    int failures = 0;
+
+    // результат не зависит от количества потоков, в том числе при выделении,
+    // пересекающем границы полос
+    for (int test = 0; test < 60; test += 1) {
+        std::uniform_int_distribution<int> image_size(1, 120);
+        std::uniform_int_distribution<int> kernel_size(1, 9);
+        const int kernel_rows = kernel_size(rng);
+        const int kernel_cols = kernel_size(rng);
+
+        HitOrMiss hit_or_miss(RandomBinary(rng, image_size(rng), image_size(rng), 0.85));
+        hit_or_miss.set_kernel_foreground(RandomBinary(rng, kernel_rows, kernel_cols, 0.4));
+        if (test % 2 == 0) {
+            hit_or_miss.set_hit_highlight(RandomBinary(rng, kernel_rows, kernel_cols, 0.5));
+        }
+
+        for (HitOrMiss::Engine engine : { HitOrMiss::Engine::kBytewise, HitOrMiss::Engine::kBitPlane }) {
+            hit_or_miss.set_engine(engine);
+            hit_or_miss.set_thread_count(1);
+            const cv::Mat expected = hit_or_miss.DoBoundaryExtraction();
+
+            for (int thread_count : { 0, 2, 3, 7, 64 }) {
+                hit_or_miss.set_thread_count(thread_count);
+                if (!Equal(expected, hit_or_miss.DoBoundaryExtraction())) {
+                    std::cout << "Mismatch with " << thread_count << " threads, test " << test << std::endl;
+                    failures += 1;
+                }
+            }
+        }
+    }
+
+    // масштабирование по потокам на большом изображении
+    const int max_threads = std::max(1, std::min(32, static_cast<int>(std::thread::hardware_concurrency())));
+    cv::Mat kernel{ 19, 19, CV_8UC1, cv::Scalar(0) };
+    HitOrMiss scaling(RandomBinary(rng, 2048, 2048, 0.97), kernel);
+    for (HitOrMiss::Engine engine : { HitOrMiss::Engine::kBytewise, HitOrMiss::Engine::kBitPlane }) {
+        scaling.set_engine(engine);
+        scaling.set_thread_count(1);
+        const double serial = Measure(scaling);
+        std::cout << (engine == HitOrMiss::Engine::kBytewise ? "bytewise" : "bit plane") << std::endl;
+        for (int thread_count = 1; thread_count <= max_threads; thread_count *= 2) {
+            scaling.set_thread_count(thread_count);
+            const double parallel = Measure(scaling);
+            std::cout << "  threads " << thread_count << ": " << parallel << " ms, speedup "
+                << serial / parallel << std::endl;
+        }
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
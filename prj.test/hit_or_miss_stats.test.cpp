@@ -0,0 +1,155 @@
+#include<hitOrMiss/hit_or_miss.hpp>
+#include "test_utils.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+
+long long BlackPixels(const cv::Mat& image) {
+    return static_cast<long long>(image.total()) - cv::countNonZero(image);
+}
+
+int main() {
+    std::mt19937 rng(20261017);
+    int failures = 0;
+
+    // диагональ и разрозненные пиксели 11*12: ни один быстрый проход их не берет, окна проверяются поштучно
+    const int side = 11;
+    cv::Mat foreground{ side, side + 1, CV_8UC1, cv::Scalar(255) };
+    for (int index = 0; index < side; index += 1) {
+        foreground.at<uchar>(index, index) = 0;
+    }
+    cv::Mat background{ side, side + 1, CV_8UC1, cv::Scalar(0) };
+    background.at<uchar>(0, side) = 255;
+    background.at<uchar>(side - 1, 0) = 255;
+    background.at<uchar>(2, 7) = 255;
+    const cv::Mat image = RandomBinary(rng, 96, 128, 0.5);
+    const long long windows = static_cast<long long>(image.rows - side + 1) * (image.cols - side);
+
+    HitOrMiss hit_or_miss(image.clone());
+    hit_or_miss.set_kernel_foreground(foreground);
+    hit_or_miss.set_kernel_background(background);
+    hit_or_miss.set_engine(HitOrMiss::Engine::kBytewise);
+    hit_or_miss.set_thread_count(1);
+
+    // без статистики проходы ничего не записывают
+    if (hit_or_miss.get_stats() != nullptr) {
+        std::cout << "Stats are collected without set_stats" << std::endl;
+        failures += 1;
+    }
+
+    auto stats = std::make_shared<HitOrMissStats>();
+    hit_or_miss.set_stats(stats);
+    hit_or_miss.set_image(image.clone());
+    const cv::Mat result = hit_or_miss.DoHitOrMiss();
+    HitOrMissStats::Counters counters = stats->get_counters();
+
+    if (!HitOrMissStats::kEnabled) {
+        // без HITORMISS_STATS статистика остается пустой
+        if (counters.windows_tested != 0 || counters.pixels_compared != 0 || counters.hits != 0
+            || counters.bytes_allocated != 0 || !stats->get_stages().empty() || !stats->get_spans().empty()) {
+            std::cout << "Stats are collected without HITORMISS_STATS" << std::endl;
+            failures += 1;
+        }
+    }
+    else {
+        if (counters.windows_tested != windows) {
+            std::cout << "windows_tested " << counters.windows_tested << " instead of " << windows << std::endl;
+            failures += 1;
+        }
+        // отвергнутое окно сравнивает не больше значимых пикселей, совпавшее - все
+        long long rejected = 0;
+        for (long long depth : counters.exit_depth) {
+            rejected += depth;
+        }
+        const long long hits = BlackPixels(result);
+        if (counters.hits != hits || rejected != windows - hits) {
+            std::cout << "Hits " << counters.hits << ", rejected " << rejected << " for " << hits << " hits" << std::endl;
+            failures += 1;
+        }
+        if (counters.pixels_compared < windows || counters.pixels_compared > windows * (side + 3)
+            || counters.exit_depth[0] != 0) {
+            std::cout << "pixels_compared " << counters.pixels_compared << " out of range" << std::endl;
+            failures += 1;
+        }
+        if (counters.bytes_allocated <= 0) {
+            std::cout << "Result allocation is not counted" << std::endl;
+            failures += 1;
+        }
+        const std::map<std::string, HitOrMissStats::Stage> stages = stats->get_stages();
+        for (const char* name : { "set_image", "TypeCheck", "DoHitOrMiss", "FusedMaskMatching" }) {
+            if (stages.count(name) == 0 || stages.at(name).calls != 1) {
+                std::cout << "Stage " << name << " is not recorded once" << std::endl;
+                failures += 1;
+            }
+        }
+
+        // повторный проход в тот же буфер ничего не выделяет
+        cv::Mat dst;
+        hit_or_miss.DoHitOrMiss(dst);
+        stats->Reset();
+        hit_or_miss.DoHitOrMiss(dst);
+        counters = stats->get_counters();
+        if (counters.bytes_allocated != 0 || counters.windows_tested != windows) {
+            std::cout << "Repeated pass allocated " << counters.bytes_allocated << " bytes" << std::endl;
+            failures += 1;
+        }
+
+        // полосы нескольких потоков складываются в те же счетчики и дают интервалы разных потоков
+        stats->Reset();
+        hit_or_miss.set_thread_count(3);
+        hit_or_miss.DoHitOrMiss(dst);
+        counters = stats->get_counters();
+        std::set<int> threads;
+        for (const HitOrMissStats::Span& span : stats->get_spans()) {
+            if (std::string(span.name) == "ParallelBands") {
+                threads.insert(span.thread);
+            }
+        }
+        if (counters.windows_tested != windows || counters.hits != hits || threads.size() < 2) {
+            std::cout << "Parallel bands: " << counters.windows_tested << " windows, "
+                << threads.size() << " threads" << std::endl;
+            failures += 1;
+        }
+
+        // трассировка
+        const std::string trace = stats->ChromeTrace();
+        if (trace.find("\"traceEvents\"") == std::string::npos || trace.find("\"ParallelBands\"") == std::string::npos) {
+            std::cout << "Chrome trace has no events" << std::endl;
+            failures += 1;
+        }
+        const std::string path = "hit_or_miss_stats.test.json";
+        if (!stats->WriteChromeTrace(path)) {
+            std::cout << "Chrome trace is not written" << std::endl;
+            failures += 1;
+        }
+        std::ifstream written(path);
+        const std::string content((std::istreambuf_iterator<char>(written)), std::istreambuf_iterator<char>());
+        if (content != trace) {
+            std::cout << "Written trace differs" << std::endl;
+            failures += 1;
+        }
+        written.close();
+        std::remove(path.c_str());
+    }
+
+    // сбор статистики не меняет результат
+    HitOrMiss plain(image.clone());
+    plain.set_kernel_foreground(foreground);
+    plain.set_kernel_background(background);
+    plain.set_engine(HitOrMiss::Engine::kBytewise);
+    if (!Equal(plain.DoHitOrMiss(), result)) {
+        std::cout << "Stats change the result" << std::endl;
+        failures += 1;
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include<hitOrMiss/hit_or_miss_stream.hpp>
+#include "test_utils.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+int main() {
+    std::mt19937 rng(20231017);
+    int failures = 0;
+
+    for (int test = 0; test < 80; test += 1) {
+        std::uniform_int_distribution<int> image_size(1, 100);
+        std::uniform_int_distribution<int> kernel_size(1, 9);
+        const int kernel_rows = kernel_size(rng);
+        const int kernel_cols = kernel_size(rng);
+
+        HitOrMiss settings;
+        const cv::Mat foreground = RandomBinary(rng, kernel_rows, kernel_cols, 0.4);
+        settings.set_kernel_foreground(foreground);
+        if (test % 3 != 0) {
+            cv::Mat background = RandomBinary(rng, kernel_rows, kernel_cols, 0.7);
+            for (int row = 0; row < kernel_rows; row += 1) {
+                for (int col = 0; col < kernel_cols; col += 1) {
+                    if (foreground.at<uchar>(row, col) == 0) background.at<uchar>(row, col) = 0;
+                }
+            }
+            settings.set_kernel_background(background);
+        }
+        if (test % 2 == 0) {
+            settings.set_hit_highlight(RandomBinary(rng, kernel_rows, kernel_cols, 0.5));
+        }
+
+        const HitOrMissStream::Output output = test % 4 < 2
+            ? HitOrMissStream::Output::kHitOrMiss : HitOrMissStream::Output::kBoundary;
+        const int cols = image_size(rng);
+        int pushed = 0;
+        int expected_row = 0;
+        std::vector<cv::Mat> streamed;
+        HitOrMissStream stream(cols, settings, output, [&](int row, const cv::Mat& pixels) {
+            // строки выдаются по порядку и не позже, чем через kernel.rows - 1 переданных строк
+            if (row != expected_row || pushed - 1 - row > kernel_rows - 1) {
+                std::cout << "Row " << row << " emitted out of order or late, test " << test << std::endl;
+                failures += 1;
+            }
+            expected_row += 1;
+            streamed.push_back(pixels.clone());
+        });
+
+        // одним потоком подряд обрабатываются два изображения
+        for (int image_index = 0; image_index < 2; image_index += 1) {
+            const cv::Mat image = RandomBinary(rng, image_size(rng), cols, 0.8);
+            streamed.clear();
+            expected_row = 0;
+            for (pushed = 1; pushed <= image.rows; pushed += 1) {
+                stream.PushRow(image.row(pushed - 1));
+            }
+            pushed = image.rows;
+            stream.Finish();
+
+            settings.set_image(image);
+            const cv::Mat expected = output == HitOrMissStream::Output::kHitOrMiss
+                ? settings.DoHitOrMiss() : settings.DoBoundaryExtraction();
+            bool equal = static_cast<int>(streamed.size()) == expected.rows;
+            for (int row = 0; equal && row < expected.rows; row += 1) {
+                equal = std::memcmp(streamed[row].ptr<uchar>(0), expected.ptr<uchar>(row), expected.cols) == 0;
+            }
+            if (!equal) {
+                std::cout << "Mismatch, test " << test << ", image " << image_index << std::endl;
+                failures += 1;
+            }
+        }
+    }
+
+    // строка другого размера отвергается
+    HitOrMissStream stream(10, HitOrMiss(), HitOrMissStream::Output::kHitOrMiss, [](int, const cv::Mat&) {});
+    try {
+        stream.PushRow(cv::Mat{ 1, 11, CV_8UC1, cv::Scalar(0) });
+        std::cout << "A row of wrong width was accepted" << std::endl;
+        failures += 1;
+    }
+    catch (const std::invalid_argument&) {
+    }
+
+    // режимы границы, отличные от kNone, отвергаются, а не заменяются на kNone
+    for (HitOrMiss::BorderMode border_mode : { HitOrMiss::BorderMode::kWhite,
+        HitOrMiss::BorderMode::kBlack, HitOrMiss::BorderMode::kReplicate }) {
+        HitOrMiss bordered;
+        bordered.set_border_mode(border_mode);
+        try {
+            HitOrMissStream rejected(10, bordered, HitOrMissStream::Output::kHitOrMiss, [](int, const cv::Mat&) {});
+            std::cout << "A stream accepted a border mode other than kNone" << std::endl;
+            failures += 1;
+        }
+        catch (const std::invalid_argument&) {
+        }
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
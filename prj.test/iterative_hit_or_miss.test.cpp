@@ -0,0 +1,185 @@
+#include<hitOrMiss/hit_or_miss.hpp>
+#include<hitOrMiss/iterative_hit_or_miss.hpp>
+#include "test_utils.hpp"
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Итерации циклом вызовов HitOrMiss по всему изображению
+cv::Mat Reference(cv::Mat image, const std::vector<cv::Mat>& foregrounds, const std::vector<cv::Mat>& backgrounds,
+    bool thinning, int max_iterations, int& iterations) {
+    const uchar target = thinning ? 255 : 0;
+    iterations = 0;
+    while (max_iterations <= 0 || iterations < max_iterations) {
+        iterations += 1;
+        bool changed = false;
+        for (size_t index = 0; index < foregrounds.size(); index += 1) {
+            HitOrMiss hit_or_miss(image, foregrounds[index]);
+            if (!backgrounds[index].empty()) {
+                hit_or_miss.set_kernel_background(backgrounds[index]);
+            }
+            const cv::Mat hits = hit_or_miss.DoHitOrMiss();
+            for (int row = 0; row < image.rows; row += 1) {
+                for (int col = 0; col < image.cols; col += 1) {
+                    if (hits.at<uchar>(row, col) == 0 && image.at<uchar>(row, col) != target) {
+                        image.at<uchar>(row, col) = target;
+                        changed = true;
+                    }
+                }
+            }
+        }
+        if (!changed) {
+            break;
+        }
+    }
+    return image;
+}
+
+// Толстые отрезки на белом фоне
+cv::Mat Strokes(std::mt19937& rng, int rows, int cols, int count) {
+    cv::Mat image{ rows, cols, CV_8UC1, cv::Scalar(255) };
+    std::uniform_int_distribution<int> row_position(0, rows - 1);
+    std::uniform_int_distribution<int> col_position(0, cols - 1);
+    for (int stroke = 0; stroke < count; stroke += 1) {
+        const int row = row_position(rng);
+        const int col = col_position(rng);
+        const bool horizontal = stroke % 2 == 0;
+        for (int along = 0; along < (horizontal ? cols : rows) / 2; along += 1) {
+            for (int across = 0; across < 7; across += 1) {
+                const int y = horizontal ? row + across : row + along;
+                const int x = horizontal ? col + along : col + across;
+                if (y < rows && x < cols) image.at<uchar>(y, x) = 0;
+            }
+        }
+    }
+    return image;
+}
+
+int main() {
+    std::mt19937 rng(20231017);
+    int failures = 0;
+
+    // случайные наборы совпадают с циклом вызовов HitOrMiss, в том числе по числу итераций
+    for (int test = 0; test < 60; test += 1) {
+        std::uniform_int_distribution<int> pattern_count(1, 4);
+        std::uniform_int_distribution<int> kernel_size(1, 5);
+        std::uniform_int_distribution<int> image_size(1, 40);
+        const bool thinning = test % 2 == 0;
+
+        IterativeHitOrMiss iterative(thinning ? IterativeHitOrMiss::Operation::kThinning
+            : IterativeHitOrMiss::Operation::kThickening);
+        std::vector<cv::Mat> foregrounds;
+        std::vector<cv::Mat> backgrounds;
+        const int count = pattern_count(rng);
+        for (int index = 0; index < count; index += 1) {
+            const int kernel_rows = kernel_size(rng);
+            const int kernel_cols = kernel_size(rng);
+            foregrounds.push_back(RandomBinary(rng, kernel_rows, kernel_cols, 0.3));
+            backgrounds.push_back(index % 2 == 0 ? cv::Mat() : RandomBinary(rng, kernel_rows, kernel_cols, 0.8));
+            iterative.AddPattern(foregrounds.back(), backgrounds.back());
+        }
+
+        const cv::Mat image = RandomBinary(rng, image_size(rng), image_size(rng), thinning ? 0.7 : 0.3);
+        for (int max_iterations : { 1, 3, 0 }) {
+            int expected_iterations = 0;
+            const cv::Mat expected = Reference(image.clone(), foregrounds, backgrounds, thinning,
+                max_iterations, expected_iterations);
+            if (!Equal(expected, iterative.Run(image, max_iterations))) {
+                std::cout << "Result mismatch, max iterations " << max_iterations << ", test " << test << std::endl;
+                failures += 1;
+            }
+            if (iterative.get_iterations() != expected_iterations) {
+                std::cout << "Iteration count mismatch, max iterations " << max_iterations << ", test " << test << std::endl;
+                failures += 1;
+            }
+        }
+    }
+
+    // готовые наборы совпадают с циклом вызовов HitOrMiss
+    for (int test = 0; test < 3; test += 1) {
+        IterativeHitOrMiss sets[] = { IterativeHitOrMiss::Thinning(), IterativeHitOrMiss::Thickening(),
+            IterativeHitOrMiss::EndPoints() };
+        IterativeHitOrMiss& iterative = sets[test];
+        std::vector<cv::Mat> foregrounds;
+        std::vector<cv::Mat> backgrounds;
+        for (int index = 0; index < iterative.get_bank().get_pattern_count(); index += 1) {
+            // пара восстанавливается из значимых пикселей общего окна 3*3
+            cv::Mat foreground{ 3, 3, CV_8UC1, cv::Scalar(255) };
+            cv::Mat background{ 3, 3, CV_8UC1, cv::Scalar(0) };
+            for (const CarePixel& pixel : iterative.get_bank().get_pattern(index).element.get_care()) {
+                if (pixel.black) foreground.at<uchar>(pixel.row, pixel.col) = 0;
+                else background.at<uchar>(pixel.row, pixel.col) = 255;
+            }
+            foregrounds.push_back(foreground);
+            backgrounds.push_back(background);
+        }
+        const cv::Mat image = Strokes(rng, 60, 80, 6);
+        int expected_iterations = 0;
+        const cv::Mat expected = Reference(image.clone(), foregrounds, backgrounds,
+            iterative.get_operation() == IterativeHitOrMiss::Operation::kThinning, test == 1 ? 4 : 0, expected_iterations);
+        if (!Equal(expected, iterative.Run(image, test == 1 ? 4 : 0))) {
+            std::cout << "Built-in set mismatch, set " << test << std::endl;
+            failures += 1;
+        }
+    }
+
+    // остов не меняется при повторном утончении
+    const cv::Mat strokes = Strokes(rng, 200, 300, 10);
+    const cv::Mat skeleton = IterativeHitOrMiss::Skeleton(strokes);
+    IterativeHitOrMiss thinning = IterativeHitOrMiss::Thinning();
+    if (!Equal(skeleton, thinning.Run(skeleton)) || thinning.get_iterations() != 1) {
+        std::cout << "Skeleton is not stable under thinning" << std::endl;
+        failures += 1;
+    }
+
+    // отсечение: ветвь длины 2 удаляется, концы основной линии восстанавливаются
+    cv::Mat line{ 20, 50, CV_8UC1, cv::Scalar(255) };
+    for (int col = 5; col < 45; col += 1) {
+        line.at<uchar>(10, col) = 0;
+    }
+    cv::Mat spur = line.clone();
+    spur.at<uchar>(9, 20) = 0;
+    spur.at<uchar>(8, 20) = 0;
+    if (!Equal(line, IterativeHitOrMiss::Prune(spur, 3))) {
+        std::cout << "Pruning mismatch" << std::endl;
+        failures += 1;
+    }
+
+    // стоимость итерации по фронту: проверенных окон намного меньше, чем при полных проходах
+    const cv::Mat large = Strokes(rng, 1000, 1000, 40);
+    int64 start = cv::getTickCount();
+    thinning.Run(large);
+    const double frontier_time = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+    const double full_sweeps = static_cast<double>(thinning.get_iterations()) * 8 * 998 * 998;
+    std::cout << "thinning 1000*1000: " << thinning.get_iterations() << " iterations, "
+        << thinning.get_evaluations() << " windows checked (" << 100.0 * thinning.get_evaluations() / full_sweeps
+        << "% of full sweeps), " << frontier_time << " ms" << std::endl;
+    if (thinning.get_evaluations() >= full_sweeps / 4) {
+        std::cout << "Frontier does not shrink the work" << std::endl;
+        failures += 1;
+    }
+
+    // неверные аргументы
+    try {
+        thinning.Run(cv::Mat());
+        std::cout << "Empty image accepted" << std::endl;
+        failures += 1;
+    }
+    catch (const std::invalid_argument&) {
+    }
+    try {
+        IterativeHitOrMiss::Prune(line, -1);
+        std::cout << "Negative length accepted" << std::endl;
+        failures += 1;
+    }
+    catch (const std::invalid_argument&) {
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include<hitOrMiss/hit_or_miss.hpp>
+#include<hitOrMiss/neighborhood_table.hpp>
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+// Крест 3*3: таблица строится при компиляции
+constexpr const char* kCross[] = { "x1x111x1x" };
+constexpr NeighborhoodTable kCrossTable = NeighborhoodTable::FromPatterns(kCross);
+// биты (row, col) креста в коде: col * 3 + row
+static_assert(kCrossTable.Lookup((1 << 3) | (1 << 1) | (1 << 4) | (1 << 7) | (1 << 5)) == 1);
+static_assert(kCrossTable.Lookup(511) == 1);
+static_assert(kCrossTable.Lookup(0) == 0);
+
+// Случайное изображение с произвольными значениями пикселей
+cv::Mat RandomImage(std::mt19937& rng, int rows, int cols) {
+    std::uniform_int_distribution<int> value(0, 255);
+    cv::Mat image{ rows, cols, CV_8UC1 };
+    for (int row = 0; row < rows; row += 1) {
+        for (int col = 0; col < cols; col += 1) {
+            image.at<uchar>(row, col) = value(rng);
+        }
+    }
+    return image;
+}
+
+int main() {
+    std::mt19937 rng(20231017);
+    int failures = 0;
+
+    // таблица элемента совпадает с проверкой значимых пикселей на бинаризованном изображении
+    for (int test = 0; test < 200; test += 1) {
+        std::uniform_int_distribution<int> kernel_size(1, 3);
+        std::uniform_int_distribution<int> image_size(1, 40);
+        const cv::Size size(kernel_size(rng), kernel_size(rng));
+        const StructuringElement element = StructuringElement::Combine(
+            StructuringElement(RandomBinary(rng, size.height, size.width, 0.4), true), cv::Point(),
+            StructuringElement(RandomBinary(rng, size.height, size.width, 0.6), false), cv::Point(), size);
+
+        const cv::Mat image = RandomImage(rng, image_size(rng), image_size(rng));
+        cv::Mat binary;
+        cv::threshold(image, binary, 127, 255, cv::THRESH_BINARY);
+        if (image.rows < size.height || image.cols < size.width) {
+            continue;
+        }
+
+        const NeighborhoodTable table(element);
+        cv::Mat hits{ image.rows - size.height + 1, image.cols - size.width + 1, CV_8UC1, cv::Scalar(2) };
+        table.Match(image, 0, hits.rows, hits);
+        for (int row = 0; row < hits.rows; row += 1) {
+            for (int col = 0; col < hits.cols; col += 1) {
+                if (hits.at<uchar>(row, col) != (element.Match(binary, row, col) ? 1 : 0)) {
+                    std::cout << "Table mismatch at (" << row << ", " << col << "), test " << test << std::endl;
+                    failures += 1;
+                    row = hits.rows;
+                    break;
+                }
+            }
+        }
+    }
+
+    // слитая таблица: бит пары в маске совпадает с таблицей этой пары
+    const char* patterns[] = { "000x1x111", "x0011011x", "1x01101x0", "11x110x00", "1x0x1x0x1" };
+    NeighborhoodTable merged;
+    for (const char* pixels : patterns) {
+        merged.AddPattern(pixels);
+    }
+    for (int index = 0; index < 5; index += 1) {
+        NeighborhoodTable single;
+        single.AddPattern(patterns[index]);
+        for (int code = 0; code < 512; code += 1) {
+            if (((merged.Lookup(code) >> index) & 1) != single.Lookup(code)) {
+                std::cout << "Merged table mismatch, pattern " << index << ", code " << code << std::endl;
+                failures += 1;
+                break;
+            }
+        }
+    }
+
+    // элемент другого размера в таблицу не добавляется
+    try {
+        NeighborhoodTable table(StructuringElement(cv::Mat{ 2, 2, CV_8UC1, cv::Scalar(0) }, true));
+        table.AddPattern(StructuringElement(cv::Mat{ 3, 3, CV_8UC1, cv::Scalar(0) }, true));
+        std::cout << "Size mismatch accepted" << std::endl;
+        failures += 1;
+    }
+    catch (const std::invalid_argument&) {
+    }
+
+    // элемент 3*3 по умолчанию в побайтовом движке проходится по таблице
+    HitOrMiss hit_or_miss(RandomBinary(rng, 2048, 2048, 0.7));
+    for (HitOrMiss::Engine engine : { HitOrMiss::Engine::kBytewise, HitOrMiss::Engine::kBitPlane }) {
+        hit_or_miss.set_engine(engine);
+        double best = 0;
+        for (int run = 0; run < 3; run += 1) {
+            const int64 start = cv::getTickCount();
+            hit_or_miss.DoHitOrMiss();
+            const double elapsed = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+            best = run == 0 ? elapsed : std::min(best, elapsed);
+        }
+        std::cout << (engine == HitOrMiss::Engine::kBytewise ? "bytewise" : "bit plane")
+            << " 3*3 on 2048*2048: " << best << " ms" << std::endl;
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include<hitOrMiss/hit_or_miss.hpp>
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <tuple>
+
+// Значимые пиксели без учета порядка
+std::vector<std::tuple<int, int, bool>> CareSet(const StructuringElement& element) {
+    std::vector<std::tuple<int, int, bool>> care;
+    for (const CarePixel& pixel : element.get_care()) {
+        care.emplace_back(pixel.row, pixel.col, pixel.black);
+    }
+    std::sort(care.begin(), care.end());
+    return care;
+}
+
+// Сравнений пикселей до первого несовпадения, в сумме по всем окнам изображения
+long long Probes(const StructuringElement& element, const cv::Mat& image) {
+    long long probes = 0;
+    for (int mask_row = 0; mask_row + element.get_size().height <= image.rows; mask_row += 1) {
+        for (int mask_col = 0; mask_col + element.get_size().width <= image.cols; mask_col += 1) {
+            for (const CarePixel& pixel : element.get_care()) {
+                probes += 1;
+                if ((image.at<uchar>(mask_row + pixel.row, mask_col + pixel.col) == 0) != pixel.black) break;
+            }
+        }
+    }
+    return probes;
+}
+
+int main() {
+    std::mt19937 rng(20261017);
+    int failures = 0;
+
+    if (!HitOrMiss().get_probe_ordering()) {
+        std::cout << "Probe ordering is off by default" << std::endl;
+        failures += 1;
+    }
+
+    // в белом изображении черные строки отвергают все окна, и первой проверяется строка из одного
+    // пикселя; строки не дробятся, а передний план объединенного элемента остается первым
+    cv::Mat foreground{ 5, 5, CV_8UC1, cv::Scalar(255) };
+    foreground.at<uchar>(0, 0) = 0;
+    foreground.at<uchar>(0, 1) = 0;
+    foreground.at<uchar>(2, 2) = 0;
+    cv::Mat background{ 5, 5, CV_8UC1, cv::Scalar(0) };
+    background.at<uchar>(4, 4) = 255;
+    const StructuringElement raster = StructuringElement::Combine(StructuringElement(foreground, true), cv::Point(0, 0),
+        StructuringElement(background, false), cv::Point(0, 0), cv::Size(5, 5));
+    StructuringElement ordered = raster;
+    ordered.OrderProbes(cv::Mat{ 96, 96, CV_8UC1, cv::Scalar(255) });
+    const std::vector<CarePixel>& care = ordered.get_care();
+    if (care.size() != 4 || care[0].row != 2 || care[1].row != 0 || care[2].row != 0 || care[3].black
+        || ordered.get_rows().size() != 3 || CareSet(ordered) != CareSet(raster)) {
+        std::cout << "Rows are not ordered by rejected windows per probe" << std::endl;
+        failures += 1;
+    }
+
+    // в черном изображении не совпадает только задний план, но передний план проверяется первым
+    StructuringElement black_ordered = raster;
+    black_ordered.OrderProbes(cv::Mat{ 96, 96, CV_8UC1, cv::Scalar(0) });
+    if (!black_ordered.get_care().front().black || black_ordered.get_care().back().black) {
+        std::cout << "Foreground pixels of the fused element are not probed first" << std::endl;
+        failures += 1;
+    }
+
+    // на маленьком изображении выборка не окупается, и порядок не меняется
+    StructuringElement small = raster;
+    small.OrderProbes(cv::Mat{ 12, 12, CV_8UC1, cv::Scalar(0) });
+    if (small.get_care().front().row != 0 || small.get_care().front().col != 0) {
+        std::cout << "Probes are reordered for a small image" << std::endl;
+        failures += 1;
+    }
+
+    // в изображении с редкими черными строками окна отвергаются быстрее, если первыми
+    // проверяются строки элемента, чаще всего попадающие на белые строки изображения
+    for (int test = 0; test < 8; test += 1) {
+        cv::Mat image = RandomBinary(rng, 160, 160, 0.85);
+        for (int row = test % 3; row < image.rows; row += 3) {
+            image.row(row).setTo(cv::Scalar(255));
+        }
+        const cv::Mat kernel = RandomBinary(rng, 7, 7, 0.6);
+        const StructuringElement element(kernel, true);
+        StructuringElement element_ordered = element;
+        element_ordered.OrderProbes(image);
+        const long long probes = Probes(element, image);
+        const long long probes_ordered = Probes(element_ordered, image);
+        std::vector<int> rows;
+        for (const CarePixel& pixel : element.get_care()) {
+            rows.push_back(pixel.row);
+        }
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+        if (CareSet(element_ordered) != CareSet(element) || probes_ordered > probes
+            || element_ordered.get_rows().size() != rows.size()) {
+            std::cout << "Ordered probes " << probes_ordered << " instead of at most " << probes << std::endl;
+            failures += 1;
+        }
+    }
+
+    // выборка повторяется только после заметного изменения изображения: в белом изображении задний
+    // план не отвергает окон и порядок исходный, в черном первой проверяется строка из одного пикселя;
+    // по изображению с 2% черных пикселей выборка тоже поставила бы ее первой, но оно близко к белому
+    cv::Mat order_foreground{ 5, 5, CV_8UC1, cv::Scalar(255) };
+    order_foreground.at<uchar>(4, 4) = 0;
+    cv::Mat order_background{ 5, 5, CV_8UC1, cv::Scalar(0) };
+    order_background.at<uchar>(0, 0) = 255;
+    order_background.at<uchar>(0, 1) = 255;
+    order_background.at<uchar>(2, 2) = 255;
+    HitOrMiss resampled(cv::Mat{ 96, 96, CV_8UC1, cv::Scalar(255) }, order_foreground, order_background);
+    const int white_front = resampled.get_compiled_background().get_care().front().row;
+    resampled.set_image(RandomBinary(rng, 96, 96, 0.02));
+    const int similar_front = resampled.get_compiled_background().get_care().front().row;
+    resampled.set_image(cv::Mat{ 96, 96, CV_8UC1, cv::Scalar(0) });
+    const int black_front = resampled.get_compiled_background().get_care().front().row;
+    if (white_front != 0 || similar_front != white_front || black_front != 2) {
+        std::cout << "Probe order after set_image: " << white_front << ", " << similar_front
+            << ", " << black_front << std::endl;
+        failures += 1;
+    }
+    if (HitOrMissStats::kEnabled) {
+        const std::shared_ptr<HitOrMissStats> stats = std::make_shared<HitOrMissStats>();
+        resampled.set_stats(stats);
+        resampled.set_image(RandomBinary(rng, 96, 96, 0.98));
+        const long long similar = stats->get_stages()["OrderProbes"].calls;
+        resampled.set_image(RandomBinary(rng, 96, 96, 0.5));
+        const long long changed = stats->get_stages()["OrderProbes"].calls;
+        if (similar != 0 || changed != 1) {
+            std::cout << "Probe order recomputed " << similar << " and " << changed << " times" << std::endl;
+            failures += 1;
+        }
+    }
+
+    // порядок проверки не меняет результатов ни одного движка
+    const HitOrMiss::Engine engines[] = { HitOrMiss::Engine::kBytewise, HitOrMiss::Engine::kBitPlane,
+        HitOrMiss::Engine::kRunLength, HitOrMiss::Engine::kOpenCv };
+    for (int test = 0; test < 16; test += 1) {
+        std::uniform_int_distribution<int> kernel_size(1, 9);
+        const int kernel_rows = kernel_size(rng);
+        const int kernel_cols = kernel_size(rng);
+        const cv::Mat image = RandomBinary(rng, 120, 150, test % 2 == 0 ? 0.8 : 0.3);
+        const cv::Mat kernel_foreground = RandomBinary(rng, kernel_rows, kernel_cols, 0.5);
+        cv::Mat kernel_background = RandomBinary(rng, kernel_rows, kernel_cols, 0.7);
+        for (int row = 0; row < kernel_rows; row += 1) {
+            for (int col = 0; col < kernel_cols; col += 1) {
+                if (kernel_foreground.at<uchar>(row, col) == 0) kernel_background.at<uchar>(row, col) = 0;
+            }
+        }
+        const cv::Mat highlight = test % 4 == 0 ? RandomBinary(rng, kernel_rows, kernel_cols, 0.3)
+            : cv::Mat{ 1, 1, CV_8UC1, cv::Scalar(0) };
+
+        for (HitOrMiss::Engine engine : engines) {
+            HitOrMiss plain(image.clone(), kernel_foreground.clone(), kernel_background.clone());
+            plain.set_hit_highlight(highlight.clone());
+            plain.set_engine(engine);
+            plain.set_probe_ordering(false);
+            HitOrMiss ordered_hit_or_miss(image.clone(), kernel_foreground.clone(), kernel_background.clone());
+            ordered_hit_or_miss.set_hit_highlight(highlight.clone());
+            ordered_hit_or_miss.set_engine(engine);
+            ordered_hit_or_miss.set_thread_count(test % 3 + 1);
+            ordered_hit_or_miss.set_border_mode(test % 5 == 0 ? HitOrMiss::BorderMode::kReplicate
+                : HitOrMiss::BorderMode::kNone);
+            plain.set_border_mode(ordered_hit_or_miss.get_border_mode());
+            if (!Equal(plain.DoHitOrMiss(), ordered_hit_or_miss.DoHitOrMiss())
+                || !Equal(plain.DoBoundaryExtraction(), ordered_hit_or_miss.DoBoundaryExtraction())) {
+                std::cout << "Probe ordering changes the result: test " << test
+                    << ", engine " << static_cast<int>(engine) << std::endl;
+                failures += 1;
+            }
+        }
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
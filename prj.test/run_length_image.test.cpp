@@ -0,0 +1,149 @@
+#include<hitOrMiss/hit_or_miss.hpp>
+#include<hitOrMiss/run_length_image.hpp>
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Попиксельная операция над черными пикселями двух изображений
+template<class Operation>
+cv::Mat Combine(const cv::Mat& lhs, const cv::Mat& rhs, Operation operation) {
+    cv::Mat result{ lhs.rows, lhs.cols, CV_8UC1 };
+    for (int row = 0; row < lhs.rows; row += 1) {
+        for (int col = 0; col < lhs.cols; col += 1) {
+            const bool black = operation(lhs.at<uchar>(row, col) == 0, rhs.at<uchar>(row, col) == 0);
+            result.at<uchar>(row, col) = black ? 0 : 255;
+        }
+    }
+    return result;
+}
+
+// Карта попаданий по левым верхним углам окон, как ее строит RunLengthImage::Match
+cv::Mat ReferenceMatch(const cv::Mat& image, const StructuringElement& element) {
+    const cv::Size size = element.get_size();
+    if (size.height > image.rows || size.width > image.cols) {
+        return cv::Mat();
+    }
+    cv::Mat hits{ image.rows - size.height + 1, image.cols - size.width + 1, CV_8UC1 };
+    for (int row = 0; row < hits.rows; row += 1) {
+        for (int col = 0; col < hits.cols; col += 1) {
+            hits.at<uchar>(row, col) = element.Match(image, row, col) ? 0 : 255;
+        }
+    }
+    return hits;
+}
+
+// Время одного вызова DoHitOrMiss в миллисекундах (лучшее из нескольких)
+double Measure(const HitOrMiss& hit_or_miss) {
+    double best = 0;
+    for (int run = 0; run < 3; run += 1) {
+        const int64 start = cv::getTickCount();
+        hit_or_miss.DoHitOrMiss();
+        const double elapsed = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+        best = run == 0 ? elapsed : std::min(best, elapsed);
+    }
+    return best;
+}
+
+int main() {
+    std::mt19937 rng(20231017);
+    int failures = 0;
+
+    // упаковка в серии и теоретико-множественные операции
+    for (int test = 0; test < 100; test += 1) {
+        std::uniform_int_distribution<int> size(1, 150);
+        std::uniform_real_distribution<double> ratio(0.0, 1.0);
+        const cv::Mat lhs = RandomBinary(rng, size(rng), size(rng), ratio(rng));
+        const cv::Mat rhs = RandomBinary(rng, lhs.rows, lhs.cols, ratio(rng));
+        const RunLengthImage lhs_runs(lhs);
+        const RunLengthImage rhs_runs(rhs);
+
+        cv::Mat result;
+        lhs_runs.Unpack(result);
+        if (!Equal(lhs, result)) {
+            std::cout << "Unpack mismatch, test " << test << std::endl;
+            failures += 1;
+        }
+        RunLengthImage::And(lhs_runs, rhs_runs).Unpack(result);
+        if (!Equal(Combine(lhs, rhs, [](bool l, bool r) { return l && r; }), result)) {
+            std::cout << "And mismatch, test " << test << std::endl;
+            failures += 1;
+        }
+        RunLengthImage::Or(lhs_runs, rhs_runs).Unpack(result);
+        if (!Equal(Combine(lhs, rhs, [](bool l, bool r) { return l || r; }), result)) {
+            std::cout << "Or mismatch, test " << test << std::endl;
+            failures += 1;
+        }
+        RunLengthImage::Substraction(lhs_runs, rhs_runs).Unpack(result);
+        if (!Equal(Combine(lhs, rhs, [](bool l, bool r) { return l && !r; }), result)) {
+            std::cout << "Substraction mismatch, test " << test << std::endl;
+            failures += 1;
+        }
+    }
+
+    // проход элементом по сериям совпадает с попиксельной проверкой окон
+    for (int test = 0; test < 150; test += 1) {
+        std::uniform_int_distribution<int> image_size(1, 90);
+        std::uniform_int_distribution<int> kernel_size(1, 11);
+        const cv::Mat image = RandomBinary(rng, image_size(rng), image_size(rng), test % 2 == 0 ? 0.1 : 0.8);
+        const StructuringElement element(RandomBinary(rng, kernel_size(rng), kernel_size(rng), 0.5), test % 3 != 0);
+
+        const cv::Mat expected = ReferenceMatch(image, element);
+        cv::Mat result;
+        RunLengthImage::Match(RunLengthImage(image), element).Unpack(result);
+        if (!Equal(expected, result)) {
+            std::cout << "Match mismatch, test " << test << std::endl;
+            failures += 1;
+        }
+    }
+
+    // движок на сериях дает тот же результат, что и движок на битовой плоскости
+    for (int test = 0; test < 100; test += 1) {
+        std::uniform_int_distribution<int> image_size(1, 120);
+        std::uniform_int_distribution<int> kernel_size(1, 9);
+        const int kernel_rows = kernel_size(rng);
+        const int kernel_cols = kernel_size(rng);
+
+        HitOrMiss hit_or_miss(RandomBinary(rng, image_size(rng), image_size(rng), test % 2 == 0 ? 0.05 : 0.85));
+        hit_or_miss.set_kernel_foreground(RandomBinary(rng, kernel_rows, kernel_cols, 0.4));
+        if (test % 3 == 0) {
+            hit_or_miss.set_kernel_background(RandomBinary(rng, kernel_rows, kernel_cols, 0.6));
+        }
+        if (test % 2 == 1) {
+            hit_or_miss.set_hit_highlight(RandomBinary(rng, kernel_rows, kernel_cols, 0.5));
+        }
+
+        hit_or_miss.set_engine(HitOrMiss::Engine::kBitPlane);
+        const cv::Mat expected_hit_or_miss = hit_or_miss.DoHitOrMiss();
+        const cv::Mat expected_boundary = hit_or_miss.DoBoundaryExtraction();
+        hit_or_miss.set_engine(HitOrMiss::Engine::kRunLength);
+        if (!Equal(expected_hit_or_miss, hit_or_miss.DoHitOrMiss())) {
+            std::cout << "HitOrMiss mismatch, test " << test << std::endl;
+            failures += 1;
+        }
+        if (!Equal(expected_boundary, hit_or_miss.DoBoundaryExtraction())) {
+            std::cout << "BoundaryExtraction mismatch, test " << test << std::endl;
+            failures += 1;
+        }
+    }
+
+    // разреженное изображение: почти все пиксели белые
+    cv::Mat kernel{ 9, 9, CV_8UC1, cv::Scalar(0) };
+    HitOrMiss sparse(RandomBinary(rng, 2048, 2048, 0.05), kernel);
+    const char* names[] = { "bytewise", "bit plane", "run length" };
+    const HitOrMiss::Engine engines[] = { HitOrMiss::Engine::kBytewise, HitOrMiss::Engine::kBitPlane,
+        HitOrMiss::Engine::kRunLength };
+    for (int engine = 0; engine < 3; engine += 1) {
+        sparse.set_engine(engines[engine]);
+        std::cout << names[engine] << ": " << Measure(sparse) << " ms" << std::endl;
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
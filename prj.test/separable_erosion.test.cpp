@@ -0,0 +1,100 @@
+#include<hitOrMiss/hit_or_miss.hpp>
+#include<hitOrMiss/separable_erosion.hpp>
+#include "test_utils.hpp"
+
+#include <iostream>
+#include <random>
+
+// Структурный элемент с прямоугольником rect цвета color внутри окна size, остальное - другого цвета
+cv::Mat RectangleKernel(const cv::Size& size, const cv::Rect& rect, int color) {
+    cv::Mat kernel{ size, CV_8UC1, cv::Scalar(255 - color) };
+    kernel(rect).setTo(cv::Scalar(color));
+    return kernel;
+}
+
+int main() {
+    std::mt19937 rng(20231017);
+    int failures = 0;
+
+    // разделимый проход совпадает с проверкой по списку значимых пикселей
+    for (int test = 0; test < 200; test += 1) {
+        std::uniform_int_distribution<int> window_size(1, 24);
+        const cv::Size window(window_size(rng), window_size(rng));
+        std::uniform_int_distribution<int> left(0, window.width - 1);
+        std::uniform_int_distribution<int> top(0, window.height - 1);
+        const int x = left(rng);
+        const int y = top(rng);
+        std::uniform_int_distribution<int> width(1, window.width - x);
+        std::uniform_int_distribution<int> height(1, window.height - y);
+        const cv::Rect rect(x, y, width(rng), height(rng));
+
+        const bool foreground = test % 2 == 0;
+        const StructuringElement element(RectangleKernel(window, rect, foreground ? 0 : 255), foreground);
+        if (!SeparableErosion::Supports(element)) {
+            continue;
+        }
+
+        std::uniform_int_distribution<int> image_size(1, 150);
+        // почти сплошное изображение нужного цвета, чтобы попадания были
+        const cv::Mat image = RandomBinary(rng, image_size(rng), image_size(rng), foreground ? 0.995 : 0.005);
+        const int last_row = image.rows - window.height;
+        const int last_col = image.cols - window.width;
+        if (last_row < 0 || last_col < 0) {
+            continue;
+        }
+
+        cv::Mat expected{ last_row + 1, last_col + 1, CV_8UC1 };
+        for (int row = 0; row <= last_row; row += 1) {
+            for (int col = 0; col <= last_col; col += 1) {
+                expected.at<uchar>(row, col) = element.Match(image, row, col);
+            }
+        }
+
+        // полосы произвольной высоты
+        cv::Mat hits{ expected.size(), CV_8UC1, cv::Scalar(7) };
+        for (int row = 0; row <= last_row; row += 5) {
+            SeparableErosion::Match(image, element, row, row + 5, hits);
+        }
+        if (!Equal(expected, hits)) {
+            std::cout << "Bytewise mismatch, test " << test << std::endl;
+            failures += 1;
+        }
+
+        const BitPlane bits = BitPlane::Pack(image);
+        BitPlane bit_hits(image.rows, image.cols);
+        for (int row = 0; row <= last_row; row += 7) {
+            SeparableErosion::Match(bits, element, cv::Point(0, 0), row, row + 7, bit_hits);
+        }
+        // бит установлен ровно там, где есть попадание
+        bool bits_equal = true;
+        for (int row = 0; row < image.rows; row += 1) {
+            for (int col = 0; col < image.cols; col += 1) {
+                const bool hit = row <= last_row && col <= last_col && expected.at<uchar>(row, col);
+                bits_equal = bits_equal && ((bit_hits.Row(row)[col / 64] >> (col % 64)) & 1) == hit;
+            }
+        }
+        if (!bits_equal) {
+            std::cout << "Bit plane mismatch, test " << test << std::endl;
+            failures += 1;
+        }
+    }
+
+    // большой прямоугольник в окне с белой рамкой заднего плана: движки совпадают
+    HitOrMiss hit_or_miss(RandomBinary(rng, 300, 300, 0.99),
+        RectangleKernel(cv::Size(41, 41), cv::Rect(1, 1, 39, 39), 0),
+        RectangleKernel(cv::Size(41, 41), cv::Rect(1, 1, 39, 39), 0));
+    hit_or_miss.set_engine(HitOrMiss::Engine::kBytewise);
+    const cv::Mat bytewise = hit_or_miss.DoBoundaryExtraction();
+    hit_or_miss.set_engine(HitOrMiss::Engine::kBitPlane);
+    if (!Equal(bytewise, hit_or_miss.DoBoundaryExtraction())) {
+        std::cout << "Engines mismatch on a large rectangle" << std::endl;
+        failures += 1;
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include<hitOrMiss/set_operations.hpp>
+#include "test_utils.hpp"
+
+#include <iostream>
+#include <random>
+
+const int kWhite = 255; // код белого пикселя
+const int kBlack = 0; // код черного пикселя
+
+// Скалярные операции в том виде, в каком они были в HitOrMiss до векторизации
+
+cv::Mat AndOperation(const cv::Mat& lhs, const cv::Mat& rhs) {
+    cv::Mat result{ lhs.rows,lhs.cols, CV_8UC1, cv::Scalar(kWhite) };
+    for (int lhs_row = kBlack; lhs_row < lhs.rows; lhs_row += 1) {
+        for (int lhs_col = kBlack; lhs_col < lhs.cols; lhs_col += 1) {
+            if (lhs.at<uchar>(lhs_row, lhs_col) == kBlack && rhs.at<uchar>(lhs_row, lhs_col) == kBlack) {
+                result.at<uchar>(lhs_row, lhs_col) = kBlack;
+            }
+            else {
+                result.at<uchar>(lhs_row, lhs_col) = kWhite;
+            }
+        }
+    }
+    return result;
+}
+
+cv::Mat OrOperation(const cv::Mat& lhs, const cv::Mat& rhs) {
+    cv::Mat result{ lhs.rows,lhs.cols, CV_8UC1, cv::Scalar(kWhite) };
+    for (int lhs_row = kBlack; lhs_row < lhs.rows; lhs_row += 1) {
+        for (int lhs_col = kBlack; lhs_col < lhs.cols; lhs_col += 1) {
+            if (lhs.at<uchar>(lhs_row, lhs_col) == kBlack || rhs.at<uchar>(lhs_row, lhs_col) == kBlack) {
+                result.at<uchar>(lhs_row, lhs_col) = kBlack;
+            }
+            else {
+                result.at<uchar>(lhs_row, lhs_col) = kWhite;
+            }
+        }
+    }
+    return result;
+}
+
+cv::Mat SubstractionOperation(const cv::Mat& lhs, const cv::Mat& rhs) {
+    cv::Mat result{ lhs.rows,lhs.cols, CV_8UC1, cv::Scalar(kWhite) };
+    for (int lhs_row = kBlack; lhs_row < lhs.rows; lhs_row += 1) {
+        for (int lhs_col = kBlack; lhs_col < lhs.cols; lhs_col += 1) {
+            if (lhs.at<uchar>(lhs_row, lhs_col) == kBlack && rhs.at<uchar>(lhs_row, lhs_col) == kBlack) {
+                result.at<uchar>(lhs_row, lhs_col) = kWhite;
+            }
+            else {
+                if (lhs.at<uchar>(lhs_row, lhs_col) == kBlack && rhs.at<uchar>(lhs_row, lhs_col) != kBlack) {
+                    result.at<uchar>(lhs_row, lhs_col) = kBlack;
+                }
+                else {
+                    result.at<uchar>(lhs_row, lhs_col) = kWhite;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+// Случайное изображение: в основном 0 и 255, но встречаются и произвольные значения
+cv::Mat RandomImage(std::mt19937& rng, int rows, int cols) {
+    std::uniform_int_distribution<int> kind(0, 9);
+    std::uniform_int_distribution<int> value(0, 255);
+    cv::Mat image{ rows, cols, CV_8UC1 };
+    for (int row = 0; row < rows; row += 1) {
+        for (int col = 0; col < cols; col += 1) {
+            const int pixel_kind = kind(rng);
+            image.at<uchar>(row, col) = pixel_kind < 4 ? kBlack : (pixel_kind < 8 ? kWhite : value(rng));
+        }
+    }
+    return image;
+}
+
+int main() {
+    std::mt19937 rng(20231017);
+    int failures = 0;
+
+    const SetOperations::Isa isas[] = { SetOperations::Isa::kScalar, SetOperations::Isa::kSse2,
+        SetOperations::Isa::kAvx2, SetOperations::Isa::kAvx512 };
+    const char* names[] = { "scalar", "sse2", "avx2", "avx512" };
+
+    for (int test = 0; test < 100; test += 1) {
+        std::uniform_int_distribution<int> size(1, 200);
+        cv::Mat lhs = RandomImage(rng, size(rng), size(rng));
+        cv::Mat rhs = RandomImage(rng, lhs.rows, lhs.cols);
+
+        // каждый третий тест - на несплошных областях изображения
+        if (test % 3 == 0 && lhs.cols > 2) {
+            const cv::Rect roi(1, 0, lhs.cols - 2, lhs.rows);
+            lhs = lhs(roi);
+            rhs = rhs(roi);
+        }
+
+        const cv::Mat expected_and = AndOperation(lhs, rhs);
+        const cv::Mat expected_or = OrOperation(lhs, rhs);
+        const cv::Mat expected_substraction = SubstractionOperation(lhs, rhs);
+
+        for (int isa = 0; isa < 4; isa += 1) {
+            if (!SetOperations::IsSupported(isas[isa])) {
+                continue;
+            }
+            cv::Mat result;
+            SetOperations::And(lhs, rhs, result, isas[isa]);
+            if (!Equal(expected_and, result)) {
+                std::cout << "And mismatch (" << names[isa] << "), test " << test << std::endl;
+                failures += 1;
+            }
+            SetOperations::Or(lhs, rhs, result, isas[isa]);
+            if (!Equal(expected_or, result)) {
+                std::cout << "Or mismatch (" << names[isa] << "), test " << test << std::endl;
+                failures += 1;
+            }
+            SetOperations::Substraction(lhs, rhs, result, isas[isa]);
+            if (!Equal(expected_substraction, result)) {
+                std::cout << "Substraction mismatch (" << names[isa] << "), test " << test << std::endl;
+                failures += 1;
+            }
+        }
+    }
+
+    for (int isa = 0; isa < 4; isa += 1) {
+        std::cout << names[isa] << (SetOperations::IsSupported(isas[isa]) ? ": checked" : ": not supported") << std::endl;
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
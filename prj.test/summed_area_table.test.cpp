@@ -0,0 +1,127 @@
+#include<hitOrMiss/hit_or_miss.hpp>
+#include<hitOrMiss/summed_area_table.hpp>
+#include "test_utils.hpp"
+
+#include <iostream>
+#include <random>
+
+// Окно size цвета 255 - color с рамкой цвета color толщины thickness
+cv::Mat FrameKernel(const cv::Size& size, int thickness, int color) {
+    cv::Mat kernel{ size, CV_8UC1, cv::Scalar(color) };
+    for (int row = thickness; row < size.height - thickness; row += 1) {
+        for (int col = thickness; col < size.width - thickness; col += 1) {
+            kernel.at<uchar>(row, col) = 255 - color;
+        }
+    }
+    return kernel;
+}
+
+// Разложение на прямоугольники дает ровно значимые пиксели элемента
+bool DecompositionCovers(const StructuringElement& element) {
+    cv::Mat coverage{ element.get_size(), CV_32SC1, cv::Scalar(0) };
+    for (const StructuringElement::CareRectangle& care : element.get_rectangles()) {
+        for (int row = care.rect.y; row < care.rect.y + care.rect.height; row += 1) {
+            for (int col = care.rect.x; col < care.rect.x + care.rect.width; col += 1) {
+                coverage.at<int>(row, col) += care.black ? care.sign : 100 * care.sign;
+            }
+        }
+    }
+    for (const CarePixel& pixel : element.get_care()) {
+        coverage.at<int>(pixel.row, pixel.col) -= pixel.black ? 1 : 100;
+    }
+    for (int row = 0; row < coverage.rows; row += 1) {
+        for (int col = 0; col < coverage.cols; col += 1) {
+            if (coverage.at<int>(row, col) != 0) return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::mt19937 rng(20231017);
+    int failures = 0;
+    int checked = 0;
+
+    for (int test = 0; test < 300; test += 1) {
+        std::uniform_int_distribution<int> window_size(1, 25);
+        const cv::Size window(window_size(rng), window_size(rng));
+
+        // рамки переднего и заднего плана, блок с рамкой в общем окне и случайные элементы
+        StructuringElement element;
+        const int shape = test % 4;
+        if (shape == 0) {
+            element = StructuringElement(FrameKernel(window, 1 + test % 3, 0), true);
+        }
+        else if (shape == 1) {
+            element = StructuringElement(FrameKernel(window, 1, 255), false);
+        }
+        else if (shape == 2) {
+            const StructuringElement block(cv::Mat{ window, CV_8UC1, cv::Scalar(0) }, true);
+            const cv::Size outer(window.width + 2, window.height + 2);
+            const StructuringElement frame(FrameKernel(outer, 1, 255), false);
+            element = StructuringElement::Combine(block, cv::Point(1, 1), frame, cv::Point(0, 0), outer);
+        }
+        else {
+            element = StructuringElement(RandomBinary(rng, window.height, window.width, 0.7), true);
+        }
+
+        if (!DecompositionCovers(element)) {
+            std::cout << "Decomposition mismatch, test " << test << std::endl;
+            failures += 1;
+        }
+        if (!SummedAreaTable::Supports(element)) {
+            continue;
+        }
+
+        std::uniform_int_distribution<int> image_size(1, 120);
+        const cv::Mat image = RandomBinary(rng, image_size(rng), image_size(rng), shape == 1 ? 0.02 : 0.9);
+        const int last_row = image.rows - element.get_size().height;
+        const int last_col = image.cols - element.get_size().width;
+        if (last_row < 0 || last_col < 0) {
+            continue;
+        }
+
+        cv::Mat expected{ last_row + 1, last_col + 1, CV_8UC1 };
+        for (int row = 0; row <= last_row; row += 1) {
+            for (int col = 0; col <= last_col; col += 1) {
+                expected.at<uchar>(row, col) = element.Match(image, row, col);
+            }
+        }
+
+        const SummedAreaTable sums(image);
+        cv::Mat hits{ expected.size(), CV_8UC1, cv::Scalar(7) };
+        for (int row = 0; row <= last_row; row += 6) {
+            sums.Match(element, row, row + 6, hits);
+        }
+        if (!Equal(expected, hits)) {
+            std::cout << "Hits mismatch, test " << test << std::endl;
+            failures += 1;
+        }
+        checked += 1;
+    }
+
+    // блок 19*19 в белой рамке 21*21, как в tests/test_9: движки совпадают
+    const cv::Mat image = RandomBinary(rng, 400, 400, 0.98);
+    cv::Mat block{ 21, 21, CV_8UC1, cv::Scalar(255) };
+    for (int row = 1; row < 20; row += 1) {
+        for (int col = 1; col < 20; col += 1) {
+            block.at<uchar>(row, col) = 0;
+        }
+    }
+    HitOrMiss hit_or_miss(image, block, FrameKernel(cv::Size(21, 21), 1, 255));
+    hit_or_miss.set_engine(HitOrMiss::Engine::kBytewise);
+    const cv::Mat bytewise = hit_or_miss.DoBoundaryExtraction();
+    hit_or_miss.set_engine(HitOrMiss::Engine::kBitPlane);
+    if (!Equal(bytewise, hit_or_miss.DoBoundaryExtraction())) {
+        std::cout << "Engines mismatch on a block in a frame" << std::endl;
+        failures += 1;
+    }
+
+    std::cout << checked << " elements checked" << std::endl;
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,42 @@
+﻿/**
+* @file test_utils.hpp
+* @brief Общие вспомогательные функции тестов
+*
+* @author Kiselev K.A.
+* @date 18.10.2026
+*/
+
+#pragma once
+#ifndef HITORMISS_TEST_UTILS_HPP_20261018
+#define HITORMISS_TEST_UTILS_HPP_20261018
+
+#include <cstring>
+#include <random>
+#include <opencv2/opencv.hpp>
+
+// Случайное бинарное изображение с заданной долей черных пикселей
+inline cv::Mat RandomBinary(std::mt19937& rng, int rows, int cols, double black_ratio) {
+    std::bernoulli_distribution black(black_ratio);
+    cv::Mat image{ rows, cols, CV_8UC1 };
+    for (int row = 0; row < rows; row += 1) {
+        for (int col = 0; col < cols; col += 1) {
+            image.at<uchar>(row, col) = black(rng) ? 0 : 255;
+        }
+    }
+    return image;
+}
+
+// Изображения совпадают по размеру, типу и всем пикселям
+inline bool Equal(const cv::Mat& lhs, const cv::Mat& rhs) {
+    if (lhs.size() != rhs.size() || lhs.type() != rhs.type()) {
+        return false;
+    }
+    for (int row = 0; row < lhs.rows; row += 1) {
+        if (std::memcmp(lhs.ptr<uchar>(row), rhs.ptr<uchar>(row), lhs.cols * lhs.elemSize()) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif
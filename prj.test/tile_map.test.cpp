@@ -0,0 +1,146 @@
+#include<hitOrMiss/hit_or_miss.hpp>
+#include<hitOrMiss/tile_map.hpp>
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+// Почти белая страница: строки "текста" из черных пятен и несколько черных плашек
+cv::Mat RandomPage(std::mt19937& rng, int rows, int cols) {
+    cv::Mat image{ rows, cols, CV_8UC1, cv::Scalar(255) };
+    std::uniform_int_distribution<int> count(1, 12);
+    std::uniform_int_distribution<int> side(1, 40);
+    std::bernoulli_distribution black(0.5);
+    const int blocks = count(rng);
+    for (int block = 0; block < blocks; block += 1) {
+        const int height = std::min(rows, side(rng) * 2);
+        const int width = std::min(cols, side(rng) * 3);
+        const int top = std::uniform_int_distribution<int>(0, rows - height)(rng);
+        const int left = std::uniform_int_distribution<int>(0, cols - width)(rng);
+        const bool solid = block % 4 == 0;
+        for (int row = top; row < top + height; row += 1) {
+            for (int col = left; col < left + width; col += 1) {
+                if (solid || black(rng)) image.at<uchar>(row, col) = 0;
+            }
+        }
+    }
+    return image;
+}
+
+// Состояние области, подсчитанное по пикселям тайлов, которые она задевает
+TileMap::Tile ReferenceRegion(const cv::Mat& image, const cv::Rect& pixels) {
+    const int size = TileMap::kTileSize;
+    const int top = pixels.y / size * size;
+    const int left = pixels.x / size * size;
+    const int bottom = std::min(image.rows, ((pixels.y + pixels.height - 1) / size + 1) * size);
+    const int right = std::min(image.cols, ((pixels.x + pixels.width - 1) / size + 1) * size);
+    int black = 0;
+    for (int row = top; row < bottom; row += 1) {
+        for (int col = left; col < right; col += 1) {
+            black += image.at<uchar>(row, col) == 0;
+        }
+    }
+    if (black == 0) return TileMap::Tile::kWhite;
+    if (black == (bottom - top) * (right - left)) return TileMap::Tile::kBlack;
+    return TileMap::Tile::kMixed;
+}
+
+// Время одного вызова DoHitOrMiss в миллисекундах (лучшее из нескольких)
+double Measure(const HitOrMiss& hit_or_miss) {
+    double best = 0;
+    for (int run = 0; run < 3; run += 1) {
+        const int64 start = cv::getTickCount();
+        hit_or_miss.DoHitOrMiss();
+        const double elapsed = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+        best = run == 0 ? elapsed : std::min(best, elapsed);
+    }
+    return best;
+}
+
+int main() {
+    std::mt19937 rng(20231017);
+    int failures = 0;
+
+    // состояния тайлов и областей
+    for (int test = 0; test < 60; test += 1) {
+        std::uniform_int_distribution<int> size(1, 200);
+        const cv::Mat image = RandomPage(rng, size(rng), size(rng));
+        const TileMap tiles(BitPlane::Pack(image));
+        for (int attempt = 0; attempt < 50; attempt += 1) {
+            const int top = std::uniform_int_distribution<int>(0, image.rows - 1)(rng);
+            const int left = std::uniform_int_distribution<int>(0, image.cols - 1)(rng);
+            const int height = std::uniform_int_distribution<int>(1, image.rows - top)(rng);
+            const int width = std::uniform_int_distribution<int>(1, image.cols - left)(rng);
+            const cv::Rect region(left, top, width, height);
+            if (tiles.Region(region) != ReferenceRegion(image, region)) {
+                std::cout << "Region mismatch, test " << test << std::endl;
+                failures += 1;
+            }
+        }
+    }
+
+    // пропуск однородных тайлов не меняет результат ни одного движка
+    const HitOrMiss::Engine engines[] = { HitOrMiss::Engine::kBytewise, HitOrMiss::Engine::kBitPlane };
+    for (int test = 0; test < 80; test += 1) {
+        std::uniform_int_distribution<int> image_size(1, 260);
+        std::uniform_int_distribution<int> kernel_size(1, 9);
+        const int kernel_rows = kernel_size(rng);
+        const int kernel_cols = kernel_size(rng);
+
+        HitOrMiss hit_or_miss(RandomPage(rng, image_size(rng), image_size(rng)));
+        // белые элементы переднего плана совпадают в любой белой области
+        hit_or_miss.set_kernel_foreground(RandomBinary(rng, kernel_rows, kernel_cols, test % 5 == 0 ? 0.0 : 0.5));
+        if (test % 3 == 0) {
+            hit_or_miss.set_kernel_background(RandomBinary(rng, kernel_rows, kernel_cols, test % 2 == 0 ? 1.0 : 0.6));
+        }
+        if (test % 2 == 1) {
+            hit_or_miss.set_hit_highlight(RandomBinary(rng, kernel_rows, kernel_cols, 0.5));
+        }
+
+        // серии черных пикселей не используют карту тайлов
+        hit_or_miss.set_engine(HitOrMiss::Engine::kRunLength);
+        const cv::Mat expected_hit_or_miss = hit_or_miss.DoHitOrMiss();
+        const cv::Mat expected_boundary = hit_or_miss.DoBoundaryExtraction();
+        for (HitOrMiss::Engine engine : engines) {
+            hit_or_miss.set_engine(engine);
+            for (int thread_count : { 1, 3 }) {
+                hit_or_miss.set_thread_count(thread_count);
+                if (!Equal(expected_hit_or_miss, hit_or_miss.DoHitOrMiss())) {
+                    std::cout << "HitOrMiss mismatch, test " << test << std::endl;
+                    failures += 1;
+                }
+                if (!Equal(expected_boundary, hit_or_miss.DoBoundaryExtraction())) {
+                    std::cout << "BoundaryExtraction mismatch, test " << test << std::endl;
+                    failures += 1;
+                }
+            }
+        }
+    }
+
+    // страница A3 при 300 dpi, почти целиком белая
+    const char* kernels[] = { "3x3 frame", "7x7 cross" };
+    cv::Mat frame{ 3, 3, CV_8UC1, cv::Scalar(0) };
+    frame.at<uchar>(1, 1) = 255;
+    cv::Mat cross{ 7, 7, CV_8UC1, cv::Scalar(255) };
+    for (int step = 0; step < 7; step += 1) {
+        cross.at<uchar>(3, step) = 0;
+        cross.at<uchar>(step, 3) = 0;
+    }
+    HitOrMiss page(RandomPage(rng, 4960, 3508));
+    for (int kernel = 0; kernel < 2; kernel += 1) {
+        page.set_kernel_foreground(kernel == 0 ? frame : cross);
+        for (HitOrMiss::Engine engine : engines) {
+            page.set_engine(engine);
+            std::cout << kernels[kernel] << (engine == HitOrMiss::Engine::kBytewise ? ", bytewise: " : ", bit plane: ")
+                << Measure(page) << " ms" << std::endl;
+        }
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
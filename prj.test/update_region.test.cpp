@@ -0,0 +1,131 @@
+#include<hitOrMiss/hit_or_miss.hpp>
+#include "test_utils.hpp"
+
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+int main() {
+    std::mt19937 rng(20261017);
+    int failures = 0;
+
+    const HitOrMiss::BorderMode modes[] = { HitOrMiss::BorderMode::kNone, HitOrMiss::BorderMode::kWhite,
+        HitOrMiss::BorderMode::kReplicate };
+    const HitOrMiss::Engine engines[] = { HitOrMiss::Engine::kBytewise, HitOrMiss::Engine::kBitPlane,
+        HitOrMiss::Engine::kRunLength };
+
+    // после каждого мазка сохраненные и заново посчитанные результаты совпадают
+    for (int test = 0; test < 18; test += 1) {
+        std::uniform_int_distribution<int> kernel_size(1, test % 4 == 0 ? 7 : 3);
+        const int kernel_rows = kernel_size(rng);
+        const int kernel_cols = kernel_size(rng);
+        const cv::Mat foreground = RandomBinary(rng, kernel_rows, kernel_cols, 0.7);
+        cv::Mat background = RandomBinary(rng, kernel_rows, kernel_cols, 0.8);
+        for (int row = 0; row < kernel_rows; row += 1) {
+            for (int col = 0; col < kernel_cols; col += 1) {
+                if (foreground.at<uchar>(row, col) == 0) background.at<uchar>(row, col) = 0;
+            }
+        }
+        const cv::Mat highlight = test % 2 == 0 ? cv::Mat{ 1, 1, CV_8UC1, cv::Scalar(0) }
+            : RandomBinary(rng, kernel_rows, kernel_cols, 0.3);
+        const HitOrMiss::BorderMode mode = modes[test % 3];
+        const HitOrMiss::Engine engine = engines[test / 3 % 3];
+
+        const cv::Mat image = RandomBinary(rng, 100 + test, 140 - test, 0.05);
+        HitOrMiss incremental(image, foreground, background, highlight);
+        incremental.set_border_mode(mode);
+        incremental.set_engine(engine);
+        incremental.CachedHitOrMiss();
+
+        for (int stroke = 0; stroke < 12; stroke += 1) {
+            std::uniform_int_distribution<int> stroke_size(1, 40);
+            const int width = std::min(stroke_size(rng), image.cols);
+            const int height = std::min(stroke_size(rng), image.rows);
+            const int x = std::uniform_int_distribution<int>(0, image.cols - width)(rng);
+            const int y = std::uniform_int_distribution<int>(0, image.rows - height)(rng);
+            // мазки сплошные (делают тайлы однородными) и случайные
+            const cv::Mat patch = stroke % 3 == 0 ? cv::Mat{ height, width, CV_8UC1, cv::Scalar(stroke % 2 ? 0 : 255) }
+                : RandomBinary(rng, height, width, 0.6);
+            const cv::Rect changed = incremental.UpdateRegion(cv::Rect(x, y, width, height), patch);
+
+            HitOrMiss reference(incremental.get_image().clone(), foreground, background, highlight);
+            reference.set_border_mode(mode);
+            reference.set_engine(HitOrMiss::Engine::kBytewise);
+            const cv::Mat expected = reference.DoHitOrMiss();
+            if (!Equal(incremental.CachedHitOrMiss(), expected)
+                || !Equal(incremental.CachedForeground(), reference.CachedForeground())
+                || !Equal(incremental.CachedBackground(), reference.CachedBackground())
+                || !Equal(incremental.DoHitOrMiss(), expected)
+                || !Equal(incremental.DoBoundaryExtraction(), reference.DoBoundaryExtraction())) {
+                std::cout << "Incremental mismatch: test " << test << ", stroke " << stroke << std::endl;
+                failures += 1;
+            }
+            if (!Equal(incremental.get_image()(cv::Rect(x, y, width, height)), patch) || !changed.contains(cv::Point(x, y))) {
+                std::cout << "Patch mismatch: test " << test << ", stroke " << stroke << std::endl;
+                failures += 1;
+            }
+        }
+    }
+
+    // интегральное изображение (элемент-рамка) сбрасывается мазком
+    // и перестраивается полным проходом без сохраненных результатов
+    cv::Mat frame{ 12, 12, CV_8UC1, cv::Scalar(0) };
+    frame(cv::Rect(1, 1, 10, 10)).setTo(255);
+    HitOrMiss summed(RandomBinary(rng, 90, 90, 0.02), frame);
+    summed.set_engine(HitOrMiss::Engine::kBytewise);
+    summed.DoHitOrMiss();
+    for (int stroke = 0; stroke < 6; stroke += 1) {
+        const int corner = 10 * stroke;
+        summed.UpdateRegion(cv::Rect(corner, corner, 30, 30), cv::Mat{ 30, 30, CV_8UC1, cv::Scalar(stroke % 2 ? 255 : 0) });
+        HitOrMiss reference(summed.get_image().clone(), frame);
+        reference.set_engine(HitOrMiss::Engine::kBytewise);
+        if (!Equal(summed.DoHitOrMiss(), reference.DoHitOrMiss())) {
+            std::cout << "Stale summed area table after stroke " << stroke << std::endl;
+            failures += 1;
+        }
+    }
+
+    // данные вызывающего кода и копии объекта не меняются
+    const cv::Mat source = RandomBinary(rng, 64, 64, 0.5);
+    const cv::Mat kept = source.clone();
+    const cv::Mat kernel{ 3, 3, CV_8UC1, cv::Scalar(0) };
+    HitOrMiss original(source, kernel);
+    original.set_image(BinaryImage::FromBinary(source));
+    original.UpdateRegion(cv::Rect(40, 40, 4, 4), cv::Mat{ 4, 4, CV_8UC1, cv::Scalar(0) });
+    // после первого изменения изображение принадлежит объекту, копия снова делает его общим
+    HitOrMiss copy(original);
+    original.UpdateRegion(cv::Rect(10, 10, 20, 20), cv::Mat{ 20, 20, CV_8UC1, cv::Scalar(0) });
+    copy.UpdateRegion(cv::Rect(0, 0, 5, 5), cv::Mat{ 5, 5, CV_8UC1, cv::Scalar(255) });
+    HitOrMiss copy_reference(copy.get_image().clone(), kernel);
+    if (!Equal(source, kept) || !Equal(copy.DoHitOrMiss(), copy_reference.DoHitOrMiss())
+        || !Equal(copy.get_image()(cv::Rect(10, 10, 20, 20)), kept(cv::Rect(10, 10, 20, 20)))) {
+        std::cout << "UpdateRegion wrote into shared data" << std::endl;
+        failures += 1;
+    }
+
+    // прямоугольник вне изображения и несовпадающий размер
+    int rejected = 0;
+    try {
+        original.UpdateRegion(cv::Rect(60, 60, 10, 10), cv::Mat{ 10, 10, CV_8UC1, cv::Scalar(0) });
+    }
+    catch (const std::invalid_argument&) {
+        rejected += 1;
+    }
+    try {
+        original.UpdateRegion(cv::Rect(0, 0, 10, 10), cv::Mat{ 9, 10, CV_8UC1, cv::Scalar(0) });
+    }
+    catch (const std::invalid_argument&) {
+        rejected += 1;
+    }
+    if (rejected != 2) {
+        std::cout << "Invalid update accepted" << std::endl;
+        failures += 1;
+    }
+
+    if (failures != 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}